@@ -79,6 +79,7 @@ namespace Kiaro
             typedef irr::u64 U64;
 
             typedef irr::core::vector3df Vector3DF;
+            typedef irr::core::quaternion Quaternion;
             typedef irr::video::SColor ColorRGBA;
         #endif
 
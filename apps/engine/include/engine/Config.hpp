@@ -20,6 +20,75 @@
     #define MAXIMUM_COMMANDLINE_ARGUMENTS 20
     #define MAXIMUM_ARBITRARY_STRING_LENGTH 256
 
+    // Bounds and precision that entity positions are quantized to when sent over the network
+    #define NETWORK_POSITION_MINIMUM -4096.0f
+    #define NETWORK_POSITION_MAXIMUM 4096.0f
+    #define NETWORK_POSITION_PRECISION 0.03125f
+
+    // The number of clients a server has slots for unless told otherwise
+    #define NETWORK_MAXIMUM_CLIENTS 32
+
+    // The number of packet type IDs a PacketRegistry has room for
+    #define NETWORK_MAXIMUM_PACKET_TYPES 64
+    // The size that messages are coalesced into ENet packets up to. This stays under ENet's default MTU of 1400
+    // once ENet's own headers are added, so that coalesced packets don't fragment.
+    #define NETWORK_MESSAGE_BUFFER_SIZE 1200
+
+    // How many snapshots are remembered per connection, and how old an acknowledged snapshot may get before
+    // full entity state is sent again instead of a delta against it. The age must stay below the history length.
+    #define NETWORK_SNAPSHOT_HISTORY_LENGTH 32
+    #define NETWORK_SNAPSHOT_MAXIMUM_BASELINE_AGE 16
+    // The largest number of bytes a single entity's packUpdate may write
+    #define NETWORK_MAXIMUM_ENTITY_STATE_SIZE 255
+
+    // Entities within this distance of a client's viewpoint are replicated to it, and they keep being replicated
+    // until they are the hysteresis distance further out than that
+    #define NETWORK_RELEVANCE_RADIUS 512.0f
+    #define NETWORK_RELEVANCE_HYSTERESIS 64.0f
+
+    // The default number of bytes each client's snapshot may take up. Keeping this under the MTU means snapshots
+    // never fragment; entity updates that don't fit are deferred to later snapshots by priority.
+    #define NETWORK_SNAPSHOT_BUDGET 1024
+    // An entity's priority is halved at this distance from the viewpoint, and doubled at this speed
+    #define NETWORK_PRIORITY_DISTANCE_SCALE 64.0f
+    #define NETWORK_PRIORITY_VELOCITY_SCALE 8.0f
+
+    // ENet host bandwidth limits in bytes per second; 0 leaves it to ENet to work out
+    #define NETWORK_SERVER_INCOMING_BANDWIDTH 0
+    #define NETWORK_SERVER_OUTGOING_BANDWIDTH 0
+    #define NETWORK_CLIENT_INCOMING_BANDWIDTH 0
+    #define NETWORK_CLIENT_OUTGOING_BANDWIDTH 0
+
+    // How many events and outgoing packets may be queued between the simulation and the network thread, which
+    // must be a power of two, and how long in milliseconds the network thread waits on ENet at a time
+    #define NETWORK_THREAD_QUEUE_LENGTH 1024
+    #define NETWORK_THREAD_SERVICE_TIMEOUT 1
+
+    // How long in milliseconds a client waits on each attempt to connect, how many attempts it makes, and how long it
+    // waits for a graceful disconnect to be acknowledged before dropping the connection
+    #define NETWORK_CONNECT_TIMEOUT 5000
+    #define NETWORK_CONNECT_ATTEMPTS 3
+    #define NETWORK_DISCONNECT_TIMEOUT 3000
+
+    // How far in milliseconds behind the server's clock replicated entities are drawn, so that there is usually a later
+    // snapshot to interpolate towards; how long they may be extrapolated for when there isn't; and how many snapshots
+    // each entity keeps
+    #define NETWORK_INTERPOLATION_DELAY 100
+    #define NETWORK_EXTRAPOLATION_LIMIT 100
+    #define NETWORK_INTERPOLATION_BUFFER_LENGTH 16
+
+    // How many of the latest input commands go in every Input packet, and how many unacknowledged commands a client
+    // keeps around to replay over the server's state
+    #define NETWORK_INPUT_REDUNDANCY 4
+    #define NETWORK_INPUT_HISTORY_LENGTH 64
+
+    // How often in seconds a dedicated server writes out the network statistics of every client when asked to without
+    // giving an interval
+    #define NETWORK_STATISTICS_INTERVAL 10
+
+    // The asset manifest the server seeds its string table from, listing one asset path per line
+    #define NETWORK_STRING_TABLE_MANIFEST "assets.manifest"
+
     #ifndef CMAKE_CONFIG
         #define MAXIMUM_DELTATIME
         #define ENGINE_TESTS 1
@@ -29,7 +29,7 @@ namespace Kiaro
 
     namespace Game
     {
-        class OutgoingClient;
+        class OutgoingClientSingleton;
         class ServerSingleton;
     }
 
@@ -51,6 +51,21 @@ namespace Kiaro
                 void setMode(const ENGINE_MODE mode);
                 void setTargetServer(Kiaro::Common::C8 *address, Kiaro::Common::U16 port);
                 void setGame(const std::string &gameName);
+                //! Sets whether or not the client or server services the network on a thread of its own.
+                void setNetworkThreaded(const bool &networkThreaded);
+
+                /**
+                 *  @brief Sets how often a dedicated server writes out the network statistics of every client.
+                 *  @param interval The interval in seconds, or 0 to never write them.
+                 *  @param fileName The file to append them to, or an empty string to write them to the log.
+                 */
+                void setStatisticsOutput(const Kiaro::Common::U32 &interval, const std::string &fileName);
+
+                /**
+                 *  @brief Sets the demo file that every packet the client or the server receives is recorded to.
+                 *  @param fileName The path of the demo file, or an empty string to record nothing.
+                 */
+                void setDemoRecording(const std::string &fileName);
 
                 irr::IrrlichtDevice *getIrrlichtDevice(void);
 
@@ -77,8 +92,14 @@ namespace Kiaro
 
                 Kiaro::Common::C8 *mTargetServerAddress;
                 Kiaro::Common::U16 mTargetServerPort;
-                Kiaro::Network::OutgoingClientBase *mClient;
+                Kiaro::Game::OutgoingClientSingleton *mClient;
                 Kiaro::Network::ServerBase *mServer;
+                bool mNetworkThreaded;
+
+                Kiaro::Common::U32 mStatisticsInterval;
+                std::string mStatisticsFileName;
+
+                std::string mDemoFileName;
 
                 std::string mGameName;
         };
@@ -32,12 +32,19 @@ namespace Kiaro
 
                 bool OnEvent(const irr::SEvent& event);
 
+                //! Returns whether or not the given key is currently held down.
+                bool isKeyDown(const irr::EKEY_CODE &key) { return mKeyStates[key]; }
+
             // Private Methods
             private:
                 //! Standard constructor.
                 InputListenerSingleton(void);
                 //! Standard destructor.
                 ~InputListenerSingleton(void);
+
+            // Private Members
+            private:
+                bool mKeyStates[irr::KEY_KEY_CODES_COUNT];
         };
     } // End Namespace Game
 } // End Namespace Kiaro
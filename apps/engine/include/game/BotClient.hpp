@@ -0,0 +1,118 @@
+/**
+ *  @file BotClient.hpp
+ *  @brief Include file defining the Kiaro::Game::BotClient class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_GAME_BOTCLIENT_HPP_
+#define _INCLUDE_GAME_BOTCLIENT_HPP_
+
+#include <vector>
+#include <deque>
+
+#include <network/OutgoingClientBase.hpp>
+#include <network/PacketRegistry.hpp>
+
+#include <game/InputCommand.hpp>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            class HandShake;
+            class Snapshot;
+            class Ping;
+            class ControlEntity;
+            class StringTableUpdate;
+        }
+
+        /**
+         *  @brief A headless client that puts load on a server. It performs the handshake, acknowledges every snapshot
+         *  without applying it, and at a fixed rate walks its player around a square and sends a ping, timing how long
+         *  each one takes to come back.
+         */
+        class BotClient : public Kiaro::Network::OutgoingClientBase
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting how often to send input.
+                 *  @param inputInterval The time between inputs in microseconds.
+                 *  @param firstInputTime The time in microseconds at which to send the first input, so that bots can be staggered.
+                 */
+                BotClient(const Kiaro::Common::U64 &inputInterval, const Kiaro::Common::U64 &firstInputTime);
+
+                //! Standard destructor.
+                ~BotClient(void);
+
+                /**
+                 *  @brief Handles everything received from the server and then queues any input that is due.
+                 *  @param currentTime The current time in microseconds. Pings are timed by this clock.
+                 */
+                void update(const Kiaro::Common::U64 &currentTime);
+
+                void onReceivePacket(Kiaro::Support::BitStream &incomingStream);
+
+                void onConnected(void);
+                void onDisconnected(void);
+                void onConnectFailed(void);
+
+                //! Returns whether or not the server has answered the handshake.
+                bool isReady(void) { return mCurrentStage >= 1; }
+
+                //! Returns the number of bytes received from the server.
+                Kiaro::Common::U64 getBytesReceived(void) { return mStatistics.getTotals().mBytesReceived; }
+                //! Returns the number of bytes handed to the transport for the server.
+                Kiaro::Common::U64 getBytesSent(void) { return mStatistics.getTotals().mBytesSent; }
+
+                //! Returns the number of pings that were sent.
+                Kiaro::Common::U32 getPingsSent(void) { return mPingsSent; }
+                //! Returns the round trip time in microseconds of every ping that came back.
+                const std::vector<Kiaro::Common::U64> &getRoundTripTimes(void) { return mRoundTripTimes; }
+
+            // Private Methods
+            private:
+                //! Packet handler for Kiaro::Game::Packets::HandShake.
+                void onHandShake(Kiaro::Game::Packets::HandShake &packet);
+                //! Packet handler for Kiaro::Game::Packets::Snapshot.
+                void onSnapshot(Kiaro::Game::Packets::Snapshot &packet);
+                //! Packet handler for Kiaro::Game::Packets::Ping.
+                void onPing(Kiaro::Game::Packets::Ping &packet);
+                //! Packet handler for Kiaro::Game::Packets::ControlEntity. Bots don't predict, so there's nothing to do.
+                void onControlEntity(Kiaro::Game::Packets::ControlEntity &packet) { }
+                //! Packet handler for Kiaro::Game::Packets::StringTableUpdate. Bots never load assets, so the strings go unused.
+                void onStringTableUpdate(Kiaro::Game::Packets::StringTableUpdate &packet) { }
+
+                //! Queues the next scripted input command, along with the last few as a real client would.
+                void sendInput(void);
+
+            // Private Members
+            private:
+                Kiaro::Network::PacketRegistry mPacketRegistry;
+
+                const Kiaro::Common::U64 mInputInterval;
+                Kiaro::Common::U64 mNextInputTime;
+                //! The time passed to the current update, for timing pings.
+                Kiaro::Common::U64 mCurrentTime;
+
+                Kiaro::Common::U32 mPingsSent;
+                std::vector<Kiaro::Common::U64> mRoundTripTimes;
+
+                Kiaro::Common::U32 mInputSequence;
+                //! The last few input commands sent, oldest first.
+                std::deque<Kiaro::Game::InputCommand> mRecentInputs;
+        };
+    } // End Namespace Game
+} // End Namespace Kiaro
+#endif // _INCLUDE_GAME_BOTCLIENT_HPP_
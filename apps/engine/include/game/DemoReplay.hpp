@@ -0,0 +1,79 @@
+/**
+ *  @file DemoReplay.hpp
+ *  @brief Include file defining the Kiaro::Game::DemoReplay class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_GAME_DEMOREPLAY_HPP_
+#define _INCLUDE_GAME_DEMOREPLAY_HPP_
+
+#include <string>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        class DemoPlayer;
+        class LoopbackNetwork;
+    }
+
+    namespace Game
+    {
+        class ServerSingleton;
+
+        /**
+         *  @brief Feeds a demo recorded by a server or a client back through the packet handlers, without any sockets,
+         *  and reports how long it took.
+         *  @details A server demo is played into a Kiaro::Game::ServerSingleton on a Kiaro::Network::LoopbackNetwork
+         *  that nobody else is on, which ticks every 32 milliseconds of demo time just like a dedicated server. A client
+         *  demo is played into the Kiaro::Game::OutgoingClientSingleton while it isn't connected. Either way, the replay
+         *  can run as fast as the handlers allow, which makes it a repeatable benchmark for them, or in real time.
+         */
+        class DemoReplay
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor that opens the demo.
+                 *  @param fileName The path of the demo file.
+                 *  @param realTime A boolean representing whether or not to wait for each packet's time to come around.
+                 *  @throw std::runtime_error Thrown when the demo can't be opened.
+                 */
+                DemoReplay(const std::string &fileName, const bool &realTime);
+
+                //! Standard destructor. Brings down the server if there is one.
+                ~DemoReplay(void);
+
+                /**
+                 *  @brief Replays the whole demo and writes the results to stdout.
+                 *  @return A boolean representing whether or not there was anything to replay.
+                 */
+                bool run(void);
+
+            // Private Methods
+            private:
+                //! Runs a server tick, if replaying into a server, or interpolates the client.
+                void tick(void);
+
+            // Private Members
+            private:
+                const bool mRealTime;
+
+                Kiaro::Network::DemoPlayer *mPlayer;
+
+                //! The network the server is put on, if replaying into one.
+                Kiaro::Network::LoopbackNetwork *mNetwork;
+                Kiaro::Game::ServerSingleton *mServer;
+        };
+    } // End Namespace Game
+} // End Namespace Kiaro
+#endif // _INCLUDE_GAME_DEMOREPLAY_HPP_
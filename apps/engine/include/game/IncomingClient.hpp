@@ -14,6 +14,9 @@
 #ifndef _INCLUDE_GAME_INCOMINGCLIENT_HPP_
 #define _INCLUDE_GAME_INCOMINGCLIENT_HPP_
 
+#include <map>
+#include <set>
+
 #include <network/IncomingClientBase.hpp>
 
 namespace Kiaro
@@ -21,17 +24,26 @@ namespace Kiaro
     namespace Support
     {
         class BitStream;
+        class MapDivision;
     } // End NameSpace Support
 
     namespace Network
     {
         class ServerBase;
         class PacketBase;
+        struct Snapshot;
+        class StringTable;
     } // End NameSpace Network
 
     namespace Game
     {
-        //! The RemoteClient class is merely used to differentiate between a Client instance we created and a connected remote host in code.
+        namespace Entities
+        {
+            class EntityBase;
+            class Player;
+        } // End NameSpace Entities
+
+        //! A remote host connected to the game server, along with the game state that is kept for it.
         class IncomingClient : public Kiaro::Network::IncomingClientBase
         {
             // Public Methods
@@ -44,23 +56,84 @@ namespace Kiaro
 
                 ~IncomingClient(void);
 
+                void reset(ENetPeer *connecting);
+
+                //! Returns the position that this client is viewing the world from.
+                const Kiaro::Common::Vector3DF &getViewpoint(void) { return mViewpoint; }
+
+                void setViewpoint(const Kiaro::Common::Vector3DF &viewpoint) { mViewpoint = viewpoint; }
+
                 /**
-                 *  @brief Empty callback function for the the OnReceivePacket event.
-                 *  @param packet The received packet.
+                 *  @brief Recomputes which entities are relevant to this client from the squares around its viewpoint.
+                 *  @param mapDivision The MapDivision that the entities are sorted into.
+                 *  @details Entities become relevant within NETWORK_RELEVANCE_RADIUS of the viewpoint but only stop being relevant
+                 *  once they are NETWORK_RELEVANCE_HYSTERESIS further out than that, so that entities near the edge don't flap in and out.
                  */
-                void OnReceivePacket(Kiaro::Support::BitStream &incomingStream);
+                void updateRelevance(Kiaro::Support::MapDivision *mapDivision);
+
+                //! Returns whether or not the given entity was relevant as of the last call to updateRelevance.
+                bool isRelevant(Kiaro::Game::Entities::EntityBase *entity) { return mRelevantEntitySet.count(entity) != 0; }
+
+                const std::set<Kiaro::Game::Entities::EntityBase *> &getRelevantEntities(void) { return mRelevantEntitySet; }
 
-                void Send(Kiaro::Network::PacketBase *packet, const bool &reliable);
+                /**
+                 *  @brief Picks the relevant entities that go into this client's next snapshot.
+                 *  @param current The full state of every dynamic entity this tick.
+                 *  @param baseline The snapshot the result is going to be diffed against, or NULL.
+                 *  @param stateStream Scratch stream that entities which only send some of their properties are serialized into.
+                 *  @param out The snapshot to fill in.
+                 *  @details Every relevant entity accumulates priority each tick, scaled by its own network priority, its speed and
+                 *  its closeness to the viewpoint. Changed entities are then added highest priority first until the snapshot budget
+                 *  runs out, which resets their priority. Entities that don't fit keep their baseline state so that the client doesn't
+                 *  destroy them, and keep accumulating priority until they make it in. The client's own player always goes first,
+                 *  since the client needs it to correct its predictions.
+                 *
+                 *  An entity the client has in its baseline only sends the properties that changed since the state the client
+                 *  acknowledged for it, so once every change is acknowledged it costs nothing beyond its entry header.
+                 */
+                void buildSnapshot(const Kiaro::Network::Snapshot &current, const Kiaro::Network::Snapshot *baseline, Kiaro::Support::BitStream &stateStream,
+                                   Kiaro::Network::Snapshot &out);
 
-                bool GetIsOppositeEndian(void) { return mIsOppositeEndian; }
+                //! Returns the number of bytes this client's snapshots may take up.
+                Kiaro::Common::U32 getSnapshotBudget(void) { return mSnapshotBudget; }
 
-                void Disconnect(void);
+                void setSnapshotBudget(const Kiaro::Common::U32 &budget) { mSnapshotBudget = budget; }
 
-                Kiaro::Common::U16 GetPort(void);
+                //! Returns the player entity this client's input commands move, or NULL.
+                Kiaro::Game::Entities::Player *getPlayer(void) { return mPlayer; }
 
+                void setPlayer(Kiaro::Game::Entities::Player *player) { mPlayer = player; }
+
+                //! Returns the sequence number of the last input command applied to this client's player.
+                Kiaro::Common::U32 getInputSequence(void) { return mInputSequence; }
+
+                void setInputSequence(const Kiaro::Common::U32 &sequence) { mInputSequence = sequence; }
+
+                /**
+                 *  @brief Sends whichever strings of the server's table this client hasn't been sent yet, reliably and in
+                 *  order. Anything that refers to them has to be sent after this.
+                 *  @param strings The server's string table.
+                 */
+                void sendStrings(const Kiaro::Network::StringTable &strings);
+
+            // Private Members
             private:
-                bool mIsOppositeEndian;
-                ENetPeer *mInternalClient;
+                Kiaro::Common::Vector3DF mViewpoint;
+                Kiaro::Common::U32 mSnapshotBudget;
+
+                Kiaro::Game::Entities::Player *mPlayer;
+                Kiaro::Common::U32 mInputSequence;
+                //! The number of the server's strings this client has been sent, which are the ones with lower IDs.
+                size_t mStringCount;
+
+                //! The priority each relevant entity has accumulated since it was last sent.
+                std::map<Kiaro::Game::Entities::EntityBase *, Kiaro::Common::F32> mEntityPriorities;
+                //! Scratch vector the relevant entities are sorted by priority in.
+                std::vector<std::pair<Kiaro::Common::F32, Kiaro::Game::Entities::EntityBase *> > mPrioritizedEntities;
+
+                std::set<Kiaro::Game::Entities::EntityBase *> mRelevantEntitySet;
+                //! Scratch vector the MapDivision query results are collected into.
+                std::vector<Kiaro::Game::Entities::EntityBase *> mRelevanceCandidates;
         };
     } // End Namespace Game
 } // End Namespace Kiaro
@@ -0,0 +1,47 @@
+/**
+ *  @file InputCommand.hpp
+ *  @brief Include file defining the Kiaro::Game::InputCommand structure.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_GAME_INPUTCOMMAND_HPP_
+#define _INCLUDE_GAME_INPUTCOMMAND_HPP_
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        //! An enumeration of the buttons that an InputCommand can hold down.
+        enum INPUT_BUTTON
+        {
+            INPUT_FORWARD = (1 << 0),
+            INPUT_BACKWARD = (1 << 1),
+            INPUT_LEFT = (1 << 2),
+            INPUT_RIGHT = (1 << 3),
+        }; // End Enum INPUT_BUTTON
+
+        /**
+         *  @brief What a player did over one frame. The client applies it to its own player straight away and sends it to
+         *  the server, which applies it to the authoritative player; both have to come out the same.
+         */
+        struct InputCommand
+        {
+            //! The sequence number of this command. Sequence 0 is never used.
+            Kiaro::Common::U32 mSequence;
+            //! The Kiaro::Game::INPUT_BUTTON values that were held down.
+            Kiaro::Common::U8 mButtons;
+            //! How long the buttons were held for in milliseconds.
+            Kiaro::Common::U8 mDuration;
+        };
+    } // End Namespace Game
+} // End Namespace Kiaro
+#endif // _INCLUDE_GAME_INPUTCOMMAND_HPP_
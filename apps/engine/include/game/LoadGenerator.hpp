@@ -0,0 +1,131 @@
+/**
+ *  @file LoadGenerator.hpp
+ *  @brief Include file defining the Kiaro::Game::LoadGenerator class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_GAME_LOADGENERATOR_HPP_
+#define _INCLUDE_GAME_LOADGENERATOR_HPP_
+
+#include <string>
+#include <vector>
+
+#include <network/LoopbackTransport.hpp>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        class BotClient;
+        class ServerSingleton;
+
+        namespace Entities
+        {
+            class EntityBase;
+        }
+
+        //! The settings of a load test run by Kiaro::Game::LoadGenerator.
+        struct LoadSettings
+        {
+            //! Standard constructor. Sets up a minute of 100 bots against a server in this process.
+            LoadSettings(void) : mBotCount(100), mInputRate(30), mDuration(60), mTickMilliseconds(32), mEntityCount(0), mSeed(0),
+            mTargetPort(11595), mNetworkThreaded(false) { }
+
+            Kiaro::Common::U32 mBotCount;
+            //! The number of inputs each bot sends per second.
+            Kiaro::Common::U32 mInputRate;
+            //! The length of the test in seconds.
+            Kiaro::Common::U32 mDuration;
+            Kiaro::Common::U32 mTickMilliseconds;
+
+            //! The number of dynamic entities the server in this process replicates.
+            Kiaro::Common::U32 mEntityCount;
+            //! The seed for the simulated network between the bots and the server in this process.
+            Kiaro::Common::U32 mSeed;
+            //! The conditions of the simulated network between the bots and the server in this process.
+            Kiaro::Network::LinkConditions mConditions;
+
+            //! The address of a server to load instead of one in this process, or an empty string.
+            std::string mTargetAddress;
+            Kiaro::Common::U16 mTargetPort;
+
+            //! Whether or not the server in this process services the network on a thread of its own.
+            bool mNetworkThreaded;
+        };
+
+        /**
+         *  @brief Connects a number of Kiaro::Game::BotClient instances to a server, runs them for a while and reports
+         *  how the server held up: its tick time, the bytes per second to and from each client and the round trip time
+         *  of the bots' input.
+         *  @details Unless a target address is given, the server runs in this process and the bots reach it through a
+         *  Kiaro::Network::LoopbackNetwork. That network keeps simulated time, so ticks run back to back and the server's
+         *  tick time is measured with nothing else competing for it; with a network thread it has to keep wall time
+         *  instead. Against a remote server the bots go through ENet in real time and the tick time isn't known.
+         */
+        class LoadGenerator
+        {
+            // Public Methods
+            public:
+                LoadGenerator(const Kiaro::Game::LoadSettings &settings);
+
+                //! Standard destructor. Disconnects the bots and brings down the server if there is one.
+                ~LoadGenerator(void);
+
+                /**
+                 *  @brief Runs the test and writes the results to stdout.
+                 *  @return A boolean representing whether or not any of the bots managed to connect.
+                 */
+                bool run(void);
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Runs the server and every bot once, then moves the clock on by a tick.
+                 *  @param currentTime The current time in microseconds, by the clock the test is running on.
+                 */
+                void tick(const Kiaro::Common::U64 &currentTime);
+
+                //! Returns the current time in microseconds, by the clock the test is running on.
+                Kiaro::Common::U64 getTime(void);
+
+                /**
+                 *  @brief Writes the results to stdout.
+                 *  @param elapsedTime The length of the test in microseconds.
+                 *  @param bytesReceived The number of message bytes each bot received during the test.
+                 *  @param bytesSent The number of message bytes each bot sent during the test.
+                 */
+                void report(const Kiaro::Common::U64 &elapsedTime, std::vector<Kiaro::Common::U64> &bytesReceived, std::vector<Kiaro::Common::U64> &bytesSent);
+
+                /**
+                 *  @brief Returns the given percentile of a sorted list of values.
+                 *  @param values The values, sorted in ascending order.
+                 *  @param percentile The percentile from 0 to 100.
+                 */
+                static Kiaro::Common::U64 getPercentile(const std::vector<Kiaro::Common::U64> &values, const Kiaro::Common::F32 &percentile);
+
+            // Private Members
+            private:
+                const Kiaro::Game::LoadSettings mSettings;
+
+                //! The network the bots reach an in process server through, if there is one.
+                Kiaro::Network::LoopbackNetwork *mNetwork;
+                Kiaro::Game::ServerSingleton *mServer;
+
+                std::vector<Kiaro::Game::BotClient *> mBots;
+                std::vector<Kiaro::Game::Entities::EntityBase *> mEntities;
+
+                //! The time in microseconds that each server tick took.
+                std::vector<Kiaro::Common::U64> mTickTimes;
+        };
+    } // End Namespace Game
+} // End Namespace Kiaro
+#endif // _INCLUDE_GAME_LOADGENERATOR_HPP_
@@ -14,10 +14,18 @@
 #ifndef _INCLUDE_GAME_OUTGOINGCLIENTSINGLETON_HPP_
 #define _INCLUDE_GAME_OUTGOINGCLIENTSINGLETON_HPP_
 
+#include <map>
+#include <deque>
+
 #include <enet/enet.h>
 
 #include <network/OutgoingClientBase.hpp>
 #include <network/PacketBase.hpp>
+#include <network/PacketRegistry.hpp>
+#include <network/SnapshotHistory.hpp>
+#include <network/StringTable.hpp>
+
+#include <game/InputCommand.hpp>
 
 namespace Kiaro
 {
@@ -34,6 +42,19 @@ namespace Kiaro
 
     namespace Game
     {
+        namespace Packets
+        {
+            class HandShake;
+            class Snapshot;
+            class ControlEntity;
+            class StringTableUpdate;
+        }
+
+        namespace Entities
+        {
+            class EntityBase;
+        }
+
         //! The RemoteClient class is merely used to differentiate between a Client instance we created and a connected remote host in code.
         class OutgoingClientSingleton : public Kiaro::Network::OutgoingClientBase
         {
@@ -51,13 +72,33 @@ namespace Kiaro
 
                 void onConnectFailed(void);
 
-                bool getIsOppositeEndian(void) { return mIsOppositeEndian; }
+                /**
+                 *  @brief Moves every replicated entity to where it was a little while ago on the server, interpolating
+                 *  between the snapshots received around then. This should be called every frame before drawing.
+                 */
+                void interpolate(void);
 
-                void disconnect(void);
+                /**
+                 *  @brief Sets how far behind the server's clock replicated entities are drawn.
+                 *  @param delay The delay in milliseconds. Longer delays ride out more packet loss and jitter at the cost of
+                 *  seeing everything later.
+                 */
+                void setInterpolationDelay(const Kiaro::Common::U32 &delay) { mInterpolationDelay = delay; }
 
-                Kiaro::Common::U16 getPort(void);
+                /**
+                 *  @brief Moves our own player as the given buttons say to straight away and sends the input to the server.
+                 *  This should be called once every frame while connected.
+                 *  @param buttons The Kiaro::Game::INPUT_BUTTON values held down.
+                 *  @param duration How long the buttons were held for in milliseconds.
+                 *  @details The input is kept until a snapshot says the server has applied it. Each snapshot puts our player
+                 *  back where the server had it and the input the server hadn't gotten to yet is applied again on top.
+                 */
+                void sendInput(const Kiaro::Common::U8 &buttons, const Kiaro::Common::U8 &duration);
+
+                //! Returns the strings the server has sent, which anything it sends may refer to by ID.
+                const Kiaro::Network::StringTable &getStringTable(void) { return mStringTable; }
 
-                static OutgoingClientBase *getPointer(void);
+                static OutgoingClientSingleton *getPointer(void);
                 static void destroy(void);
 
             // Private Methods
@@ -70,10 +111,49 @@ namespace Kiaro
 
                 ~OutgoingClientSingleton(void);
 
+                //! Packet handler for Kiaro::Game::Packets::HandShake.
+                void onHandShake(Kiaro::Game::Packets::HandShake &packet);
+                //! Packet handler for Kiaro::Game::Packets::Snapshot.
+                void onSnapshot(Kiaro::Game::Packets::Snapshot &packet);
+                //! Packet handler for Kiaro::Game::Packets::ControlEntity.
+                void onControlEntity(Kiaro::Game::Packets::ControlEntity &packet);
+                //! Packet handler for Kiaro::Game::Packets::StringTableUpdate.
+                void onStringTableUpdate(Kiaro::Game::Packets::StringTableUpdate &packet);
+
+                /**
+                 *  @brief Brings the replicated entities in line with a received snapshot, creating and deleting them as needed.
+                 *  @param snapshot The decoded snapshot.
+                 */
+                void applySnapshot(const Kiaro::Network::Snapshot &snapshot);
+
+                //! Returns the local time in milliseconds that the server's clock is compared against.
+                static Kiaro::Common::U32 getLocalTime(void);
+
             // Private Members
             private:
-                bool mIsOppositeEndian;
                 ENetPeer *mInternalClient;
+
+                //! The table received packets are dispatched through.
+                Kiaro::Network::PacketRegistry mPacketRegistry;
+
+                //! The snapshots received from the server, which later snapshots are diffed against.
+                Kiaro::Network::SnapshotHistory mSnapshotHistory;
+                //! The entities replicated from the server, keyed by network ID.
+                std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *> mReplicatedEntities;
+                //! The strings the server has sent so far.
+                Kiaro::Network::StringTable mStringTable;
+
+                Kiaro::Common::U32 mInterpolationDelay;
+                //! Whether or not a snapshot has been received since connecting, so that mServerTimeOffset means anything.
+                bool mHasServerTime;
+                //! The server's clock minus the local clock, as seen through the quickest recent snapshots.
+                Kiaro::Common::S32 mServerTimeOffset;
+
+                //! The network ID of the entity our input moves, or 0 for none.
+                Kiaro::Common::U32 mControlledNetID;
+                Kiaro::Common::U32 mInputSequence;
+                //! The input sent that the server hasn't acknowledged applying yet, oldest first.
+                std::deque<Kiaro::Game::InputCommand> mPendingInputs;
         };
     } // End Namespace Network
 } // End Namespace Kiaro
@@ -17,6 +17,11 @@
 #include "engine/Common.hpp"
 
 #include <network/ServerBase.hpp>
+#include <network/PacketRegistry.hpp>
+#include <network/StringTable.hpp>
+
+#include <support/BitStream.hpp>
+#include <support/GatherWriter.hpp>
 
 #include <game/entities/Entities.hpp>
 
@@ -29,12 +34,28 @@ namespace Kiaro
             class EntityBase;
         }
 
+        namespace Packets
+        {
+            class HandShake;
+            class SnapshotAck;
+            class Ping;
+            class Input;
+        }
+
         //! Server class that remote hosts connect to.
         class ServerSingleton : public Kiaro::Network::ServerBase
         {
             // Public Methods
             public:
-                static ServerSingleton *getPointer(const std::string &listenAddress = "0.0.0.0", const Kiaro::Common::U16 &listenPort = 11595, const Kiaro::Common::U32 &maximumClientCount = 32);
+                static ServerSingleton *getPointer(const std::string &listenAddress = "0.0.0.0", const Kiaro::Common::U16 &listenPort = 11595, const Kiaro::Common::U32 &maximumClientCount = NETWORK_MAXIMUM_CLIENTS);
+
+                /**
+                 *  @brief Returns the server, creating it on top of the given transport if it doesn't exist yet.
+                 *  @param transport The transport to accept connections through. The server takes ownership of it if it
+                 *  is created; otherwise it is destroyed.
+                 *  @param maximumClientCount The number of clients to make room for if the server is created.
+                 */
+                static ServerSingleton *getPointer(Kiaro::Network::Transport *transport, const Kiaro::Common::U32 &maximumClientCount = NETWORK_MAXIMUM_CLIENTS);
                 static void destroy(void);
 
                 /**
@@ -48,13 +69,9 @@ namespace Kiaro
                  */
                 bool isRunning(void);
 
+                //! Services the network and then sends every handshaken client a snapshot of the dynamic entities.
                 void update(void);
 
-                /**
-                 *  @brief Causes the server to handle all queued network events immediately.
-                 */
-                void dispatch(void);
-
                 //! Callback function that is called upon the server's underlaying network subsystem accepting a remote host connection.
                 void onClientConnected(Kiaro::Network::IncomingClientBase *client);
                 //! Callback function that is called upon the disconnection of a remote host.
@@ -62,6 +79,9 @@ namespace Kiaro
 
                 void onReceivePacket(Kiaro::Support::BitStream &incomingStream, Kiaro::Network::IncomingClientBase *sender);
 
+                //! Creates a Kiaro::Game::IncomingClient for each connecting remote host.
+                Kiaro::Network::IncomingClientBase *createIncomingClient(ENetPeer *connecting);
+
                 Kiaro::Network::IncomingClientBase *getLastPacketSender(void);
 
                 Kiaro::Common::U32 getClientCount(void);
@@ -70,6 +90,20 @@ namespace Kiaro
 
                 void addStaticEntity(Kiaro::Game::Entities::EntityBase *entity);
 
+                /**
+                 *  @brief Adds an entity whose state is replicated to clients through snapshots.
+                 *  @param entity The entity to add. It is assigned a network ID.
+                 */
+                void addDynamicEntity(Kiaro::Game::Entities::EntityBase *entity);
+
+                void removeDynamicEntity(Kiaro::Game::Entities::EntityBase *entity);
+
+                /**
+                 *  @brief Returns the strings that entities refer to by ID when they are sent to clients. Anything added
+                 *  to it reaches every client before its next snapshot.
+                 */
+                Kiaro::Network::StringTable &getStringTable(void) { return mStringTable; }
+
             // Private Methods
             private:
                 /**
@@ -80,6 +114,16 @@ namespace Kiaro
                  */
                 ServerSingleton(const std::string &listenAddress, const Common::U16 &listenPort, const Common::U32 &maximumClientCount);
 
+                /**
+                 *  @brief Constructor that initializes a server instance on top of an existing transport.
+                 *  @param transport The transport to accept connections through.
+                 *  @param maximumClientCount The number of clients to make room for.
+                 */
+                ServerSingleton(Kiaro::Network::Transport *transport, const Kiaro::Common::U32 &maximumClientCount);
+
+                //! Sets up what both constructors have in common.
+                void initialize(void);
+
                 /**
                  *  @brief Standard virtual destructor.
                  *  @note The only reason this destructor is virtual is to prevent compiler warnings when deleting instances that
@@ -87,12 +131,47 @@ namespace Kiaro
                  */
                 ~ServerSingleton(void);
 
+                //! Packet handler for Kiaro::Game::Packets::HandShake.
+                void onHandShake(Kiaro::Game::Packets::HandShake &packet);
+                //! Packet handler for Kiaro::Game::Packets::SnapshotAck.
+                void onSnapshotAck(Kiaro::Game::Packets::SnapshotAck &packet);
+                //! Packet handler for Kiaro::Game::Packets::Ping. The ping is sent straight back.
+                void onPing(Kiaro::Game::Packets::Ping &packet);
+                /**
+                 *  @brief Packet handler for Kiaro::Game::Packets::Input. Commands the sender's player has not had applied yet
+                 *  are applied in order; the rest are repeats sent to cover for packet loss.
+                 */
+                void onInput(Kiaro::Game::Packets::Input &packet);
+
+                /**
+                 *  @brief Serializes every dynamic entity once and sends each handshaken client the difference between
+                 *  the entities relevant to it and the last snapshot it acknowledged.
+                 */
+                void sendSnapshots(void);
+
             // Private Members
             private:
                 Kiaro::Network::IncomingClientBase *mLastPacketSender;
 
+                //! The table received packets are dispatched through.
+                Kiaro::Network::PacketRegistry mPacketRegistry;
+
                 std::set<Kiaro::Game::Entities::EntityBase *> mStaticEntitySet;
                 std::set<Kiaro::Game::Entities::EntityBase *> mDynamicEntitySet;
+
+                //! The network ID that the next added entity will be given.
+                Kiaro::Common::U32 mNextNetID;
+                //! The sequence number of the last snapshot that was sent.
+                Kiaro::Common::U32 mSnapshotSequence;
+                //! Scratch stream that entity state is serialized into when building snapshots.
+                Kiaro::Support::BitStream mEntityStateStream;
+                //! Scratch writer each client's snapshot is composed in, referring to entity state rather than copying it.
+                Kiaro::Support::GatherWriter mSnapshotWriter;
+                //! The strings every client is sent, seeded from the asset manifest and added to as entities are initialized.
+                Kiaro::Network::StringTable mStringTable;
+
+                //! The grid dynamic entities are sorted into to work out which of them are relevant to each client.
+                Kiaro::Support::MapDivision *mMapDivision;
         };
     } // End Namespace Network
 } // End Namespace Kiaro
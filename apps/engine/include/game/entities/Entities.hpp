@@ -18,5 +18,6 @@
 
 #include <game/entities/RigidProp.hpp>
 #include <game/entities/Terrain.hpp>
+#include <game/entities/Player.hpp>
 
 #endif // _INCLUDE_GAME_ENTITIES_ENTITIES_HPP_
@@ -15,6 +15,7 @@
 #define _INCLUDE_KIARO_GAME_ENTITIES_ENTITYBASE_HPP_
 
 #include <stdexcept>
+#include <vector>
 
 #include "engine/Common.hpp"
 
@@ -24,6 +25,11 @@
 
 namespace Kiaro
 {
+    namespace Network
+    {
+        class StringTable;
+    } // End NameSpace Network
+
     namespace Game
     {
         namespace Entities
@@ -42,8 +48,13 @@ namespace Kiaro
                     EntityBase(const Kiaro::Game::Entities::TypeMask &typeMask);
 
                     //! Standard destructor.
-                    ~EntityBase(void);
+                    virtual ~EntityBase(void);
 
+                    /**
+                     *  @brief Gives the entity a scene node showing the given shape file. The file is sent along with the
+                     *  entity's initialization, so clients show the same shape.
+                     *  @param filename The path of the shape file in the game's file system.
+                     */
                     void setShapeFile(const std::string &filename);
 
                     /**
@@ -54,19 +65,143 @@ namespace Kiaro
 
                     Kiaro::Common::U32 getNetID(void) const;
 
-                    virtual void packUpdate(Kiaro::Support::BitStream &out);
-                    virtual void unpackUpdate(Kiaro::Support::BitStream &in);
-                    virtual void packInitialization(Kiaro::Support::BitStream &out);
-                    virtual void unpackInitialization(Kiaro::Support::BitStream &in);
+                    void setNetID(const Kiaro::Common::U32 &netID);
+
+                    //! Returns the position of this entity in the world, or the origin if it has no scene node.
+                    virtual Kiaro::Common::Vector3DF getPosition(void) const;
+
+                    //! Returns the velocity of this entity in units per second. Entities that don't move return zero.
+                    virtual Kiaro::Common::Vector3DF getVelocity(void) const;
+
+                    /**
+                     *  @brief Returns how important it is for clients to receive updates of this entity, relative to other entities.
+                     *  @return A Kiaro::Common::F32 weighting this entity's share of each client's snapshot budget. The default is 1.
+                     */
+                    virtual Kiaro::Common::F32 getNetworkPriority(void) const;
+
+                    //! Serializes every property. This is the same as packUpdate with every property in the mask.
+                    void packData(Kiaro::Support::BitStream &out);
+                    //! Deserializes the properties received in snapshots. This is the same as unpackUpdate.
+                    void unpackData(Kiaro::Support::BitStream &in);
+
+                    /**
+                     *  @brief Returns the number of networked properties the entity has, each of which is a bit in a property
+                     *  mask with the first one in the lowest bit. There can be at most 32. The default is none.
+                     */
+                    virtual Kiaro::Common::U32 getPropertyCount(void) const { return 0; }
+
+                    //! Returns a property mask with every property in it.
+                    Kiaro::Common::U32 getPropertyMask(void) const;
+
+                    /**
+                     *  @brief Stamps every property whose value has changed since the last call with the given snapshot
+                     *  sequence number. The server calls this once for each snapshot before serializing anything.
+                     *  @param sequence The sequence number of the snapshot about to be taken.
+                     */
+                    void commitChanges(const Kiaro::Common::U32 &sequence);
+
+                    /**
+                     *  @brief Returns the properties that have changed since the given snapshot.
+                     *  @param sequence The sequence number of a snapshot, or 0 for every property.
+                     *  @return A property mask of the properties changed in later snapshots.
+                     */
+                    Kiaro::Common::U32 getChangedMask(const Kiaro::Common::U32 &sequence) const;
+
+                    /**
+                     *  @brief Serializes the state sent in snapshots: the given properties, followed by the property mask so
+                     *  that it is the first thing unpackUpdate reads.
+                     *  @param out The stream to write to.
+                     *  @param mask The properties to write.
+                     */
+                    void packUpdate(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask);
+
+                    //! Deserializes whichever properties packUpdate wrote. The rest keep their values.
+                    void unpackUpdate(Kiaro::Support::BitStream &in);
+
+                    /**
+                     *  @brief Sets the server's time in milliseconds of the state about to be unpacked, so that entities
+                     *  which interpolate know where on the timeline it goes.
+                     */
+                    void setUpdateTime(const Kiaro::Common::U32 &time) { mUpdateTime = time; }
+
+                    /**
+                     *  @brief Places the entity's scene node where it was at the given server time, from the states it has
+                     *  unpacked. This is called every frame on the client. Entities that don't move do nothing.
+                     *  @param renderTime The server time in milliseconds to draw the entity at.
+                     */
+                    virtual void interpolate(const Kiaro::Common::U32 &renderTime) { }
+
+                    /**
+                     *  @brief Serializes what a client needs to create the entity, which is sent once rather than with every
+                     *  update. The default sends the shape file, by its ID in the given string table.
+                     *  @param out The stream to write to.
+                     *  @param strings The table of the strings sent to the client. Strings that aren't in it yet are added,
+                     *  so it has to be sent on before the initialization is. The server packs this every snapshot and sends it
+                     *  in full snapshot entries, which are what clients create entities from.
+                     */
+                    virtual void packInitialization(Kiaro::Support::BitStream &out, Kiaro::Network::StringTable &strings);
+
+                    /**
+                     *  @brief Deserializes what packInitialization wrote.
+                     *  @param in The stream to read from.
+                     *  @param strings The table of the strings received from the server.
+                     */
+                    virtual void unpackInitialization(Kiaro::Support::BitStream &in, const Kiaro::Network::StringTable &strings);
                     virtual void instantiate(void) = 0;
                     virtual void update(const Kiaro::Common::F32 &deltaTimeSeconds) = 0;
 
+                // Protected Methods
+                protected:
+                    /**
+                     *  @brief Returns the properties whose values differ from when this was last called, and remembers the
+                     *  current values to compare against next time. Entities with a Kiaro::Support::FieldList return what
+                     *  its commit does. The default has no properties to change.
+                     */
+                    virtual Kiaro::Common::U32 collectChanges(void) { return 0; }
+
+                    /**
+                     *  @brief Writes the given properties. Properties are written in order and read back in reverse.
+                     *  @param out The stream to write to.
+                     *  @param mask The properties to write.
+                     */
+                    virtual void packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask) { }
+
+                    /**
+                     *  @brief Reads the given properties, as written by packProperties with the same mask.
+                     *  @param in The stream to read from.
+                     *  @param mask The properties to read.
+                     */
+                    virtual void unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask) { }
+
                 // Protected Members
                 protected:
                     const Kiaro::Common::U32 mTypeMask;
                     Kiaro::Common::U32 mNetID;
                     irr::scene::ISceneNode *mSceneNode;
+                    //! The shape file the scene node was loaded from, or an empty string if there is none.
+                    std::string mShapeFile;
+
+                    //! The server time in milliseconds of the state being unpacked.
+                    Kiaro::Common::U32 mUpdateTime;
+
+                // Private Members
+                private:
+                    //! The sequence number of the snapshot each property last changed in, or 0 if it never has.
+                    std::vector<Kiaro::Common::U32> mChangeSequences;
             };
+
+            /**
+             *  @brief Creates a new entity of the given type so that it can be filled in with replicated state.
+             *  @param typeMask The type mask of the entity to create.
+             *  @return A pointer to the new entity or NULL if entities of that type can not be created this way.
+             */
+            EntityBase *createEntity(const Kiaro::Game::Entities::TypeMask &typeMask);
+
+            /**
+             *  @brief Returns a hash of the networked fields of every entity createEntity can create, which the client
+             *  and server exchange at handshake to make sure they serialize entities the same way.
+             */
+            Kiaro::Common::U32 getSchemaHash(void);
         } // End Namespace Entities
     } // End Namespace Game
 } // End Namespace Kiaro
@@ -1,6 +1,6 @@
 /**
  *  @file Player.hpp
- *  @brief Include file defining the Server and related functions.
+ *  @brief Include file defining the Kiaro::Game::Entities::Player class.
  *
  *  This software is licensed under the GNU Lesser General Public License version 3.
  *  Please refer to gpl.txt and lgpl.txt for more information.
@@ -11,22 +11,95 @@
  *  @copyright (c) 2013 Draconic Entertainment
  */
 
-#ifndef _INCLUDE_KIARO_GAME_PLAYER_HPP_
-#define _INCLUDE_KIARO_GAME_PLAYER_HPP_
+#ifndef _INCLUDE_KIARO_GAME_ENTITIES_PLAYER_HPP_
+#define _INCLUDE_KIARO_GAME_ENTITIES_PLAYER_HPP_
 
-#include "EngineCommon.hpp"
+#include "engine/Common.hpp"
 
-#include <game/EntityBase.hpp>
+#include <engine/Config.hpp>
+
+#include <support/InterpolationBuffer.hpp>
+#include <support/FieldList.hpp>
+
+#include <game/entities/EntityBase.hpp>
 
 namespace Kiaro
 {
     namespace Game
     {
-        class Player : public Kiaro::Game::EntityBase
+        struct InputCommand;
+
+        namespace Entities
         {
-            // Public Methods
-            public:
-        };
+            //! The networked properties of a Player, in the order of Player::NetworkedFields.
+            enum PLAYER_PROPERTY
+            {
+                PLAYER_POSITION = 1,
+            };
+
+            /**
+             *  @brief An entity moved around by a client's input commands. The server applies them to the authoritative
+             *  player, and the controlling client applies the same commands to its own copy ahead of the server.
+             */
+            class Player : public Kiaro::Game::Entities::EntityBase
+            {
+                // Public Methods
+                public:
+                    Player(void);
+                    ~Player(void);
+
+                    Kiaro::Common::Vector3DF getPosition(void) const;
+                    Kiaro::Common::Vector3DF getVelocity(void) const;
+
+                    /**
+                     *  @brief Moves the player as the given input command says to. The same command always moves the player
+                     *  from the same position to the same position, on the server and on the client alike.
+                     *  @param command The input command to apply.
+                     */
+                    void applyInput(const Kiaro::Game::InputCommand &command);
+
+                    /**
+                     *  @brief Sets whether or not this is the player the local client controls. Such a player is drawn where
+                     *  its own input has put it rather than interpolated between snapshots.
+                     */
+                    void setPredicted(const bool &predicted) { mIsPredicted = predicted; }
+
+                    Kiaro::Common::U32 getPropertyCount(void) const { return NetworkedFields::getCount(); }
+
+                    void instantiate(void);
+                    void interpolate(const Kiaro::Common::U32 &renderTime);
+
+                    void update(const Kiaro::Common::F32 &deltaTimeSeconds);
+
+                // Protected Methods
+                protected:
+                    Kiaro::Common::U32 collectChanges(void) { return NetworkedFields::commit(*this, mCommittedFields); }
+
+                    void packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask);
+                    void unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask);
+
+                // Private Members
+                private:
+                    Kiaro::Common::Vector3DF mPosition;
+                    //! The velocity of the last input command applied, in units per second.
+                    Kiaro::Common::Vector3DF mVelocity;
+
+                    bool mIsPredicted;
+
+                    //! The positions received from the server, which the scene node is moved between.
+                    Kiaro::Support::InterpolationBuffer<Kiaro::Common::Vector3DF, NETWORK_INTERPOLATION_BUFFER_LENGTH> mPositionHistory;
+
+                // Public Members
+                public:
+                    //! The state sent in snapshots.
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD_CODEC(Player, mPosition, Kiaro::Support::QuantizedPositionCodec)> NetworkedFields;
+
+                // Private Members
+                private:
+                    //! The values of NetworkedFields as of the last snapshot, which tell which of them have changed since.
+                    NetworkedFields::Values mCommittedFields;
+            };
+        } // End Namespace Entities
     } // End Namespace Game
 } // End Namespace Kiaro
-#endif // _INCLUDE_KIARO_GAME_PLAYER_HPP_
+#endif // _INCLUDE_KIARO_GAME_ENTITIES_PLAYER_HPP_
@@ -16,6 +16,11 @@
 
 #include "engine/Common.hpp"
 
+#include <engine/Config.hpp>
+
+#include <support/InterpolationBuffer.hpp>
+#include <support/FieldList.hpp>
+
 #include <game/entities/EntityBase.hpp>
 
 #include <irrlicht.h>
@@ -26,6 +31,12 @@ namespace Kiaro
     {
         namespace Entities
         {
+            //! The networked properties of a RigidProp, in the order of RigidProp::NetworkedFields.
+            enum RIGIDPROP_PROPERTY
+            {
+                RIGIDPROP_POSITION = 1,
+            };
+
             class RigidProp : public Kiaro::Game::Entities::EntityBase
             {
                 // Public Methods
@@ -33,13 +44,41 @@ namespace Kiaro
                     RigidProp(void);
                     ~RigidProp(void);
 
-                    void packUpdate(Kiaro::Support::BitStream &out);
-                    void unpackUpdate(Kiaro::Support::BitStream &in);
-                    void packInitialization(Kiaro::Support::BitStream &out);
-                    void unpackInitialization(Kiaro::Support::BitStream &in);
+                    Kiaro::Common::Vector3DF getPosition(void) const { return mPosition; }
+
+                    //! Moves the prop, which is sent on to every client it is replicated to.
+                    void setPosition(const Kiaro::Common::Vector3DF &position);
+
+                    Kiaro::Common::U32 getPropertyCount(void) const { return NetworkedFields::getCount(); }
+
                     void instantiate(void);
+                    void interpolate(const Kiaro::Common::U32 &renderTime);
 
                     void update(const Kiaro::Common::F32 &deltaTimeSeconds);
+
+                // Protected Methods
+                protected:
+                    Kiaro::Common::U32 collectChanges(void) { return NetworkedFields::commit(*this, mCommittedFields); }
+
+                    void packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask);
+                    void unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask);
+
+                // Private Members
+                private:
+                    Kiaro::Common::Vector3DF mPosition;
+
+                    //! The positions received from the server, which the scene node is moved between.
+                    Kiaro::Support::InterpolationBuffer<Kiaro::Common::Vector3DF, NETWORK_INTERPOLATION_BUFFER_LENGTH> mPositionHistory;
+
+                // Public Members
+                public:
+                    //! The state sent in snapshots.
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD_CODEC(RigidProp, mPosition, Kiaro::Support::QuantizedPositionCodec)> NetworkedFields;
+
+                // Private Members
+                private:
+                    //! The values of NetworkedFields as of the last snapshot, which tell which of them have changed since.
+                    NetworkedFields::Values mCommittedFields;
             };
         } // End Namespace Entities
     } // End Namespace Game
@@ -18,6 +18,8 @@
 
 #include <game/entities/EntityBase.hpp>
 
+#include <support/FieldList.hpp>
+
 #include <irrlicht.h>
 
 namespace Kiaro
@@ -31,12 +33,12 @@ namespace Kiaro
     {
         namespace Entities
         {
+            //! The networked properties of a Terrain, in the order of Terrain::NetworkedFields. The terrain file is only sent with the initialization.
             enum TERRAIN_PROPERTY
             {
                 TERRAIN_NULL = 0,
                 TERRAIN_POSITION = 1,
                 TERRAIN_SCALE = 2,
-                TERRAIN_TERRAINFILE = 3,
             };
 
             class Terrain : public Kiaro::Game::Entities::EntityBase
@@ -44,22 +46,49 @@ namespace Kiaro
                 // Public Methods
                 public:
                     Terrain(const std::string &terrainFile);
-                    Terrain(Kiaro::Support::BitStream &in);
+                    //! Constructor accepting a terrain's initialization, as sent by packInitialization.
+                    Terrain(Kiaro::Support::BitStream &in, const Kiaro::Network::StringTable &strings);
 
                     ~Terrain(void);
 
-                    virtual void packUpdate(Kiaro::Support::BitStream &out);
-                    virtual void unpackUpdate(Kiaro::Support::BitStream &in);
-                    virtual void packInitialization(Kiaro::Support::BitStream &out);
-                    virtual void unpackInitialization(Kiaro::Support::BitStream &in);
+                    //! Moves the terrain, which is sent on to every client it is replicated to.
+                    void setPosition(const Kiaro::Common::Vector3DF &position);
+
+                    //! Returns the scale of the terrain, or no scaling at all if it has no scene node.
+                    Kiaro::Common::Vector3DF getScale(void) const;
+
+                    //! Scales the terrain, which is sent on to every client it is replicated to.
+                    void setScale(const Kiaro::Common::Vector3DF &scale);
+
+                    virtual Kiaro::Common::U32 getPropertyCount(void) const { return NetworkedFields::getCount(); }
+
+                    //! Serializes the position and the terrain file. The terrain builds its own scene node, so there's no shape file.
+                    virtual void packInitialization(Kiaro::Support::BitStream &out, Kiaro::Network::StringTable &strings);
+                    virtual void unpackInitialization(Kiaro::Support::BitStream &in, const Kiaro::Network::StringTable &strings);
                     virtual void instantiate(void);
                     virtual void update(const Kiaro::Common::F32 &deltaTimeSeconds);
 
+                // Protected Methods
+                protected:
+                    virtual Kiaro::Common::U32 collectChanges(void) { return NetworkedFields::commit(*this, mCommittedFields); }
+
+                    virtual void packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask);
+                    virtual void unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask);
+
                 // Private Members
                 private:
                     std::string mTerrainFile;
 
-                    static std::map<std::string, size_t> sNetworkedProperties;
+                // Public Members
+                public:
+                    //! The state sent in snapshots, which is kept on the scene node rather than in members of its own.
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_ACCESSOR_CODEC(Terrain, getPosition, setPosition, Kiaro::Support::QuantizedPositionCodec),
+                                                      KIARO_NETWORKED_ACCESSOR(Terrain, getScale, setScale)> NetworkedFields;
+
+                // Private Members
+                private:
+                    //! The values of NetworkedFields as of the last snapshot, which tell which of them have changed since.
+                    NetworkedFields::Values mCommittedFields;
             };
         } // End Namespace Entities
     } // End Namespace Game
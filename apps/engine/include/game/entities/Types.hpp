@@ -25,6 +25,7 @@ namespace Kiaro
                 ENTITY_NULL = 0,
                 ENTITY_RIGIDPROP = (1 << 0),
                 ENTITY_TERRAIN = (2 << 0),
+                ENTITY_PLAYER = (1 << 2),
             };
         } // End Namespace Entities
     } // End Namespace Game
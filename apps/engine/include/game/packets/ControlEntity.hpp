@@ -0,0 +1,66 @@
+/**
+ *  @file ControlEntity.hpp
+ *  @brief Include file defining the Kiaro::Game::Packets::ControlEntity packet.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_GAME_PACKETS_CONTROLENTITY_HPP_
+#define _INCLUDE_KIARO_GAME_PACKETS_CONTROLENTITY_HPP_
+
+#include <network/PacketBase.hpp>
+#include <support/FieldList.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            //! Reliable packet telling a client which replicated entity its input commands move.
+            class ControlEntity : public Kiaro::Network::PacketBase
+            {
+                // Public Methods
+                public:
+                    ControlEntity(Kiaro::Support::BitStream *in = NULL, Kiaro::Network::IncomingClientBase *sender = NULL) : Network::PacketBase(PACKET_CONTROLENTITY, in, sender),
+                    mNetID(0)
+                    {
+
+                    }
+
+                    void packData(Kiaro::Support::BitStream &out)
+                    {
+                        NetworkedFields::pack(*this, out);
+
+                        Kiaro::Network::PacketBase::packData(out);
+                    }
+
+                    void unpackData(Kiaro::Support::BitStream &in)
+                    {
+                        NetworkedFields::unpack(*this, in);
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        return Kiaro::Network::PacketBase::getPacketSize() + NetworkedFields::getSize();
+                    }
+
+                // Public Members
+                public:
+                    //! The network ID of the entity, or 0 for none.
+                    Kiaro::Common::U32 mNetID;
+
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(ControlEntity, mNetID)> NetworkedFields;
+
+                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+            };
+        } // End NameSpace Packets
+    } // End NameSpace Game
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_GAME_PACKETS_CONTROLENTITY_HPP_
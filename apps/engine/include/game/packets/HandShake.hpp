@@ -17,6 +17,7 @@
 #include <stdexcept>
 
 #include <network/PacketBase.hpp>
+#include <support/FieldList.hpp>
 
 namespace Kiaro
 {
@@ -41,10 +42,7 @@ namespace Kiaro
 
                     void packData(Kiaro::Support::BitStream &out)
                     {
-                        out.writeU8(mVersionMajor);
-                        out.writeU8(mVersionMinor);
-                        out.writeU8(mVersionRevision);
-                        out.writeU32(mVersionBuild);
+                        NetworkedFields::pack(*this, out);
 
                         Kiaro::Network::PacketBase::packData(out);
                     }
@@ -54,15 +52,17 @@ namespace Kiaro
                         if (in.length() <= getMinimumPacketPayloadLength())
                             throw std::runtime_error("Unable to unpack HandShake packet; too small of a payload!");
 
-                        mVersionBuild = in.readU32();
-                        mVersionRevision = in.readU8();
-                        mVersionMinor = in.readU8();
-                        mVersionMajor = in.readU8();
+                        NetworkedFields::unpack(*this, in);
                     }
 
                     Kiaro::Common::U32 getMinimumPacketPayloadLength(void)
                     {
-                        return sizeof(Kiaro::Common::U32) + (sizeof(Kiaro::Common::U8) * 3);
+                        return NetworkedFields::getSize();
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        return Kiaro::Network::PacketBase::getPacketSize() + NetworkedFields::getSize();
                     }
 
                 // Public Members
@@ -75,8 +75,14 @@ namespace Kiaro
                     Kiaro::Common::U8 mVersionRevision;
                     //! The build # of the engine.
                     Kiaro::Common::U32 mVersionBuild;
+                    //! What Kiaro::Game::Entities::getSchemaHash returns for the sender. Ends that disagree can't replicate entities to each other.
+                    Kiaro::Common::U32 mSchemaHash;
+
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(HandShake, mVersionMajor), KIARO_NETWORKED_FIELD(HandShake, mVersionMinor),
+                                                      KIARO_NETWORKED_FIELD(HandShake, mVersionRevision), KIARO_NETWORKED_FIELD(HandShake, mVersionBuild),
+                                                      KIARO_NETWORKED_FIELD(HandShake, mSchemaHash)> NetworkedFields;
 
-                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+                    static const Kiaro::Common::U8 sAcceptedStage = 0;
             };
         } // End NameSpace Packets
     } // End NameSpace Game
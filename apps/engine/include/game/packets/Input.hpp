@@ -0,0 +1,90 @@
+/**
+ *  @file Input.hpp
+ *  @brief Include file defining the Kiaro::Game::Packets::Input packet.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_GAME_PACKETS_INPUT_HPP_
+#define _INCLUDE_KIARO_GAME_PACKETS_INPUT_HPP_
+
+#include <vector>
+#include <stdexcept>
+
+#include <network/PacketBase.hpp>
+
+#include <game/InputCommand.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            /**
+             *  @brief Unreliable packet carrying a client's most recent input commands, oldest first.
+             *  @details Every command is sent in a few packets in a row so that losing one packet doesn't lose any input;
+             *  the server skips whatever it has already applied.
+             */
+            class Input : public Kiaro::Network::PacketBase
+            {
+                // Public Methods
+                public:
+                    Input(Kiaro::Support::BitStream *in = NULL, Kiaro::Network::IncomingClientBase *sender = NULL) : Network::PacketBase(PACKET_INPUT, in, sender)
+                    {
+
+                    }
+
+                    void packData(Kiaro::Support::BitStream &out)
+                    {
+                        for (std::vector<Kiaro::Game::InputCommand>::const_reverse_iterator it = mCommands.rbegin(); it != mCommands.rend(); it++)
+                        {
+                            out.writeU8(it->mDuration);
+                            out.writeU8(it->mButtons);
+                            out.writeU32(it->mSequence);
+                        }
+
+                        out.writeU8(mCommands.size());
+
+                        Kiaro::Network::PacketBase::packData(out);
+                    }
+
+                    void unpackData(Kiaro::Support::BitStream &in)
+                    {
+                        mCommands.resize(in.readU8());
+
+                        if (mCommands.size() * (sizeof(Kiaro::Common::U32) + sizeof(Kiaro::Common::U8) * 2) > in.length())
+                            throw std::runtime_error("Unable to unpack Input packet; bad command count!");
+
+                        for (std::vector<Kiaro::Game::InputCommand>::iterator it = mCommands.begin(); it != mCommands.end(); it++)
+                        {
+                            it->mSequence = in.readU32();
+                            it->mButtons = in.readU8();
+                            it->mDuration = in.readU8();
+                        }
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        return Kiaro::Network::PacketBase::getPacketSize() + sizeof(Kiaro::Common::U8) +
+                        (mCommands.size() * (sizeof(Kiaro::Common::U32) + sizeof(Kiaro::Common::U8) * 2));
+                    }
+
+                // Public Members
+                public:
+                    std::vector<Kiaro::Game::InputCommand> mCommands;
+
+                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+                    //! Each input packet repeats the last few commands, so a lost one is made up for by the next.
+                    static const Kiaro::Network::TRAFFIC_CLASS sTrafficClass = Kiaro::Network::TRAFFIC_UNRELIABLE_SEQUENCED;
+            };
+        } // End NameSpace Packets
+    } // End NameSpace Game
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_GAME_PACKETS_INPUT_HPP_
@@ -0,0 +1,70 @@
+/**
+ *  @file Ping.hpp
+ *  @brief Include file defining the Kiaro::Game::Packets::Ping packet.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_GAME_PACKETS_PING_HPP_
+#define _INCLUDE_KIARO_GAME_PACKETS_PING_HPP_
+
+#include <network/PacketBase.hpp>
+#include <support/FieldList.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            //! Unreliable packet that the server sends straight back to whoever sent it, for measuring round trip latency.
+            class Ping : public Kiaro::Network::PacketBase
+            {
+                // Public Methods
+                public:
+                    Ping(Kiaro::Support::BitStream *in = NULL, Kiaro::Network::IncomingClientBase *sender = NULL) : Network::PacketBase(PACKET_PING, in, sender),
+                    mSequence(0), mTimestamp(0)
+                    {
+
+                    }
+
+                    void packData(Kiaro::Support::BitStream &out)
+                    {
+                        NetworkedFields::pack(*this, out);
+
+                        Kiaro::Network::PacketBase::packData(out);
+                    }
+
+                    void unpackData(Kiaro::Support::BitStream &in)
+                    {
+                        NetworkedFields::unpack(*this, in);
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        return Kiaro::Network::PacketBase::getPacketSize() + NetworkedFields::getSize();
+                    }
+
+                // Public Members
+                public:
+                    //! The sequence number of this ping, which is the sender's business.
+                    Kiaro::Common::U32 mSequence;
+                    //! The time this ping was sent in microseconds, by whatever clock the sender keeps.
+                    Kiaro::Common::U64 mTimestamp;
+
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(Ping, mTimestamp), KIARO_NETWORKED_FIELD(Ping, mSequence)> NetworkedFields;
+
+                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+                    //! Every ping is timed on its own, so order doesn't matter.
+                    static const Kiaro::Network::TRAFFIC_CLASS sTrafficClass = Kiaro::Network::TRAFFIC_UNRELIABLE;
+            };
+        } // End NameSpace Packets
+    } // End NameSpace Game
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_GAME_PACKETS_PING_HPP_
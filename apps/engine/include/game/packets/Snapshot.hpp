@@ -0,0 +1,376 @@
+/**
+ *  @file Snapshot.hpp
+ *  @brief Include file defining the Kiaro::Game::Packets::Snapshot packet.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_GAME_PACKETS_SNAPSHOT_HPP_
+#define _INCLUDE_KIARO_GAME_PACKETS_SNAPSHOT_HPP_
+
+#include <vector>
+#include <stdexcept>
+
+#include <network/PacketBase.hpp>
+#include <network/SnapshotHistory.hpp>
+
+#include <support/GatherWriter.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            //! How a single entity is described in a Snapshot packet.
+            enum SNAPSHOT_ENTRY_KIND
+            {
+                //! The entity's initialization and complete state, sent when the baseline does not have it.
+                SNAPSHOT_ENTRY_FULL = 0,
+                //! The entity's properties that changed since the baseline, which is all the entity's packUpdate wrote.
+                SNAPSHOT_ENTRY_UPDATE = 1,
+                //! The entity is identical to its state in the baseline.
+                SNAPSHOT_ENTRY_UNCHANGED = 2,
+            };
+
+            /**
+             *  @brief Unreliable packet carrying the state of every entity replicated to a client.
+             *  @details Entities are described relative to a baseline snapshot that the client has acknowledged. Entities
+             *  that are in the baseline but not in this snapshot no longer exist for the client. Each entity only writes the
+             *  properties that changed since the state the client acknowledged, so the client applies every entry on top of
+             *  the entity as it already has it. Entity state is never copied into the packet itself; entries point at it
+             *  where it already is, and pack hands it to a Kiaro::Support::GatherWriter as is. Initializations may refer
+             *  to strings that are still on their way over the reliable channel, so the client holds off on any snapshot
+             *  until it has as many strings as the server had sent it.
+             */
+            class Snapshot : public Kiaro::Network::PacketBase
+            {
+                // Public Methods
+                public:
+                    //! A single entity in the snapshot.
+                    struct Entry
+                    {
+                        Kiaro::Common::U32 mNetID;
+                        Kiaro::Common::U8 mKind;
+                        //! Only sent for SNAPSHOT_ENTRY_FULL.
+                        Kiaro::Common::U32 mTypeMask;
+                        /**
+                         *  @brief What the entity's packUpdate wrote, or NULL for SNAPSHOT_ENTRY_UNCHANGED. Points into the
+                         *  snapshot the packet was encoded from or the stream it was unpacked from, so it is only good for
+                         *  as long as they are.
+                         */
+                        const Kiaro::Common::U8 *mData;
+                        Kiaro::Common::U8 mDataSize;
+                        //! What the entity's packInitialization wrote. Only sent for SNAPSHOT_ENTRY_FULL, and kept alive the same way as mData.
+                        const Kiaro::Common::U8 *mInitialization;
+                        Kiaro::Common::U8 mInitializationSize;
+
+                        //! Points the entry at an entity's state.
+                        void setData(const std::vector<Kiaro::Common::U8> &data)
+                        {
+                            mData = data.empty() ? NULL : &data[0];
+                            mDataSize = data.size();
+                        }
+
+                        //! Points the entry at an entity's initialization.
+                        void setInitialization(const std::vector<Kiaro::Common::U8> &initialization)
+                        {
+                            mInitialization = initialization.empty() ? NULL : &initialization[0];
+                            mInitializationSize = initialization.size();
+                        }
+                    };
+
+                    Snapshot(Kiaro::Support::BitStream *in = NULL, Kiaro::Network::IncomingClientBase *sender = NULL) : Network::PacketBase(PACKET_SNAPSHOT, in, sender),
+                    mSequence(0), mTime(0), mBaselineSequence(0), mInputSequence(0), mStringCount(0)
+                    {
+
+                    }
+
+                    /**
+                     *  @brief Looks up the state in the baseline that an entity can be described relative to.
+                     *  @param netID The network ID of the entity.
+                     *  @param current The state of the entity to send.
+                     *  @param baseline The snapshot the client has acknowledged, or NULL.
+                     *  @return The entity's state in the baseline, or NULL if it has to be sent in full: when it isn't in the
+                     *  baseline, has changed type, or has been left out of a snapshot since, as the client may have destroyed it.
+                     */
+                    static const Kiaro::Network::EntityState *getBaselineState(const Kiaro::Common::U32 &netID, const Kiaro::Network::EntityState &current,
+                                                                              const Kiaro::Network::Snapshot *baseline)
+                    {
+                        if (!baseline)
+                            return NULL;
+
+                        std::map<Kiaro::Common::U32, Kiaro::Network::EntityState>::const_iterator baselineState = baseline->mEntityStates.find(netID);
+                        if (baselineState == baseline->mEntityStates.end() || baselineState->second.mTypeMask != current.mTypeMask ||
+                            (Kiaro::Common::S32)(current.mFirstSequence - baseline->mSequence) > 0)
+                            return NULL;
+
+                        return &baselineState->second;
+                    }
+
+                    /**
+                     *  @brief Fills this packet with the differences between two snapshots.
+                     *  @param current The snapshot to send, which must outlive the packet being packed.
+                     *  @param baseline The snapshot the client has acknowledged, or NULL to send full state.
+                     */
+                    void encode(const Kiaro::Network::Snapshot &current, const Kiaro::Network::Snapshot *baseline)
+                    {
+                        mSequence = current.mSequence;
+                        mTime = current.mTime;
+                        mBaselineSequence = baseline ? baseline->mSequence : 0;
+                        mEntries.clear();
+                        mEntries.reserve(current.mEntityStates.size());
+
+                        for (std::map<Kiaro::Common::U32, Kiaro::Network::EntityState>::const_iterator it = current.mEntityStates.begin(); it != current.mEntityStates.end(); it++)
+                        {
+                            mEntries.push_back(Entry());
+                            Entry &entry = mEntries.back();
+                            entry.mNetID = it->first;
+                            entry.mTypeMask = it->second.mTypeMask;
+                            entry.mData = NULL;
+                            entry.mDataSize = 0;
+                            entry.mInitialization = NULL;
+                            entry.mInitializationSize = 0;
+
+                            const Kiaro::Network::EntityState *baselineState = getBaselineState(it->first, it->second, baseline);
+
+                            if (!baselineState)
+                            {
+                                entry.mKind = SNAPSHOT_ENTRY_FULL;
+                                entry.setData(it->second.mData);
+                                entry.setInitialization(it->second.mInitialization);
+                            }
+                            // The client ends up with the same bytes either way, so there's no need to send them again
+                            else if (baselineState->mData == it->second.mData)
+                                entry.mKind = SNAPSHOT_ENTRY_UNCHANGED;
+                            else
+                            {
+                                entry.mKind = SNAPSHOT_ENTRY_UPDATE;
+                                entry.setData(it->second.mData);
+                            }
+                        }
+                    }
+
+                    /**
+                     *  @brief Returns the number of bytes encode and packData will use for a single entity.
+                     *  @param netID The network ID of the entity.
+                     *  @param current The state of the entity to send.
+                     *  @param baseline The state getBaselineState returned for the entity.
+                     */
+                    static Kiaro::Common::U32 getEntrySize(const Kiaro::Common::U32 &netID, const Kiaro::Network::EntityState &current,
+                                                           const Kiaro::Network::EntityState *baseline)
+                    {
+                        const Kiaro::Common::U32 headerSize = Kiaro::Support::BitStream::getVarU32Size(netID) + sizeof(Kiaro::Common::U8);
+
+                        if (!baseline)
+                            return headerSize + sizeof(Kiaro::Common::U32) + (sizeof(Kiaro::Common::U8) * 2) + current.mInitialization.size() + current.mData.size();
+                        else if (baseline->mData == current.mData)
+                            return headerSize;
+
+                        return headerSize + sizeof(Kiaro::Common::U8) + current.mData.size();
+                    }
+
+                    //! Returns the most bytes a Snapshot packet uses before any entities are added to it.
+                    static Kiaro::Common::U32 getHeaderSize(void)
+                    {
+                        return Kiaro::Network::PacketBase::getMaximumHeaderSize() + (sizeof(Kiaro::Common::U32) * 4) + sizeof(Kiaro::Common::U16) +
+                               Kiaro::Support::BitStream::getVarU32Size(0xFFFFFFFF);
+                    }
+
+                    /**
+                     *  @brief Rebuilds the complete snapshot that was encoded into this packet.
+                     *  @param baseline The snapshot named by mBaselineSequence, or NULL if mBaselineSequence is 0.
+                     *  @param out The snapshot to write into.
+                     *  @return A boolean representing whether or not the snapshot could be rebuilt from the given baseline.
+                     */
+                    bool decode(const Kiaro::Network::Snapshot *baseline, Kiaro::Network::Snapshot &out)
+                    {
+                        out.mSequence = mSequence;
+                        out.mTime = mTime;
+                        out.mEntityStates.clear();
+
+                        for (std::vector<Entry>::const_iterator it = mEntries.begin(); it != mEntries.end(); it++)
+                        {
+                            Kiaro::Network::EntityState &state = out.mEntityStates[it->mNetID];
+
+                            if (it->mKind == SNAPSHOT_ENTRY_FULL)
+                            {
+                                state.mTypeMask = it->mTypeMask;
+                                state.mData.assign(it->mData, it->mData + it->mDataSize);
+                                state.mInitialization.assign(it->mInitialization, it->mInitialization + it->mInitializationSize);
+                                continue;
+                            }
+
+                            std::map<Kiaro::Common::U32, Kiaro::Network::EntityState>::const_iterator baselineState;
+                            if (!baseline || (baselineState = baseline->mEntityStates.find(it->mNetID)) == baseline->mEntityStates.end())
+                                return false;
+
+                            state = baselineState->second;
+
+                            if (it->mKind == SNAPSHOT_ENTRY_UPDATE)
+                                state.mData.assign(it->mData, it->mData + it->mDataSize);
+                        }
+
+                        return true;
+                    }
+
+                    void packData(Kiaro::Support::BitStream &out)
+                    {
+                        packEntries(out);
+                    }
+
+                    /**
+                     *  @brief Packs the same bytes as packData, but has the writer refer to each entity's state rather
+                     *  than copying it.
+                     *  @param out The writer to compose the packet in.
+                     */
+                    void pack(Kiaro::Support::GatherWriter &out)
+                    {
+                        packEntries(out);
+                    }
+
+                    void unpackData(Kiaro::Support::BitStream &in)
+                    {
+                        mSequence = in.readU32();
+                        mTime = in.readU32();
+                        mBaselineSequence = in.readU32();
+                        mInputSequence = in.readU32();
+                        mStringCount = in.readU16();
+
+                        const Kiaro::Common::U32 entryCount = in.readVarU32();
+                        if (entryCount > in.length())
+                            throw std::runtime_error("Unable to unpack Snapshot packet; bad entry count!");
+
+                        mEntries.clear();
+                        mEntries.resize(entryCount);
+
+                        for (Kiaro::Common::U32 entryIndex = 0; entryIndex < entryCount; entryIndex++)
+                        {
+                            Entry &entry = mEntries[entryIndex];
+                            entry.mNetID = in.readVarU32();
+                            entry.mKind = in.readU8();
+                            entry.mTypeMask = 0;
+
+                            if (entry.mKind > SNAPSHOT_ENTRY_UNCHANGED)
+                                throw std::runtime_error("Unable to unpack Snapshot packet; bad entry kind!");
+
+                            entry.mData = NULL;
+                            entry.mDataSize = 0;
+                            entry.mInitialization = NULL;
+                            entry.mInitializationSize = 0;
+
+                            // Both are left where they are in the stream, which outlives the packet's handler
+                            if (entry.mKind == SNAPSHOT_ENTRY_FULL)
+                            {
+                                entry.mTypeMask = in.readU32();
+                                entry.mInitializationSize = in.readU8();
+                                entry.mInitialization = (const Kiaro::Common::U8 *)in.read(entry.mInitializationSize);
+                            }
+
+                            if (entry.mKind != SNAPSHOT_ENTRY_UNCHANGED)
+                            {
+                                entry.mDataSize = in.readU8();
+                                entry.mData = (const Kiaro::Common::U8 *)in.read(entry.mDataSize);
+                            }
+                        }
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        Kiaro::Common::U32 result = Kiaro::Network::PacketBase::getPacketSize() + (sizeof(Kiaro::Common::U32) * 4) + sizeof(Kiaro::Common::U16) +
+                                                    Kiaro::Support::BitStream::getVarU32Size(mEntries.size());
+
+                        for (std::vector<Entry>::const_iterator it = mEntries.begin(); it != mEntries.end(); it++)
+                        {
+                            result += Kiaro::Support::BitStream::getVarU32Size(it->mNetID) + sizeof(Kiaro::Common::U8);
+
+                            if (it->mKind == SNAPSHOT_ENTRY_FULL)
+                                result += sizeof(Kiaro::Common::U32) + sizeof(Kiaro::Common::U8) + it->mInitializationSize;
+
+                            if (it->mKind != SNAPSHOT_ENTRY_UNCHANGED)
+                                result += sizeof(Kiaro::Common::U8) + it->mDataSize;
+                        }
+
+                        return result;
+                    }
+
+                // Private Methods
+                private:
+                    //! Returns the stream that a packet's own bytes are written to.
+                    static Kiaro::Support::BitStream &getStream(Kiaro::Support::BitStream &out) { return out; }
+                    static Kiaro::Support::BitStream &getStream(Kiaro::Support::GatherWriter &out) { return out.getStream(); }
+
+                    //! Adds an entity's state or initialization to a packet, copying it into a stream or referring to it from a writer.
+                    static void writeData(Kiaro::Support::BitStream &out, const Kiaro::Common::U8 *data, const Kiaro::Common::U8 &size) { out.write(data, size); }
+                    static void writeData(Kiaro::Support::GatherWriter &out, const Kiaro::Common::U8 *data, const Kiaro::Common::U8 &size) { out.reference(data, size); }
+
+                    //! Packs the packet into either a Kiaro::Support::BitStream or a Kiaro::Support::GatherWriter.
+                    template <typename writerType>
+                    void packEntries(writerType &writer)
+                    {
+                        Kiaro::Support::BitStream &out = getStream(writer);
+
+                        for (std::vector<Entry>::const_iterator it = mEntries.begin(); it != mEntries.end(); it++)
+                        {
+                            const Entry &entry = *it;
+
+                            if (entry.mKind != SNAPSHOT_ENTRY_UNCHANGED)
+                            {
+                                if (entry.mDataSize != 0)
+                                    writeData(writer, entry.mData, entry.mDataSize);
+
+                                out.writeU8(entry.mDataSize);
+                            }
+
+                            if (entry.mKind == SNAPSHOT_ENTRY_FULL)
+                            {
+                                if (entry.mInitializationSize != 0)
+                                    writeData(writer, entry.mInitialization, entry.mInitializationSize);
+
+                                out.writeU8(entry.mInitializationSize);
+                                out.writeU32(entry.mTypeMask);
+                            }
+
+                            out.writeU8(entry.mKind);
+                            out.writeVarU32(entry.mNetID);
+                        }
+
+                        out.writeVarU32(mEntries.size());
+                        out.writeU16(mStringCount);
+                        out.writeU32(mInputSequence);
+                        out.writeU32(mBaselineSequence);
+                        out.writeU32(mTime);
+                        out.writeU32(mSequence);
+
+                        Kiaro::Network::PacketBase::packData(out);
+                    }
+
+                // Public Members
+                public:
+                    //! The sequence number of this snapshot.
+                    Kiaro::Common::U32 mSequence;
+                    //! The server's time in milliseconds when this snapshot was taken.
+                    Kiaro::Common::U32 mTime;
+                    //! The sequence number of the snapshot this one was diffed against, or 0 if it holds full state.
+                    Kiaro::Common::U32 mBaselineSequence;
+                    //! The sequence number of the last input command the server applied for the receiving client.
+                    Kiaro::Common::U32 mInputSequence;
+                    //! The number of strings the server had sent the receiving client, which the initializations may refer to.
+                    Kiaro::Common::U16 mStringCount;
+
+                    std::vector<Entry> mEntries;
+
+                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+                    //! Only the newest snapshot matters, and the next one is never far behind.
+                    static const Kiaro::Network::TRAFFIC_CLASS sTrafficClass = Kiaro::Network::TRAFFIC_UNRELIABLE_SEQUENCED;
+            };
+        } // End NameSpace Packets
+    } // End NameSpace Game
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_GAME_PACKETS_SNAPSHOT_HPP_
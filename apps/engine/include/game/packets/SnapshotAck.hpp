@@ -0,0 +1,68 @@
+/**
+ *  @file SnapshotAck.hpp
+ *  @brief Include file defining the Kiaro::Game::Packets::SnapshotAck packet.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_GAME_PACKETS_SNAPSHOTACK_HPP_
+#define _INCLUDE_KIARO_GAME_PACKETS_SNAPSHOTACK_HPP_
+
+#include <network/PacketBase.hpp>
+#include <support/FieldList.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            //! Unreliable packet a client sends back for every Snapshot it was able to decode.
+            class SnapshotAck : public Kiaro::Network::PacketBase
+            {
+                // Public Methods
+                public:
+                    SnapshotAck(Kiaro::Support::BitStream *in = NULL, Kiaro::Network::IncomingClientBase *sender = NULL) : Network::PacketBase(PACKET_SNAPSHOTACK, in, sender),
+                    mSequence(0)
+                    {
+
+                    }
+
+                    void packData(Kiaro::Support::BitStream &out)
+                    {
+                        NetworkedFields::pack(*this, out);
+
+                        Kiaro::Network::PacketBase::packData(out);
+                    }
+
+                    void unpackData(Kiaro::Support::BitStream &in)
+                    {
+                        NetworkedFields::unpack(*this, in);
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        return Kiaro::Network::PacketBase::getPacketSize() + NetworkedFields::getSize();
+                    }
+
+                // Public Members
+                public:
+                    //! The sequence number of the acknowledged snapshot.
+                    Kiaro::Common::U32 mSequence;
+
+                    typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(SnapshotAck, mSequence)> NetworkedFields;
+
+                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+                    //! A newer acknowledgement supersedes an older one.
+                    static const Kiaro::Network::TRAFFIC_CLASS sTrafficClass = Kiaro::Network::TRAFFIC_UNRELIABLE_SEQUENCED;
+            };
+        } // End NameSpace Packets
+    } // End NameSpace Game
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_GAME_PACKETS_SNAPSHOTACK_HPP_
@@ -0,0 +1,97 @@
+/**
+ *  @file StringTableUpdate.hpp
+ *  @brief Include file defining the Kiaro::Game::Packets::StringTableUpdate packet.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_GAME_PACKETS_STRINGTABLEUPDATE_HPP_
+#define _INCLUDE_KIARO_GAME_PACKETS_STRINGTABLEUPDATE_HPP_
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <network/PacketBase.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Packets
+        {
+            /**
+             *  @brief Reliable packet carrying strings the server has added to its Kiaro::Network::StringTable since the
+             *  client was last sent any, in order of their IDs.
+             */
+            class StringTableUpdate : public Kiaro::Network::PacketBase
+            {
+                // Public Methods
+                public:
+                    StringTableUpdate(Kiaro::Support::BitStream *in = NULL, Kiaro::Network::IncomingClientBase *sender = NULL) : Network::PacketBase(PACKET_STRINGTABLEUPDATE, in, sender),
+                    mFirstID(0)
+                    {
+
+                    }
+
+                    void packData(Kiaro::Support::BitStream &out)
+                    {
+                        for (std::vector<std::string>::const_reverse_iterator it = mStrings.rbegin(); it != mStrings.rend(); it++)
+                        {
+                            out.write(it->data(), it->size());
+                            out.writeU16(it->size());
+                        }
+
+                        out.writeU16(mStrings.size());
+                        out.writeU16(mFirstID);
+
+                        Kiaro::Network::PacketBase::packData(out);
+                    }
+
+                    void unpackData(Kiaro::Support::BitStream &in)
+                    {
+                        mFirstID = in.readU16();
+                        mStrings.resize(in.readU16());
+
+                        if (mStrings.size() * sizeof(Kiaro::Common::U16) > in.length())
+                            throw std::runtime_error("Unable to unpack StringTableUpdate packet; bad string count!");
+
+                        for (std::vector<std::string>::iterator it = mStrings.begin(); it != mStrings.end(); it++)
+                        {
+                            const Kiaro::Common::U16 length = in.readU16();
+
+                            if (length > in.length())
+                                throw std::runtime_error("Unable to unpack StringTableUpdate packet; bad string length!");
+
+                            it->assign((const Kiaro::Common::C8 *)in.read(length), length);
+                        }
+                    }
+
+                    Kiaro::Common::U32 getPacketSize(void)
+                    {
+                        Kiaro::Common::U32 result = Kiaro::Network::PacketBase::getPacketSize() + sizeof(Kiaro::Common::U16) * 2;
+
+                        for (std::vector<std::string>::const_iterator it = mStrings.begin(); it != mStrings.end(); it++)
+                            result += sizeof(Kiaro::Common::U16) + it->size();
+
+                        return result;
+                    }
+
+                // Public Members
+                public:
+                    //! The ID of the first string. The rest follow on from it.
+                    Kiaro::Common::U16 mFirstID;
+                    std::vector<std::string> mStrings;
+
+                    static const Kiaro::Common::U8 sAcceptedStage = 1;
+            };
+        } // End NameSpace Packets
+    } // End NameSpace Game
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_GAME_PACKETS_STRINGTABLEUPDATE_HPP_
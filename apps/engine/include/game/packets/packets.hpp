@@ -23,11 +23,23 @@ namespace Kiaro
             enum PACKET_TYPE
             {
                 PACKET_HANDSHAKE = 0x03,
+                PACKET_SNAPSHOT = 0x04,
+                PACKET_SNAPSHOTACK = 0x05,
+                PACKET_PING = 0x06,
+                PACKET_INPUT = 0x07,
+                PACKET_CONTROLENTITY = 0x08,
+                PACKET_STRINGTABLEUPDATE = 0x09,
             }; // End Enum PACKET_TYPE
         } // End NameSpace Packets
     } // End Namespace Game
 } // End NameSpace Kiaro
 
 #include <game/packets/HandShake.hpp>
+#include <game/packets/Snapshot.hpp>
+#include <game/packets/SnapshotAck.hpp>
+#include <game/packets/Ping.hpp>
+#include <game/packets/Input.hpp>
+#include <game/packets/ControlEntity.hpp>
+#include <game/packets/StringTableUpdate.hpp>
 
 #endif // _INCLUDE_KIARO_GAME_PACKETS_HANDSHAKE_HPP_
@@ -43,9 +43,7 @@ namespace Kiaro
              */
             virtual void onReceivePacket(Kiaro::Support::BitStream &incomingStream) = 0;
 
-            virtual void send(Kiaro::Network::PacketBase *packet, const bool &reliable) = 0;
-
-            //bool GetIsOppositeEndian(void) { return mIsOppositeEndian; }
+            virtual void send(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass) = 0;
 
             virtual void disconnect(void) = 0;
 
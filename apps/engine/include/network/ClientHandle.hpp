@@ -0,0 +1,55 @@
+/**
+ *  @file ClientHandle.hpp
+ *  @brief Include file defining the Kiaro::Network::ClientHandle structure.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_CLIENTHANDLE_HPP_
+#define _INCLUDE_KIARO_NETWORK_CLIENTHANDLE_HPP_
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        /**
+         *  @brief Names a client by its slot in a Kiaro::Network::ClientTable and the generation of that slot.
+         *  @details A slot's generation moves on every time it is freed, so a handle kept around after its client has
+         *  disconnected never finds whoever takes the slot next. Generation 0 is never handed out, which makes the default
+         *  handle an invalid one. The whole handle packs into a Kiaro::Common::U32, so it can be sent as one.
+         */
+        struct ClientHandle
+        {
+            //! Standard constructor. Creates an invalid handle.
+            ClientHandle(void) : mIndex(0), mGeneration(0) { }
+
+            ClientHandle(const Kiaro::Common::U16 &index, const Kiaro::Common::U16 &generation) : mIndex(index), mGeneration(generation) { }
+
+            //! Constructor accepting a handle packed by getPacked, such as one read off the network.
+            explicit ClientHandle(const Kiaro::Common::U32 &packed) : mIndex(packed & 0xFFFF), mGeneration(packed >> 16) { }
+
+            //! Returns the handle packed into a Kiaro::Common::U32, with the generation in the upper half.
+            Kiaro::Common::U32 getPacked(void) const { return ((Kiaro::Common::U32)mGeneration << 16) | mIndex; }
+
+            //! Returns whether or not the handle could name a client at all. It may still be stale.
+            bool isValid(void) const { return mGeneration != 0; }
+
+            bool operator ==(const ClientHandle &other) const { return mIndex == other.mIndex && mGeneration == other.mGeneration; }
+            bool operator !=(const ClientHandle &other) const { return !(*this == other); }
+
+            //! The index of the slot.
+            Kiaro::Common::U16 mIndex;
+            //! The generation of the slot when the client took it.
+            Kiaro::Common::U16 mGeneration;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_CLIENTHANDLE_HPP_
@@ -0,0 +1,99 @@
+/**
+ *  @file ClientTable.hpp
+ *  @brief Include file defining the Kiaro::Network::ClientTable class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_CLIENTTABLE_HPP_
+#define _INCLUDE_KIARO_NETWORK_CLIENTTABLE_HPP_
+
+#include <vector>
+
+#include "engine/Common.hpp"
+#include <network/ClientHandle.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        class IncomingClientBase;
+
+        /**
+         *  @brief A fixed number of slots that connected clients are kept in, addressed by Kiaro::Network::ClientHandle.
+         *  @details Every slot is allocated up front. The clients in use are also kept packed together at the front of a
+         *  second array, so going over every client is a walk down contiguous memory rather than a tree, and removing one
+         *  moves the last client into its place. That means removal reorders the clients, so nothing should rely on their
+         *  order. Slots hold the clients they are given but never own them.
+         */
+        class ClientTable
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the number of slots.
+                 *  @param capacity The number of slots.
+                 *  @throw std::out_of_range Thrown when there are more slots than a handle can address.
+                 */
+                ClientTable(const Kiaro::Common::U32 &capacity);
+
+                /**
+                 *  @brief Puts a client in a free slot.
+                 *  @param client The client to insert.
+                 *  @return The client's handle, which is also given to the client, or an invalid handle if every slot is taken.
+                 */
+                Kiaro::Network::ClientHandle insert(Kiaro::Network::IncomingClientBase *client);
+
+                /**
+                 *  @brief Frees the slot a client is in, which moves the slot on to its next generation.
+                 *  @param handle The client's handle.
+                 *  @return The client that was in the slot, or NULL if the handle was stale.
+                 */
+                Kiaro::Network::IncomingClientBase *remove(const Kiaro::Network::ClientHandle &handle);
+
+                /**
+                 *  @brief Looks up a client by its handle.
+                 *  @return The client, or NULL if the handle is invalid or stale.
+                 */
+                Kiaro::Network::IncomingClientBase *get(const Kiaro::Network::ClientHandle &handle) const;
+
+                //! Returns the number of clients in the table.
+                size_t getCount(void) const { return mClients.size(); }
+
+                //! Returns the number of slots.
+                size_t getCapacity(void) const { return mSlots.size(); }
+
+                /**
+                 *  @brief Returns a client by its position among the clients in the table, for going over all of them.
+                 *  @param position The position from 0 to getCount() - 1.
+                 */
+                Kiaro::Network::IncomingClientBase *getClient(const size_t &position) const { return mClients[position]; }
+
+            // Private Members
+            private:
+                //! A slot a client may be kept in.
+                struct Slot
+                {
+                    Kiaro::Network::IncomingClientBase *mClient;
+                    Kiaro::Common::U16 mGeneration;
+                    //! The position of the slot's client in mClients.
+                    Kiaro::Common::U32 mPosition;
+                };
+
+                std::vector<Slot> mSlots;
+                //! The clients in the table, packed together.
+                std::vector<Kiaro::Network::IncomingClientBase *> mClients;
+                //! The slot index of each client in mClients, kept alongside it so that removal never has to touch the client.
+                std::vector<Kiaro::Common::U16> mClientSlots;
+                //! The indices of the free slots, the next one to be taken at the back.
+                std::vector<Kiaro::Common::U16> mFreeSlots;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_CLIENTTABLE_HPP_
@@ -0,0 +1,129 @@
+/**
+ *  @file DemoFile.hpp
+ *  @brief Include file defining the Kiaro::Network::DemoRecorder and Kiaro::Network::DemoPlayer classes.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_DEMOFILE_HPP_
+#define _INCLUDE_KIARO_NETWORK_DEMOFILE_HPP_
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        //! An enumeration of what received the packets in a demo.
+        enum DEMO_SOURCE
+        {
+            //! Packets a server received from its clients.
+            DEMO_SOURCE_SERVER = 0,
+            //! Packets a client received from its server.
+            DEMO_SOURCE_CLIENT = 1,
+        }; // End Enum DEMO_SOURCE
+
+        //! A single received packet in a demo.
+        struct DemoRecord
+        {
+            //! The time the packet was received in microseconds since recording started.
+            Kiaro::Common::U64 mTime;
+            //! The port of the client that sent the packet, for server demos.
+            Kiaro::Common::U16 mSender;
+            //! The packet type, or 0 if the packet was too short to have one.
+            Kiaro::Common::U32 mType;
+            //! The packet exactly as it was received.
+            std::vector<Kiaro::Common::U8> mData;
+        };
+
+        /**
+         *  @brief Appends every packet received by a client or server to a demo file, so that the same stream can be fed
+         *  back through onReceivePacket later with a Kiaro::Network::DemoPlayer.
+         *  @details A demo starts with a short header and is followed by one record per packet: the time since the
+         *  previous record, the sender, the packet type and the length, then the packet itself. Everything is written in
+         *  the byte order of the machine recording it.
+         */
+        class DemoRecorder
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor that creates the demo file, replacing anything already there.
+                 *  @param fileName The path of the demo file.
+                 *  @param source What is receiving the packets.
+                 *  @throw std::runtime_error Thrown when the file can't be created.
+                 */
+                DemoRecorder(const std::string &fileName, const Kiaro::Network::DEMO_SOURCE &source);
+
+                //! Standard destructor. Flushes and closes the file.
+                ~DemoRecorder(void);
+
+                /**
+                 *  @brief Appends a received packet.
+                 *  @param sender The port of the client that sent the packet, or 0 on a client.
+                 *  @param data A pointer to the packet.
+                 *  @param length The length of the packet in bytes.
+                 */
+                void record(const Kiaro::Common::U16 &sender, const Kiaro::Common::U8 *data, const Kiaro::Common::U16 &length);
+
+                //! Returns the number of packets recorded.
+                Kiaro::Common::U64 getRecordCount(void) { return mRecordCount; }
+
+            // Private Members
+            private:
+                std::ofstream mFile;
+
+                Kiaro::Common::U64 mStartTime;
+                //! The time of the last record, which the next one is written relative to.
+                Kiaro::Common::U64 mLastTime;
+
+                Kiaro::Common::U64 mRecordCount;
+        };
+
+        //! Reads back the packets of a demo file written by a Kiaro::Network::DemoRecorder, in the order they were received.
+        class DemoPlayer
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor that opens the demo file and reads its header.
+                 *  @param fileName The path of the demo file.
+                 *  @throw std::runtime_error Thrown when the file can't be opened or isn't a demo.
+                 */
+                DemoPlayer(const std::string &fileName);
+
+                //! Standard destructor.
+                ~DemoPlayer(void);
+
+                //! Returns what received the packets in the demo.
+                Kiaro::Network::DEMO_SOURCE getSource(void) { return mSource; }
+
+                /**
+                 *  @brief Reads the next packet.
+                 *  @param out The packet is written here. Its data vector is reused, so passing the same record every time
+                 *  saves on allocations.
+                 *  @return A boolean representing whether or not there was another packet. A record cut short by the end
+                 *  of the file, as the last one may be if recording was interrupted, counts as there being none.
+                 */
+                bool read(Kiaro::Network::DemoRecord &out);
+
+            // Private Members
+            private:
+                std::ifstream mFile;
+
+                Kiaro::Network::DEMO_SOURCE mSource;
+                Kiaro::Common::U64 mLastTime;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_DEMOFILE_HPP_
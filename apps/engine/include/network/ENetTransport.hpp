@@ -0,0 +1,60 @@
+/**
+ *  @file ENetTransport.hpp
+ *  @brief Include file defining the Kiaro::Network::ENetTransport class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_ENETTRANSPORT_HPP_
+#define _INCLUDE_KIARO_NETWORK_ENETTRANSPORT_HPP_
+
+#include <enet/enet.h>
+
+#include <network/Transport.hpp>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        //! Transport that sends over UDP sockets by way of an ENet host.
+        class ENetTransport : public Kiaro::Network::Transport
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor that creates the ENet host.
+                 *  @param address The address to listen on, or NULL for a host that only makes outgoing connections.
+                 *  @param peerCount The maximum number of peers the host may have.
+                 *  @param channelCount The maximum number of channels each peer may use.
+                 *  @param incomingBandwidth The incoming bandwidth limit in bytes per second, or 0 for no limit.
+                 *  @param outgoingBandwidth The outgoing bandwidth limit in bytes per second, or 0 for no limit.
+                 *  @throw std::runtime_error Thrown when the ENet host could not be created.
+                 */
+                ENetTransport(const ENetAddress *address, const size_t &peerCount, const size_t &channelCount, const Kiaro::Common::U32 &incomingBandwidth, const Kiaro::Common::U32 &outgoingBandwidth);
+
+                //! Standard destructor. Destroys the ENet host.
+                ~ENetTransport(void);
+
+                ENetPeer *connect(const ENetAddress &address, const size_t &channelCount);
+                Kiaro::Common::S32 service(ENetEvent &event, const Kiaro::Common::U32 &timeout);
+                Kiaro::Common::S32 send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet);
+                void flush(void);
+                void disconnect(ENetPeer *peer, const bool &now);
+                void reset(ENetPeer *peer);
+                Kiaro::Common::U32 getTime(void);
+
+            // Private Members
+            private:
+                ENetHost *mHost;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_ENETTRANSPORT_HPP_
@@ -17,6 +17,10 @@
 #include <enet/enet.h>
 
 #include <network/ClientBase.hpp>
+#include <network/ClientHandle.hpp>
+#include <network/MessageChannels.hpp>
+#include <network/SnapshotHistory.hpp>
+#include <network/NetworkStatistics.hpp>
 #include "PacketBase.hpp"
 
 namespace Kiaro
@@ -24,6 +28,7 @@ namespace Kiaro
     namespace Support
     {
         class BitStream;
+        class GatherWriter;
     } // End NameSpace Support
 
     namespace Network
@@ -41,7 +46,15 @@ namespace Kiaro
                  */
                 IncomingClientBase(ENetPeer *connecting, Kiaro::Network::ServerBase *server);
 
-                ~IncomingClientBase(void);
+                virtual ~IncomingClientBase(void);
+
+                /**
+                 *  @brief Readies a client object that is done with for the next peer to connect, so that it can be reused
+                 *  rather than deleted and created again.
+                 *  @param connecting The peer that is connecting, or NULL.
+                 *  @note Subclasses that keep state of their own should reset it here as well, and call this.
+                 */
+                virtual void reset(ENetPeer *connecting);
 
                 /**
                  *  @brief Empty callback function for the the OnReceivePacket event.
@@ -49,17 +62,83 @@ namespace Kiaro
                  */
                 void onReceivePacket(Kiaro::Support::BitStream &incomingStream);
 
-                void send(Kiaro::Network::PacketBase *packet, const bool &reliable);
+                /**
+                 *  @brief Queues a packet for this client. It is coalesced with everything else sent in its traffic class
+                 *  this tick and goes out on flush.
+                 *  @param packet The packet to send.
+                 *  @param trafficClass How the packet should be delivered.
+                 */
+                void send(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass);
 
-                bool getIsOppositeEndian(void);
+                //! Queues a packet for this client in the traffic class its type declares.
+                template <typename packetClass>
+                void send(packetClass *packet)
+                {
+                    send(packet, packetClass::sTrafficClass);
+                }
+
+                /**
+                 *  @brief Queues an already serialized packet for this client.
+                 *  @param message A pointer to the serialized packet.
+                 *  @param length The length of the serialized packet in bytes.
+                 *  @param packetType The type of the serialized packet.
+                 *  @param serializeMicroseconds How long serializing the packet took.
+                 *  @param trafficClass How the packet should be delivered.
+                 */
+                void send(const void *message, const Kiaro::Common::U32 &length, const Kiaro::Common::U32 &packetType,
+                const Kiaro::Common::U64 &serializeMicroseconds, Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+                /**
+                 *  @brief Queues a packet composed with a Kiaro::Support::GatherWriter for this client.
+                 *  @param message The composed packet, which is gathered straight into what goes out to ENet.
+                 *  @param packetType The type of the composed packet.
+                 *  @param trafficClass How the packet should be delivered.
+                 */
+                void send(Kiaro::Support::GatherWriter &message, const Kiaro::Common::U32 &packetType, Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+                //! Hands everything queued for this client over to ENet, or to the server's network thread if it has one.
+                void flush(void);
 
                 void disconnect(void);
 
                 Kiaro::Common::U16 getPort(void);
 
+                //! Returns the ENet peer this client is connected through, or NULL if it has none.
+                ENetPeer *getPeer(void) { return mInternalClient; }
+
+                //! Returns the handle of the slot this client is in on its server, or an invalid handle if it isn't in one.
+                const Kiaro::Network::ClientHandle &getHandle(void) { return mHandle; }
+
+                void setHandle(const Kiaro::Network::ClientHandle &handle) { mHandle = handle; }
+
+                //! Returns the connection stage this client is in, which decides what packets it may send.
+                Kiaro::Common::U8 getStage(void) { return mCurrentStage; }
+
+                void setStage(const Kiaro::Common::U8 &stage) { mCurrentStage = stage; }
+
+                //! Returns the snapshots that have been sent to this client and which of them it has acknowledged.
+                Kiaro::Network::SnapshotHistory &getSnapshotHistory(void) { return mSnapshotHistory; }
+
+                //! Returns the traffic counted on this client's connection.
+                Kiaro::Network::NetworkStatistics &getStatistics(void) { return mStatistics; }
+
+                /**
+                 *  @brief Closes off the current statistics window and takes a reading of the link from ENet.
+                 *  @return The statistics that were sampled.
+                 */
+                const Kiaro::Network::NetworkStatistics &sampleStatistics(void);
+
             private:
-                bool mIsOppositeEndian;
+                Kiaro::Common::U8 mCurrentStage;
                 ENetPeer *mInternalClient;
+                Kiaro::Network::ServerBase *mServer;
+                Kiaro::Network::ClientHandle mHandle;
+
+                Kiaro::Network::NetworkStatistics mStatistics;
+
+                Kiaro::Network::MessageChannels mMessageChannels;
+
+                Kiaro::Network::SnapshotHistory mSnapshotHistory;
         };
     } // End Namespace Network
 } // End Namespace Kiaro
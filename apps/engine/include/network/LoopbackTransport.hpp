@@ -0,0 +1,205 @@
+/**
+ *  @file LoopbackTransport.hpp
+ *  @brief Include file defining the Kiaro::Network::LoopbackNetwork and Kiaro::Network::LoopbackTransport classes.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_LOOPBACKTRANSPORT_HPP_
+#define _INCLUDE_KIARO_NETWORK_LOOPBACKTRANSPORT_HPP_
+
+#include <map>
+#include <vector>
+#include <random>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <enet/enet.h>
+
+#include <network/Transport.hpp>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        class LoopbackTransport;
+
+        //! The conditions that a Kiaro::Network::LoopbackNetwork puts packets through, in each direction.
+        struct LinkConditions
+        {
+            //! Standard constructor. The default conditions are a perfect link.
+            LinkConditions(void) : mLatency(0), mJitter(0), mLoss(0.0f), mReorder(0.0f), mBandwidth(0) { }
+
+            //! The time in milliseconds that a packet takes to arrive.
+            Kiaro::Common::U32 mLatency;
+            //! Up to this many milliseconds are added on top of mLatency at random.
+            Kiaro::Common::U32 mJitter;
+            //! The chance from 0 to 1 that a packet is lost. Lost reliable packets arrive a round trip late instead.
+            Kiaro::Common::F32 mLoss;
+            //! The chance from 0 to 1 that an unreliable packet is held back for mLatency so that later packets overtake it.
+            Kiaro::Common::F32 mReorder;
+            //! The number of bytes per second that each end may send, or 0 for no limit.
+            Kiaro::Common::U32 mBandwidth;
+        };
+
+        /**
+         *  @brief A simulated network that Kiaro::Network::LoopbackTransport instances in the same process talk through.
+         *  @details Every random decision is drawn from a generator seeded at construction and the clock may be simulated,
+         *  so a run with the same seed and the same calls always plays out the same way. With a simulated clock, time only
+         *  moves on when advance is called or when a transport waits in service. Transports may be serviced from different
+         *  threads, but a simulated clock only makes sense when they are all serviced from one.
+         */
+        class LoopbackNetwork
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the random seed and how time is kept.
+                 *  @param seed The seed for the random decisions made about each packet.
+                 *  @param simulatedTime A boolean representing whether to keep a simulated clock rather than use wall time.
+                 */
+                LoopbackNetwork(const Kiaro::Common::U32 &seed, const bool &simulatedTime = true);
+
+                //! Standard destructor. Every transport on this network must have been destroyed first.
+                ~LoopbackNetwork(void);
+
+                //! Sets the conditions that packets sent from now on are put through.
+                void setConditions(const Kiaro::Network::LinkConditions &conditions);
+
+                //! Returns the conditions that packets are put through.
+                Kiaro::Network::LinkConditions getConditions(void);
+
+                //! Returns the current time of this network in milliseconds.
+                Kiaro::Common::U64 getTime(void);
+
+                /**
+                 *  @brief Moves the simulated clock forward. Does nothing when using wall time.
+                 *  @param milliseconds The number of milliseconds to move forward by.
+                 */
+                void advance(const Kiaro::Common::U32 &milliseconds);
+
+            // Private Methods
+            private:
+                friend class Kiaro::Network::LoopbackTransport;
+
+                //! The state of one end of a connection.
+                struct PeerState
+                {
+                    //! The transport that this end belongs to.
+                    Kiaro::Network::LoopbackTransport *mOwner;
+                    //! The other end of the connection, or NULL once it has gone away.
+                    ENetPeer *mRemote;
+
+                    //! The time at which this end is told of the connection. Nothing sent to it may arrive earlier.
+                    Kiaro::Common::U64 mConnectTime;
+                    //! The time at which everything sent from this end so far has made it onto the link.
+                    Kiaro::Common::U64 mLinkFreeTime;
+                    //! The arrival time of the last reliable packet sent on each channel, which later ones may not beat.
+                    std::map<Kiaro::Common::U8, Kiaro::Common::U64> mReliableArrivalTimes;
+                };
+
+                void bind(Kiaro::Network::LoopbackTransport *transport);
+                void unbind(Kiaro::Network::LoopbackTransport *transport);
+
+                ENetPeer *connect(Kiaro::Network::LoopbackTransport *transport, const ENetAddress &address, const size_t &channelCount);
+                Kiaro::Common::S32 service(Kiaro::Network::LoopbackTransport *transport, ENetEvent &event, const Kiaro::Common::U32 &timeout);
+                Kiaro::Common::S32 send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet);
+                void disconnect(ENetPeer *peer, const bool &now);
+                void reset(ENetPeer *peer);
+
+                //! Creates one end of a connection owned by the given transport.
+                ENetPeer *createPeer(Kiaro::Network::LoopbackTransport *owner, const Kiaro::Common::U16 &remotePort, const Kiaro::Common::U32 &connectID);
+
+                //! Queues an event for the given peer's owner to receive at the given time.
+                void deliver(ENetPeer *peer, const ENetEventType &type, ENetPacket *packet, const Kiaro::Common::U8 &channel, const Kiaro::Common::U64 &time);
+
+                //! Returns the time that a packet sent now takes to cross the link, not counting bandwidth.
+                Kiaro::Common::U64 getTravelTime(void);
+
+                //! Returns a random number from 0 to 1.
+                Kiaro::Common::F32 getRandomChance(void);
+
+                //! Returns the current time. mMutex must be held.
+                Kiaro::Common::U64 getTimeLocked(void);
+
+            // Private Members
+            private:
+                boost::mutex mMutex;
+
+                Kiaro::Network::LinkConditions mConditions;
+                std::mt19937 mRandom;
+
+                const bool mSimulatedTime;
+                Kiaro::Common::U64 mTime;
+                boost::posix_time::ptime mStartTime;
+
+                Kiaro::Common::U32 mNextConnectID;
+                //! Transports that don't listen on a port are given one from here.
+                Kiaro::Common::U16 mNextEphemeralPort;
+                //! The number of events ever queued, which keeps events that arrive at the same time in order.
+                Kiaro::Common::U64 mDeliveryCount;
+
+                std::map<Kiaro::Common::U16, Kiaro::Network::LoopbackTransport *> mTransports;
+                std::map<ENetPeer *, PeerState> mPeerStates;
+        };
+
+        /**
+         *  @brief Transport that sends through a Kiaro::Network::LoopbackNetwork in the same process rather than over
+         *  sockets, for testing and benchmarking the full packet path on one machine.
+         *  @details Packets accepted by send are handed to the receiving end as they are rather than copied.
+         */
+        class LoopbackTransport : public Kiaro::Network::Transport
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the network to join.
+                 *  @param network The network to join. It must outlive this LoopbackTransport.
+                 *  @param port The port to listen on, or 0 for a transport that only makes outgoing connections.
+                 *  @throw std::runtime_error Thrown when the port is already in use on the network.
+                 */
+                LoopbackTransport(Kiaro::Network::LoopbackNetwork *network, const Kiaro::Common::U16 &port = 0);
+
+                //! Standard destructor. The remote ends of any connections are told of a disconnect.
+                ~LoopbackTransport(void);
+
+                //! Returns the port this transport is known by on its network.
+                Kiaro::Common::U16 getPort(void) { return mPort; }
+
+                ENetPeer *connect(const ENetAddress &address, const size_t &channelCount);
+                Kiaro::Common::S32 service(ENetEvent &event, const Kiaro::Common::U32 &timeout);
+                Kiaro::Common::S32 send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet);
+                void flush(void) { }
+                void disconnect(ENetPeer *peer, const bool &now);
+                void reset(ENetPeer *peer);
+
+                //! Returns the network's time.
+                Kiaro::Common::U32 getTime(void);
+
+            // Private Members
+            private:
+                friend class Kiaro::Network::LoopbackNetwork;
+
+                //! The key events are ordered by: the time they arrive at, then the order they were queued in.
+                typedef std::pair<Kiaro::Common::U64, Kiaro::Common::U64> DeliveryKey;
+
+                Kiaro::Network::LoopbackNetwork *mNetwork;
+                Kiaro::Common::U16 mPort;
+
+                //! Every peer this transport has created. They stay valid until the transport is destroyed, as ENet's do.
+                std::vector<ENetPeer *> mPeers;
+                //! Events on their way to this transport.
+                std::map<DeliveryKey, ENetEvent> mIncomingEvents;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_LOOPBACKTRANSPORT_HPP_
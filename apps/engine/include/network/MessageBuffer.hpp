@@ -0,0 +1,135 @@
+/**
+ *  @file MessageBuffer.hpp
+ *  @brief Include file defining the Kiaro::Network::MessageBuffer class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_MESSAGEBUFFER_HPP_
+#define _INCLUDE_KIARO_NETWORK_MESSAGEBUFFER_HPP_
+
+#include <vector>
+
+#include <enet/enet.h>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        class GatherWriter;
+    } // End NameSpace Support
+
+    namespace Network
+    {
+        class PacketBase;
+        class Transport;
+        class NetworkStatistics;
+
+        /**
+         *  @brief Coalesces the packets sent to one peer on one channel into as few ENet packets as possible.
+         *  @details Each packet is serialized straight into the ENet packet under construction, behind a Kiaro::Common::U16
+         *  length prefix. An ENet packet is closed off once the next message would take it past NETWORK_MESSAGE_BUFFER_SIZE
+         *  bytes, and everything is handed to ENet on flush, which normally happens once per tick. Every ENet packet the
+         *  engine sends is made up this way, so received ENet packets are always taken apart with split.
+         */
+        class MessageBuffer
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the channel and the ENet packet flags to send with.
+                 *  @param channel The ENet channel that the messages are sent on.
+                 *  @param packetFlags The ENet packet flags that the messages are sent with.
+                 *  @param statistics Where to count the messages appended and the ENet packets sent, or NULL.
+                 */
+                MessageBuffer(const Kiaro::Common::U8 &channel, const Kiaro::Common::U32 &packetFlags, Kiaro::Network::NetworkStatistics *statistics = NULL);
+
+                //! Standard destructor. Any messages that were never flushed are discarded.
+                ~MessageBuffer(void);
+
+                /**
+                 *  @brief Serializes a packet onto the end of the buffer.
+                 *  @param packet The packet to serialize.
+                 */
+                void append(Kiaro::Network::PacketBase *packet);
+
+                /**
+                 *  @brief Copies an already serialized message onto the end of the buffer.
+                 *  @param message A pointer to the serialized message.
+                 *  @param length The length of the message in bytes.
+                 *  @param packetType The type of packet the message holds, for the statistics.
+                 *  @param serializeMicroseconds How long serializing the message took, for the statistics.
+                 *  @throw std::runtime_error Thrown when the message is too long for its length prefix.
+                 */
+                void append(const void *message, const Kiaro::Common::U32 &length, const Kiaro::Common::U32 &packetType,
+                const Kiaro::Common::U64 &serializeMicroseconds);
+
+                /**
+                 *  @brief Gathers a message composed elsewhere straight into the ENet packet under construction, so that
+                 *  whatever it references is copied exactly once.
+                 *  @param message The composed message.
+                 *  @param packetType The type of packet the message holds, for the statistics.
+                 *  @throw std::runtime_error Thrown when the message is too long for its length prefix.
+                 */
+                void append(Kiaro::Support::GatherWriter &message, const Kiaro::Common::U32 &packetType);
+
+                /**
+                 *  @brief Sends everything that has been appended since the last flush.
+                 *  @param transport The transport that the peer belongs to.
+                 *  @param peer The ENet peer to send to.
+                 */
+                void flush(Kiaro::Network::Transport *transport, ENetPeer *peer);
+
+                //! Discards everything that has been appended since the last flush.
+                void clear(void);
+
+                //! Returns whether or not anything has been appended since the last flush.
+                bool empty(void) { return !mCurrentPacket && mPendingPackets.empty(); }
+
+                /**
+                 *  @brief Splits a received ENet packet into the messages that were coalesced into it, front to back.
+                 *  @param data A pointer to the received data.
+                 *  @param length The length of the received data in bytes.
+                 *  @param out A vector to append the offset and length of each message to, in the order they were sent.
+                 *  @return A boolean representing whether or not the data was well formed. Messages found before any malformed
+                 *  data are still appended to out.
+                 */
+                static bool split(const Kiaro::Common::U8 *data, const size_t &length, std::vector<std::pair<size_t, Kiaro::Common::U16> > &out);
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Makes sure that the ENet packet under construction has room for the given number of bytes.
+                 *  @return A pointer to where those bytes should be written.
+                 */
+                Kiaro::Common::U8 *reserve(const size_t &length);
+
+                //! Closes off the ENet packet under construction so that it is sent on the next flush.
+                void closePacket(void);
+
+            // Private Members
+            private:
+                const Kiaro::Common::U8 mChannel;
+                const Kiaro::Common::U32 mPacketFlags;
+
+                Kiaro::Network::NetworkStatistics *mStatistics;
+
+                //! The ENet packet that messages are currently being appended to, if any.
+                ENetPacket *mCurrentPacket;
+                //! The number of bytes of mCurrentPacket that are in use.
+                size_t mCurrentLength;
+
+                //! ENet packets that filled up since the last flush.
+                std::vector<ENetPacket *> mPendingPackets;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_MESSAGEBUFFER_HPP_
@@ -0,0 +1,105 @@
+/**
+ *  @file MessageChannels.hpp
+ *  @brief Include file defining the Kiaro::Network::MessageChannels class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_MESSAGECHANNELS_HPP_
+#define _INCLUDE_KIARO_NETWORK_MESSAGECHANNELS_HPP_
+
+#include <enet/enet.h>
+
+#include "engine/Common.hpp"
+#include <network/PacketBase.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        class GatherWriter;
+    } // End NameSpace Support
+
+    namespace Network
+    {
+        class MessageBuffer;
+        class Transport;
+        class NetworkStatistics;
+
+        /**
+         *  @brief Everything queued for one peer, with a Kiaro::Network::MessageBuffer for each traffic class.
+         *  @details Each traffic class is sent on the ENet channel with the same number, with the flags that give it its
+         *  delivery guarantees. ENet orders reliable packets per channel and holds unreliable ones behind the reliable
+         *  packets of their own channel only, so keeping the classes apart is what stops a lost reliable packet from
+         *  stalling the rest of the traffic.
+         */
+        class MessageChannels
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Standard constructor.
+                 *  @param statistics Where to count the messages appended and the ENet packets sent, or NULL.
+                 */
+                MessageChannels(Kiaro::Network::NetworkStatistics *statistics = NULL);
+
+                //! Standard destructor. Any messages that were never flushed are discarded.
+                ~MessageChannels(void);
+
+                /**
+                 *  @brief Serializes a packet onto the end of the buffer for the given traffic class.
+                 *  @param packet The packet to serialize.
+                 *  @param trafficClass How the packet should be delivered.
+                 */
+                void append(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+                /**
+                 *  @brief Copies an already serialized message onto the end of the buffer for the given traffic class.
+                 *  @param message A pointer to the serialized message.
+                 *  @param length The length of the message in bytes.
+                 *  @param packetType The type of packet the message holds.
+                 *  @param serializeMicroseconds How long serializing the message took.
+                 *  @param trafficClass How the message should be delivered.
+                 *  @throw std::runtime_error Thrown when the message is too long for its length prefix.
+                 */
+                void append(const void *message, const Kiaro::Common::U32 &length, const Kiaro::Common::U32 &packetType,
+                const Kiaro::Common::U64 &serializeMicroseconds, Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+                /**
+                 *  @brief Gathers a composed message onto the end of the buffer for the given traffic class.
+                 *  @param message The composed message.
+                 *  @param packetType The type of packet the message holds.
+                 *  @param trafficClass How the message should be delivered.
+                 *  @throw std::runtime_error Thrown when the message is too long for its length prefix.
+                 */
+                void append(Kiaro::Support::GatherWriter &message, const Kiaro::Common::U32 &packetType, Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+                /**
+                 *  @brief Sends everything that has been appended since the last flush, one traffic class at a time.
+                 *  @param transport The transport that the peer belongs to.
+                 *  @param peer The ENet peer to send to.
+                 */
+                void flush(Kiaro::Network::Transport *transport, ENetPeer *peer);
+
+                //! Discards everything that has been appended since the last flush.
+                void clear(void);
+
+                /**
+                 *  @brief Returns the ENet packet flags a traffic class is sent with.
+                 *  @param trafficClass The traffic class.
+                 */
+                static Kiaro::Common::U32 getPacketFlags(Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+            // Private Members
+            private:
+                Kiaro::Network::MessageBuffer *mBuffers[Kiaro::Network::TRAFFIC_CLASS_COUNT];
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_MESSAGECHANNELS_HPP_
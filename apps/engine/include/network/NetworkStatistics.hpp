@@ -0,0 +1,148 @@
+/**
+ *  @file NetworkStatistics.hpp
+ *  @brief Include file defining the Kiaro::Network::NetworkStatistics class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_NETWORKSTATISTICS_HPP_
+#define _INCLUDE_KIARO_NETWORK_NETWORKSTATISTICS_HPP_
+
+#include <string>
+#include <ostream>
+
+#include <enet/enet.h>
+
+#include "engine/Common.hpp"
+#include <engine/Config.hpp>
+
+#include <network/Transport.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        /**
+         *  @brief Counts the traffic on one connection: ENet packets and bytes each way, the messages coalesced into them
+         *  broken down by packet type, and what ENet itself reports about the link.
+         *  @details Everything is counted both in running totals and in a window that sample closes off, so that rates can
+         *  be worked out over however long the caller samples at. Messages that were serialized elsewhere and handed over
+         *  as bytes count towards the totals but not towards any packet type.
+         */
+        class NetworkStatistics
+        {
+            // Public Methods
+            public:
+                //! Counts of traffic, either in total or over a window.
+                struct Counters
+                {
+                    //! ENet packets sent and received.
+                    Kiaro::Common::U64 mPacketsSent;
+                    Kiaro::Common::U64 mPacketsReceived;
+                    //! Bytes of ENet packets sent and received, not counting ENet's own headers.
+                    Kiaro::Common::U64 mBytesSent;
+                    Kiaro::Common::U64 mBytesReceived;
+                    //! Messages coalesced into the ENet packets.
+                    Kiaro::Common::U64 mMessagesSent;
+                    Kiaro::Common::U64 mMessagesReceived;
+                };
+
+                //! Counts for a single packet type.
+                struct PacketTypeCounters
+                {
+                    Kiaro::Common::U64 mSentCount;
+                    Kiaro::Common::U64 mSentBytes;
+                    //! Time spent packing messages of this type.
+                    Kiaro::Common::U64 mSerializeMicroseconds;
+
+                    Kiaro::Common::U64 mReceivedCount;
+                    Kiaro::Common::U64 mReceivedBytes;
+                    //! Time spent unpacking and handling messages of this type.
+                    Kiaro::Common::U64 mDispatchMicroseconds;
+                };
+
+                //! Standard constructor. Everything starts at zero and the first window starts now.
+                NetworkStatistics(void);
+
+                /**
+                 *  @brief Counts a message that was serialized for sending.
+                 *  @param packetType The type of the packet.
+                 *  @param length The length of the message in bytes.
+                 *  @param serializeMicroseconds How long packing it took.
+                 */
+                void recordMessageSent(const Kiaro::Common::U32 &packetType, const Kiaro::Common::U32 &length, const Kiaro::Common::U64 &serializeMicroseconds);
+
+                /**
+                 *  @brief Counts a received message that was handed to its handler.
+                 *  @param packetType The type of the packet.
+                 *  @param length The length of the message in bytes.
+                 *  @param dispatchMicroseconds How long unpacking and handling it took.
+                 */
+                void recordMessageReceived(const Kiaro::Common::U32 &packetType, const Kiaro::Common::U32 &length, const Kiaro::Common::U64 &dispatchMicroseconds);
+
+                //! Counts an ENet packet handed to the transport.
+                void recordPacketSent(const Kiaro::Common::U32 &length);
+
+                //! Counts an ENet packet received from the transport.
+                void recordPacketReceived(const Kiaro::Common::U32 &length);
+
+                /**
+                 *  @brief Closes off the current window, which began at the previous sample or at construction, and takes a
+                 *  reading of what ENet reports about the link.
+                 *  @param link The reading of the link, as taken by Kiaro::Network::Transport::sampleLink, or NULL if there
+                 *  is none right now. The last reading is kept if there is none.
+                 */
+                void sample(const Kiaro::Network::LinkStatistics *link);
+
+                //! Returns the running totals.
+                const Counters &getTotals(void) const { return mTotals; }
+                //! Returns the counts over the window closed off by the last sample.
+                const Counters &getLastWindow(void) const { return mLastWindow; }
+                //! Returns the length of the window closed off by the last sample in microseconds.
+                Kiaro::Common::U64 getLastWindowLength(void) const { return mLastWindowLength; }
+
+                //! Returns the running totals for a packet type.
+                const PacketTypeCounters &getPacketTypeCounters(const Kiaro::Common::U32 &packetType) const { return mPacketTypes[packetType]; }
+
+                //! Returns the round trip time in milliseconds as of the last sample.
+                Kiaro::Common::U32 getRoundTripTime(void) const { return mRoundTripTime; }
+                //! Returns the round trip time variance in milliseconds as of the last sample.
+                Kiaro::Common::U32 getRoundTripTimeVariance(void) const { return mRoundTripTimeVariance; }
+                //! Returns the fraction of packets from 0 to 1 that ENet believes are being lost, as of the last sample.
+                Kiaro::Common::F32 getPacketLoss(void) const { return mPacketLoss; }
+                //! Returns the number of reliable bytes sent but not yet acknowledged, as of the last sample.
+                Kiaro::Common::U32 getReliableBytesInTransit(void) const { return mReliableBytesInTransit; }
+
+                /**
+                 *  @brief Writes the last window's rates, the link readings and every packet type seen to a stream.
+                 *  @param out The stream to write to.
+                 *  @param name What to call the connection in the output.
+                 */
+                void write(std::ostream &out, const std::string &name) const;
+
+            // Private Members
+            private:
+                Counters mTotals;
+                //! The counts since the last sample.
+                Counters mWindow;
+                Counters mLastWindow;
+
+                Kiaro::Common::U64 mWindowStartTime;
+                Kiaro::Common::U64 mLastWindowLength;
+
+                PacketTypeCounters mPacketTypes[NETWORK_MAXIMUM_PACKET_TYPES];
+
+                Kiaro::Common::U32 mRoundTripTime;
+                Kiaro::Common::U32 mRoundTripTimeVariance;
+                Kiaro::Common::F32 mPacketLoss;
+                Kiaro::Common::U32 mReliableBytesInTransit;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_NETWORKSTATISTICS_HPP_
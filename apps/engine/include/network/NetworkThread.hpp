@@ -0,0 +1,176 @@
+/**
+ *  @file NetworkThread.hpp
+ *  @brief Include file defining the Kiaro::Network::NetworkThread class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_NETWORKTHREAD_HPP_
+#define _INCLUDE_KIARO_NETWORK_NETWORKTHREAD_HPP_
+
+#include <map>
+#include <vector>
+#include <atomic>
+
+#include <boost/thread/thread.hpp>
+
+#include <enet/enet.h>
+
+#include <network/Transport.hpp>
+
+#include <support/RingBuffer.hpp>
+
+#include "engine/Common.hpp"
+#include <engine/Config.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        /**
+         *  @brief Services a transport on a thread of its own, so that ENet keeps acknowledging and resending while the
+         *  simulation is busy with a tick.
+         *  @details Once started, the thread is the only thing that touches the transport it wraps. Events it produces are
+         *  queued for the simulation thread to pick up with service, and packets handed to send or peers handed to
+         *  disconnect and reset are queued for the network thread to carry out. Both queues are Kiaro::Support::RingBuffer
+         *  instances, so the simulation thread must be the only one calling into this class.
+         *
+         *  Peers are only ever read on the network thread. A peer's connectID is recorded when its connect event is
+         *  handed over. Everything queued for the peer is stamped with that recorded value, so anything meant for a
+         *  connection that has since been replaced is dropped.
+         */
+        class NetworkThread : public Kiaro::Network::Transport
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the transport to service. The thread starts right away.
+                 *  @param transport The transport to service. It must outlive this NetworkThread.
+                 *  @param connectedPeers Peers that were already connected on the transport, and so will never have a
+                 *  connect event handed over.
+                 */
+                NetworkThread(Kiaro::Network::Transport *transport, const std::vector<ENetPeer *> &connectedPeers = std::vector<ENetPeer *>());
+
+                //! Standard destructor. Stops the thread if it is still running.
+                ~NetworkThread(void);
+
+                /**
+                 *  @brief Stops the thread once it has carried out everything that was queued for it, and then discards any
+                 *  events that were never picked up. Afterwards the transport may be used directly again.
+                 */
+                void stop(void);
+
+                //! Connections can't be started through the network thread, so this always returns NULL.
+                ENetPeer *connect(const ENetAddress &address, const size_t &channelCount);
+
+                /**
+                 *  @brief Pops the oldest event that the transport has produced.
+                 *  @param event The event is written here.
+                 *  @param timeout Ignored; this never waits.
+                 *  @return 1 if there was an event to pop, 0 otherwise.
+                 */
+                Kiaro::Common::S32 service(ENetEvent &event, const Kiaro::Common::U32 &timeout);
+
+                //! Queues a packet to be sent by the network thread. This always accepts the packet.
+                Kiaro::Common::S32 send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet);
+
+                //! Does nothing, as the network thread sends whatever it is given as soon as it gets to it.
+                void flush(void) { }
+
+                //! Queues a disconnect of a peer for the network thread to carry out.
+                void disconnect(ENetPeer *peer, const bool &now);
+
+                //! Queues a reset of a peer for the network thread to carry out.
+                void reset(ENetPeer *peer);
+
+                //! Returns the time of the transport being serviced.
+                Kiaro::Common::U32 getTime(void);
+
+                /**
+                 *  @brief Asks the network thread for a reading of a peer's link, and returns the latest one it has sent back.
+                 *  @details ENet updates the peer while it services it, so the reading is taken on the network thread. The
+                 *  reading returned is the one taken for the previous request, so it lags one sample behind.
+                 *  @return True if a reading was written, false if none has come back for this connection yet.
+                 */
+                bool sampleLink(ENetPeer *peer, Kiaro::Network::LinkStatistics &link);
+
+            // Private Methods
+            private:
+                //! The loop that the network thread runs.
+                void run(void);
+
+            // Private Members
+            private:
+                //! A request from the simulation thread for the network thread to carry out.
+                struct Command
+                {
+                    enum COMMAND_TYPE
+                    {
+                        COMMAND_SEND = 0,
+                        COMMAND_DISCONNECT = 1,
+                        COMMAND_DISCONNECT_NOW = 2,
+                        COMMAND_RESET = 3,
+                        COMMAND_SAMPLE = 4,
+                    };
+
+                    Kiaro::Common::U8 mType;
+                    Kiaro::Common::U8 mChannel;
+
+                    ENetPeer *mPeer;
+                    //! The connectID of mPeer when this was queued, so that nothing reaches a peer that was since reused.
+                    enet_uint32 mConnectID;
+
+                    ENetPacket *mPacket;
+                };
+
+                //! An event produced by the transport, along with what the network thread read off its peer.
+                struct Event
+                {
+                    ENetEvent mEvent;
+                    //! The connectID of the event's peer, for connect events.
+                    enet_uint32 mConnectID;
+                };
+
+                //! A reading of a peer's link taken on the network thread.
+                struct LinkSample
+                {
+                    ENetPeer *mPeer;
+                    Kiaro::Network::LinkStatistics mLink;
+                };
+
+                /**
+                 *  @brief Stamps a command for a peer with the peer's connectID as it was handed over, and queues it.
+                 *  @return False if the peer never connected through this thread, in which case nothing was queued.
+                 */
+                bool pushCommand(Command &command, ENetPeer *peer);
+
+                //! Queues a command, waiting for room if the network thread has fallen behind.
+                void pushCommand(const Command &command);
+
+                //! Carries out a command on the network thread.
+                void execute(Command &command);
+
+                Kiaro::Network::Transport *mTransport;
+
+                std::atomic<bool> mIsRunning;
+                boost::thread mThread;
+
+                Kiaro::Support::RingBuffer<Command, NETWORK_THREAD_QUEUE_LENGTH> mOutgoingCommands;
+                Kiaro::Support::RingBuffer<Event, NETWORK_THREAD_QUEUE_LENGTH> mIncomingEvents;
+
+                //! The connectID of every peer as it was when its connection was handed over. Only the simulation thread uses it.
+                std::map<ENetPeer *, enet_uint32> mConnectIDs;
+
+                Kiaro::Support::RingBuffer<LinkSample, NETWORK_THREAD_QUEUE_LENGTH> mLinkSamples;
+                //! The latest reading the network thread has sent back for each peer. Only the simulation thread uses it.
+                std::map<ENetPeer *, Kiaro::Network::LinkStatistics> mLinks;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_NETWORKTHREAD_HPP_
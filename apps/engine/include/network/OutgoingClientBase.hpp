@@ -17,47 +17,89 @@
 #include <enet/enet.h>
 
 #include <engine/Common.hpp>
+#include <engine/Config.hpp>
 #include "PacketBase.hpp"
+#include "MessageChannels.hpp"
+#include "NetworkStatistics.hpp"
 
 namespace Kiaro
 {
 	namespace Network
 	{
+        class NetworkThread;
+        class Transport;
+        class DemoRecorder;
+        struct DemoRecord;
+
+        //! An enumeration representing where an outgoing connection is at.
+        enum CONNECTION_STATE
+        {
+            //! There is no connection and none is being made.
+            CONNECTION_DISCONNECTED = 0,
+            //! Waiting for the server to accept the connection.
+            CONNECTION_CONNECTING = 1,
+            CONNECTION_CONNECTED = 2,
+            //! Waiting for the server to acknowledge a graceful disconnect.
+            CONNECTION_DISCONNECTING = 3,
+        }; // End Enum CONNECTION_STATE
+
         //! Class representing outgoing connections.
 		class OutgoingClientBase
 		{
             // Public Methods
 			public:
                 /**
-                 *  @brief Sends arbitrary data to the remote server this Client is connected to.
-                 *  @param size A u32 specifying the size of data in bytes.
-                 *  @param data An arbitrary pointer to the data to be sending.
-                 *  @param reliable A boolean representing whether or not this packet should be reliable. A reliable packet is slower than an unreliable packet.
+                 *  @brief Queues a packet for the remote server this Client is connected to. It is coalesced with everything else sent
+                 *  in its traffic class this tick and goes out on dispatch.
+                 *  @param packet The packet to send.
+                 *  @param trafficClass How the packet should be delivered.
                  */
-                void send(Kiaro::Network::PacketBase *packet, const bool &reliable);
+                void send(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+                //! Queues a packet for the remote server in the traffic class its type declares.
+                template <typename packetClass>
+                void send(packetClass *packet)
+                {
+                    send(packet, packetClass::sTrafficClass);
+                }
 
                 /**
                  *	@brief If the client is not already connected somewhere, this tells them to connect to some server.
                  *  @param target_address A chararacter array representing the address to connect to in decimal form. This may also be a hostname. Eg: www.blah.com
                  *  @param target_port A u16 representing the UDP port to attempt to connect on.
-                 *  @param wait A u32 representing the time in milliseconds to wait for. This is a blocking operation.
-                 *  @note This is a blocking call, the amount of time it blocks depends on the wait variable which can be 0 for no wait.
+                 *  @param timeout A u32 representing the time in milliseconds to wait on each attempt.
+                 *  @param attempts A u32 representing the number of attempts to make before giving up.
+                 *  @note This doesn't block. The connection is made over the following calls to update, which end up calling
+                 *  either onConnected or onConnectFailed.
+                 */
+                void connect(const std::string &targetAddress, const Kiaro::Common::U16 &targetPort, const Kiaro::Common::U32 &timeout = NETWORK_CONNECT_TIMEOUT,
+                const Kiaro::Common::U32 &attempts = NETWORK_CONNECT_ATTEMPTS);
+
+                /**
+                 *	@brief If the client is not already connected somewhere, this tells them to connect to some server through
+                 *  the given transport.
+                 *  @param transport The transport to connect through. The client takes ownership of it.
+                 *  @param address The address of the server to connect to.
+                 *  @param timeout A u32 representing the time in milliseconds to wait on each attempt, by the transport's clock.
+                 *  @param attempts A u32 representing the number of attempts to make before giving up.
                  */
-                void connect(const std::string &targetAddress, const Kiaro::Common::U16 &targetPort, const Kiaro::Common::U32 &wait = 5000);
+                void connect(Kiaro::Network::Transport *transport, const ENetAddress &address, const Kiaro::Common::U32 &timeout = NETWORK_CONNECT_TIMEOUT,
+                const Kiaro::Common::U32 &attempts = NETWORK_CONNECT_ATTEMPTS);
 
                 /**
-                 *  @brief Causes a network client to disconnect from its server.
-                 *  @param wait A u32 representing the amount of time in milliseconds to wait for a registered disconnect.
-                 *  @note This is a blocking call, the amount of time it blocks depends on the wait variable which can be 0 for no wait.
+                 *  @brief Causes a network client to disconnect from its server. A connection that is still being made is
+                 *  abandoned right away; an established one is closed gracefully over the following calls to update, which
+                 *  end up calling onDisconnected.
                  */
-                void disconnect(const Kiaro::Common::U32 wait = 5000);
+                void disconnect(void);
 
                 /**
-                 *  @brief Updates the state of this Kiaro::Network::Client.
+                 *  @brief Updates the state of this Kiaro::Network::Client, handling everything received and timing out
+                 *  connects and disconnects that are taking too long.
                  */
                 void update(void);
 
-                //! Causes the client to handle all queued network events immediately.
+                //! Hands every queued message over to ENet and sends them immediately. This should be called once per tick.
                 void dispatch(void);
 
                 //! Callback function that is called upon the client's connection being accepted by the server's underlaying network subsystem.
@@ -71,6 +113,43 @@ namespace Kiaro
 
                 bool isConnected(void);
 
+                Kiaro::Network::CONNECTION_STATE getConnectionState(void) { return mConnectionState; }
+
+                /**
+                 *  @brief Sets whether or not the transport is handed over to a network thread of its own once a connection
+                 *  is established. This only takes effect on the next call to connect.
+                 *  @param usesNetworkThread A boolean representing whether or not to use a network thread.
+                 */
+                void setUsesNetworkThread(const bool &usesNetworkThread) { mUsesNetworkThread = usesNetworkThread; }
+
+                //! Returns the traffic counted on the current connection, or on the last one if there is none.
+                Kiaro::Network::NetworkStatistics &getStatistics(void) { return mStatistics; }
+
+                /**
+                 *  @brief Closes off the current statistics window and takes a reading of the link from ENet.
+                 *  @return The statistics that were sampled.
+                 */
+                const Kiaro::Network::NetworkStatistics &sampleStatistics(void);
+
+                /**
+                 *  @brief Starts appending every packet received from the server to a demo file, replacing any recording
+                 *  already going on. Recording carries on across connections.
+                 *  @param fileName The path of the demo file.
+                 *  @throw std::runtime_error Thrown when the file can't be created.
+                 */
+                void startRecording(const std::string &fileName);
+
+                //! Stops recording, if recording.
+                void stopRecording(void);
+
+                /**
+                 *  @brief Feeds a packet from a client demo through onReceivePacket as if the server had just sent it.
+                 *  @param record The packet to feed.
+                 *  @note This is meant for a client that isn't connected. Anything the handlers queue to be sent in
+                 *  response is thrown away.
+                 */
+                void replay(const Kiaro::Network::DemoRecord &record);
+
                 /**
                  *  @brief Constructor accepting an incoming client connection.
                  *  @param connecting A void* pointer representing a client connection.
@@ -82,14 +161,47 @@ namespace Kiaro
                 //! Standard destructor.
                 ~OutgoingClientBase(void);
 
+            // Protected Methods
+            protected:
+                //! Handles a single event produced by the ENet host.
+                void processEvent(ENetEvent &event);
+
+            // Private Methods
+            private:
+                //! Returns the network thread if there is one, otherwise the transport.
+                Kiaro::Network::Transport *getTransport(void);
+
+                //! Starts another attempt to connect, or gives up if there are none left.
+                void attemptConnect(void);
+
+                //! Brings down the network thread and the transport and forgets about the server.
+                void close(void);
+
             // Protected Members
             protected:
-                bool mIsConnected;
+                Kiaro::Network::CONNECTION_STATE mConnectionState;
                 Kiaro::Common::U16 mPort;
                 Kiaro::Common::U8 mCurrentStage;
 
                 ENetPeer *mInternalPeer;
-                ENetHost *mInternalHost;
+                Kiaro::Network::Transport *mTransport;
+
+                bool mUsesNetworkThread;
+                //! The thread servicing mTransport while connected, if mUsesNetworkThread was set.
+                Kiaro::Network::NetworkThread *mNetworkThread;
+
+                //! The address of the server being connected to.
+                ENetAddress mAddress;
+                //! The time, by the transport's clock, at which the current connect attempt or disconnect began.
+                Kiaro::Common::U32 mStateStartTime;
+                Kiaro::Common::U32 mConnectTimeout;
+                Kiaro::Common::U32 mConnectAttemptsLeft;
+
+                Kiaro::Network::NetworkStatistics mStatistics;
+                //! Where received packets are recorded to, if anywhere.
+                Kiaro::Network::DemoRecorder *mDemoRecorder;
+
+                Kiaro::Network::MessageChannels mMessageChannels;
 		};
 	} // End Namespace Network
 } // End Namespace Kiaro
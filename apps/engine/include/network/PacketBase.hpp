@@ -24,8 +24,35 @@ namespace Kiaro
     namespace Network
     {
         class IncomingClientBase;
+        class PacketRegistry;
 
-        //! Class representing a packet that has or is ready to traverse across the network to a remote host.
+        /**
+         *  @brief An enumeration of the ways a packet can be delivered. Each one is sent on an ENet channel of its own, so
+         *  a reliable packet waiting to be resent only holds up the packets of its own class.
+         */
+        enum TRAFFIC_CLASS
+        {
+            //! Always arrives, in the order it was sent with the rest of its class. Connection state changes belong here.
+            TRAFFIC_RELIABLE_ORDERED = 0,
+            /**
+             *  Always arrives, but doesn't care about anything sent in the other classes. ENet has no unordered reliable
+             *  delivery, so these are still ordered among themselves.
+             */
+            TRAFFIC_RELIABLE_UNORDERED = 1,
+            //! May be lost, and is dropped if it arrives after a later packet of its class. State that is resent constantly belongs here.
+            TRAFFIC_UNRELIABLE_SEQUENCED = 2,
+            //! May be lost, and arrives in whatever order the network delivers it.
+            TRAFFIC_UNRELIABLE = 3,
+
+            //! The number of traffic classes, and so the number of channels every connection opens.
+            TRAFFIC_CLASS_COUNT = 4,
+        }; // End Enum TRAFFIC_CLASS
+
+        /**
+         *  @brief Class representing a packet that has or is ready to traverse across the network to a remote host.
+         *  @details Every packet is headed by its type and an ID, both written as variable length integers. The type
+         *  fits in a single byte, and the ID takes one byte for every seven bits it needs.
+         */
         class PacketBase : public Kiaro::Engine::SerializableObjectBase
         {
             // Public Methods
@@ -43,19 +70,19 @@ namespace Kiaro
 
                 virtual void packData(Kiaro::Support::BitStream &out)
                 {
-                    static Kiaro::Common::U32 sLastPacketID = 0;
+                    Kiaro::Common::U32 &nextPacketID = getNextPacketID();
 
-                    out.writeU32(mType);
-                    out.writeU32(sLastPacketID);
-                    mID = sLastPacketID;
+                    out.writeVarU32(mType);
+                    out.writeVarU32(nextPacketID);
+                    mID = nextPacketID;
 
-                    sLastPacketID++;
+                    nextPacketID++;
                 }
 
                 virtual void unpackData(Kiaro::Support::BitStream &in)
                 {
-                    mID = in.readU32();
-                    mType = in.readU32();
+                    mID = in.readVarU32();
+                    mType = in.readVarU32();
                 }
 
                 Kiaro::Common::U32 getType(void) { return mType; }
@@ -64,18 +91,47 @@ namespace Kiaro
 
                 virtual Kiaro::Common::U32 getMinimumPacketPayloadLength(void)
                 {
-                    return sizeof(Kiaro::Common::U32) * 2;
+                    return sizeof(Kiaro::Common::U8) * 2;
+                }
+
+                /**
+                 *  @brief Returns the exact number of bytes that packData will write.
+                 *  @return A Kiaro::Common::U32 representing the serialized size of this packet in bytes.
+                 *  @note Subclasses that write anything should add their own payload size to the result of this.
+                 */
+                virtual Kiaro::Common::U32 getPacketSize(void)
+                {
+                    return Kiaro::Support::BitStream::getVarU32Size(mType) + Kiaro::Support::BitStream::getVarU32Size(getNextPacketID());
+                }
+
+                //! Returns the most bytes the header written by PacketBase::packData can take.
+                static Kiaro::Common::U32 getMaximumHeaderSize(void)
+                {
+                    return Kiaro::Support::BitStream::getVarU32Size(0xFFFFFFFF) * 2;
                 }
 
             // Public Members
             public:
                 static const Kiaro::Common::U8 sAcceptedStage = 0;
+                //! How packets of this type are delivered. Packet classes declare their own to be sent any other way.
+                static const Kiaro::Network::TRAFFIC_CLASS sTrafficClass = Kiaro::Network::TRAFFIC_RELIABLE_ORDERED;
 
                 //! A pointer to a Client instance that sent the data. If this is NULL, then the origin was a Server.
                 Kiaro::Network::IncomingClientBase *mSender;
 
+            // Private Methods
+            private:
+                //! Returns the ID the next packet to be packed will be given, which getPacketSize needs to know the size of.
+                static Kiaro::Common::U32 &getNextPacketID(void)
+                {
+                    static Kiaro::Common::U32 sNextPacketID = 0;
+                    return sNextPacketID;
+                }
+
             // Private Members
             private:
+                friend class Kiaro::Network::PacketRegistry;
+
                 Kiaro::Common::U32 mType;
                 Kiaro::Common::U32 mID;
         };
@@ -0,0 +1,140 @@
+/**
+ *  @file PacketRegistry.hpp
+ *  @brief Include file defining the Kiaro::Network::PacketRegistry class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_PACKETREGISTRY_HPP_
+#define _INCLUDE_KIARO_NETWORK_PACKETREGISTRY_HPP_
+
+#include <stdexcept>
+
+#include <easydelegate.hpp>
+
+#include "engine/Common.hpp"
+#include <engine/Config.hpp>
+
+#include <network/PacketBase.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        class BitStream;
+    } // End NameSpace Support
+
+    namespace Network
+    {
+        class IncomingClientBase;
+        class NetworkStatistics;
+
+        /**
+         *  @brief A table mapping packet type IDs to the code that decodes and handles them.
+         *  @details Packet types index straight into a flat array, so dispatching a received packet is a single
+         *  lookup. The packet header is only read once, by the registry, and the registered packet class then only
+         *  has to decode its own payload before being handed to its handler.
+         */
+        class PacketRegistry
+        {
+            // Public Methods
+            public:
+                PacketRegistry(void);
+
+                //! Standard destructor. This deletes all handler delegates that were registered.
+                ~PacketRegistry(void);
+
+                /**
+                 *  @brief Registers a handler for the given packet class.
+                 *  @param handler A delegate to invoke with each decoded packet of this type. The registry takes ownership of it.
+                 *  @throw std::out_of_range Thrown when the packet type is larger than NETWORK_MAXIMUM_PACKET_TYPES allows.
+                 *  @throw std::runtime_error Thrown when the packet type already has a handler.
+                 *  @note The packet class must be default constructible, construct its type ID, accept a (BitStream *, IncomingClientBase *)
+                 *  constructor and declare its own sAcceptedStage.
+                 */
+                template <typename packetClass>
+                void registerPacket(EasyDelegate::DelegateBase<void, packetClass &> *handler)
+                {
+                    const Kiaro::Common::U32 packetType = packetClass().getType();
+
+                    if (packetType >= NETWORK_MAXIMUM_PACKET_TYPES)
+                        throw std::out_of_range("PacketRegistry: Packet type is out of range!");
+
+                    PacketEntry &entry = mEntries[packetType];
+                    if (entry.mHandler)
+                        throw std::runtime_error("PacketRegistry: Packet type is already registered!");
+
+                    entry.mHandler = handler;
+                    entry.mDecoder = decodePacket<packetClass>;
+                    entry.mDestroyer = destroyHandler<packetClass>;
+                    entry.mAcceptedStage = packetClass::sAcceptedStage;
+                    entry.mTrafficClass = packetClass::sTrafficClass;
+                }
+
+                /**
+                 *  @brief Decodes a received packet and hands it to the handler registered for its type.
+                 *  @param incomingStream The stream containing the received packet.
+                 *  @param sender The client that sent the packet. This is NULL when the packet came from a server.
+                 *  @param currentStage The connection stage the sender is currently in. Packets whose sAcceptedStage
+                 *  is greater than this are dropped.
+                 *  @param statistics Where to count the packet and the time taken to handle it, or NULL.
+                 *  @return A boolean representing whether or not the packet was handled. Packets of unknown types, packets
+                 *  sent too early, and packets that throw while being decoded or handled are logged and dropped.
+                 */
+                bool dispatch(Kiaro::Support::BitStream &incomingStream, Kiaro::Network::IncomingClientBase *sender, const Kiaro::Common::U8 &currentStage,
+                Kiaro::Network::NetworkStatistics *statistics = NULL);
+
+                /**
+                 *  @brief Returns the traffic class the packet class registered for a packet type declares, which is the
+                 *  class the remote host should be sending it in.
+                 *  @param packetType The packet type.
+                 *  @throw std::out_of_range Thrown when nothing is registered for the packet type.
+                 */
+                Kiaro::Network::TRAFFIC_CLASS getTrafficClass(const Kiaro::Common::U32 &packetType);
+
+            // Private Methods
+            private:
+                template <typename packetClass>
+                static void decodePacket(EasyDelegate::GenericDelegate *handler, Kiaro::Support::BitStream &incomingStream, Kiaro::Network::IncomingClientBase *sender, const Kiaro::Common::U32 &packetID)
+                {
+                    packetClass packet(NULL, sender);
+                    packet.mID = packetID;
+                    packet.unpackData(incomingStream);
+
+                    static_cast<EasyDelegate::DelegateBase<void, packetClass &> *>(handler)->invoke(packet);
+                }
+
+                template <typename packetClass>
+                static void destroyHandler(EasyDelegate::GenericDelegate *handler)
+                {
+                    delete static_cast<EasyDelegate::DelegateBase<void, packetClass &> *>(handler);
+                }
+
+            // Private Members
+            private:
+                //! An entry in the registry, describing how to handle one type of packet.
+                struct PacketEntry
+                {
+                    //! The handler delegate. Its real type is only known to mDecoder and mDestroyer.
+                    EasyDelegate::GenericDelegate *mHandler;
+                    //! Decodes the payload into the registered packet class and invokes mHandler with it.
+                    void (*mDecoder)(EasyDelegate::GenericDelegate *, Kiaro::Support::BitStream &, Kiaro::Network::IncomingClientBase *, const Kiaro::Common::U32 &);
+                    //! Deletes mHandler through its real type.
+                    void (*mDestroyer)(EasyDelegate::GenericDelegate *);
+                    //! The lowest connection stage this packet is accepted in.
+                    Kiaro::Common::U8 mAcceptedStage;
+                    //! The traffic class this packet is sent in.
+                    Kiaro::Network::TRAFFIC_CLASS mTrafficClass;
+                };
+
+                PacketEntry mEntries[NETWORK_MAXIMUM_PACKET_TYPES];
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_PACKETREGISTRY_HPP_
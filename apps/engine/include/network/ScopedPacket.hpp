@@ -0,0 +1,46 @@
+/**
+ *  @file ScopedPacket.hpp
+ *  @brief Include file defining the Kiaro::Network::ScopedPacket class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_SCOPEDPACKET_HPP_
+#define _INCLUDE_KIARO_NETWORK_SCOPEDPACKET_HPP_
+
+#include <enet/enet.h>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        /**
+         *  @brief Destroys a received ENet packet when it goes out of scope, so that it is freed however its messages
+         *  were handled.
+         */
+        class ScopedPacket
+        {
+            // Public Methods
+            public:
+                explicit ScopedPacket(ENetPacket *packet) : mPacket(packet) { }
+
+                ~ScopedPacket(void) { enet_packet_destroy(mPacket); }
+
+            // Private Methods
+            private:
+                ScopedPacket(const ScopedPacket &other);
+                ScopedPacket &operator =(const ScopedPacket &other);
+
+            // Private Members
+            private:
+                ENetPacket *mPacket;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_SCOPEDPACKET_HPP_
@@ -14,15 +14,23 @@
 #ifndef _INCLUDE_KIARO_NETWORK_SERVER_H_
 #define _INCLUDE_KIARO_NETWORK_SERVER_H_
 
+#include <map>
 #include <vector>
+#include <ostream>
 
 #include <enet/enet.h>
 
+#include <easydelegate.hpp>
+
 #include <network/IncomingClientBase.hpp>
+#include <network/ClientTable.hpp>
+
+#include <support/BitStream.hpp>
 
 #include <support/MapDivision.hpp>
 
 #include "engine/Common.hpp"
+#include <engine/Config.hpp>
 
 namespace Kiaro
 {
@@ -36,11 +44,18 @@ namespace Kiaro
     {
         class PacketBase;
         class IncomingClientBase;
+        class NetworkThread;
+        class Transport;
+        class DemoRecorder;
+        struct DemoRecord;
 
         //! Server class that remote hosts connect to.
         class ServerBase
         {
             public:
+            //! Delegate type used to decide whether or not a given client should receive a broadcast packet.
+            typedef EasyDelegate::DelegateBase<bool, Kiaro::Network::IncomingClientBase *> ClientFilter;
+
             /**
              *  @brief Constructor that initializes a server instance with the given information.
              *  @param listen_address An array of c8 representing the IP address to listen on.
@@ -49,6 +64,13 @@ namespace Kiaro
              */
             ServerBase(const std::string &listenAddress, const Kiaro::Common::U16 &listenPort, const Kiaro::Common::U32 &maximumClientCount);
 
+            /**
+             *  @brief Constructor that initializes a server instance on top of an existing transport.
+             *  @param transport The transport to accept connections through. The server takes ownership of it.
+             *  @param maximumClientCount The number of clients to make room for. Any more that connect are turned away.
+             */
+            ServerBase(Kiaro::Network::Transport *transport, const Kiaro::Common::U32 &maximumClientCount = NETWORK_MAXIMUM_CLIENTS);
+
             /**
 			 *  @brief Standard virtual destructor.
 			 *  @note The only reason this destructor is virtual is to prevent compiler warnings when deleting instances that
@@ -69,14 +91,82 @@ namespace Kiaro
 
             Kiaro::Common::U32 getClientCount(void);
 
-            void globalSend(Kiaro::Network::PacketBase *packet, const bool &reliable);
+            /**
+             *  @brief Looks up a connected client by its handle.
+             *  @return The client, or NULL if the handle is invalid or the client it named has since disconnected.
+             */
+            Kiaro::Network::IncomingClientBase *getClient(const Kiaro::Network::ClientHandle &handle) { return mClients.get(handle); }
 
-            void update(void);
+            /**
+             *  @brief Disconnects a client immediately, without waiting for anything queued for it to go out, and forgets it
+             *  the same way as if it had disconnected itself.
+             *  @param client The client to drop. It is handed out again to whoever connects next, so nothing may use it after this.
+             */
+            void dropClient(Kiaro::Network::IncomingClientBase *client);
 
             /**
-             *  @brief Causes the server to handle all queued network events immediately.
+             *  @brief Sends a packet to every connected client.
+             *  @param packet The packet to send. It is only serialized once and then copied into each recipient's message buffer.
+             *  @param trafficClass How the packet should be delivered.
+             *  @param filter An optional delegate returning whether or not a given client should receive the packet.
              */
-            void dispatch(void) { if (mIsRunning) enet_host_flush(mInternalHost); }
+            void globalSend(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass, ClientFilter *filter = NULL);
+
+            /**
+             *  @brief Sends a packet to a given set of clients.
+             *  @param packet The packet to send. It is only serialized once and then copied into each recipient's message buffer.
+             *  @param recipients The clients to send the packet to.
+             *  @param trafficClass How the packet should be delivered.
+             */
+            void multicastSend(Kiaro::Network::PacketBase *packet, const std::vector<Kiaro::Network::IncomingClientBase *> &recipients,
+            Kiaro::Network::TRAFFIC_CLASS trafficClass);
+
+            virtual void update(void);
+
+            /**
+             *  @brief Hands every message queued for the clients over to ENet and sends them immediately.
+             *  @note This should be called once per tick, after everything for that tick has been sent.
+             */
+            void dispatch(void);
+
+            /**
+             *  @brief Hands the transport over to a network thread of its own. From then on update only picks up what that
+             *  thread has received and dispatch only queues packets for it.
+             */
+            void startNetworkThread(void);
+
+            //! Returns the transport that packets for the clients should go through, which is the network thread if one is running.
+            Kiaro::Network::Transport *getTransport(void);
+
+            /**
+             *  @brief Samples the statistics of every connected client and writes them to a stream. Each call closes off
+             *  the window that the rates are worked out over, so this should be called at a steady interval.
+             *  @param out The stream to write to.
+             */
+            void writeStatistics(std::ostream &out);
+
+            /**
+             *  @brief Starts appending every packet received from the clients to a demo file, replacing any recording
+             *  already going on.
+             *  @param fileName The path of the demo file.
+             *  @throw std::runtime_error Thrown when the file can't be created.
+             */
+            void startRecording(const std::string &fileName);
+
+            //! Stops recording, if recording.
+            void stopRecording(void);
+
+            /**
+             *  @brief Feeds a packet from a server demo through onReceivePacket as if its sender had just sent it.
+             *  @param record The packet to feed.
+             *  @details Each sender in the demo is given a client of its own the first time it is heard from, which is
+             *  treated as connected from then on. Those clients have no peer, so whatever is sent to them is thrown away
+             *  when dispatched.
+             */
+            void replay(const Kiaro::Network::DemoRecord &record);
+
+            //! Disconnects and deletes every client created by replay.
+            void stopReplay(void);
 
             //! Callback function that is called upon the server's underlaying network subsystem accepting a remote host connection.
             virtual void onClientConnected(Kiaro::Network::IncomingClientBase *client) = 0;
@@ -85,20 +175,56 @@ namespace Kiaro
 
             virtual void onReceivePacket(Kiaro::Support::BitStream &incomingStream, Kiaro::Network::IncomingClientBase *sender) = 0;
 
+            /**
+             *  @brief Creates the object representing a newly connected remote host.
+             *  @param connecting The ENet peer that connected.
+             *  @return A new IncomingClientBase. Servers that keep their own state per client return a subclass here.
+             */
+            virtual Kiaro::Network::IncomingClientBase *createIncomingClient(ENetPeer *connecting) { return new Kiaro::Network::IncomingClientBase(connecting, this); }
+
             Kiaro::Network::IncomingClientBase *getLastPacketSender(void);
 
+            // Protected Methods
+            protected:
+                //! Handles a single event produced by the ENet host.
+                void processEvent(ENetEvent &event);
+
+                /**
+                 *  @brief Returns a client object for a peer that is connecting, reusing one left by a disconnected client
+                 *  if there is one and creating one with createIncomingClient otherwise.
+                 */
+                Kiaro::Network::IncomingClientBase *acquireClient(ENetPeer *connecting);
+
+                //! Lets the subclass know that a client is gone, then takes it out of the table and keeps it for reuse.
+                void removeClient(Kiaro::Network::IncomingClientBase *client);
+
+                //! Keeps a client object that is done with for acquireClient to hand out again.
+                void releaseClient(Kiaro::Network::IncomingClientBase *client);
+
             // Protected Members
 			protected:
                 bool mIsRunning;
 
-                ENetHost *mInternalHost;
+                Kiaro::Network::Transport *mTransport;
+                Kiaro::Network::NetworkThread *mNetworkThread;
 
                 //! The Port number that we're listening on.
                 const Kiaro::Common::U16 mListenPort;
                 //! The Address that we're listening on.
                 const std::string mListenAddress;
 
-                std::set<size_t> mConnectedClientSet;
+                //! The connected clients. Subclasses going over them every tick should walk this by position.
+                Kiaro::Network::ClientTable mClients;
+                //! Client objects left by disconnected clients, waiting to be handed out again.
+                std::vector<Kiaro::Network::IncomingClientBase *> mClientPool;
+
+                //! Scratch stream that packets sent to several clients are serialized into.
+                Kiaro::Support::BitStream mBroadcastStream;
+
+                //! Where received packets are recorded to, if anywhere.
+                Kiaro::Network::DemoRecorder *mDemoRecorder;
+                //! The clients created by replay, keyed by the port they were recorded with.
+                std::map<Kiaro::Common::U16, Kiaro::Network::IncomingClientBase *> mReplayClients;
         };
     } // End Namespace Network
 } // End Namespace Kiaro
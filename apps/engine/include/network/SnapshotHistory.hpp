@@ -0,0 +1,110 @@
+/**
+ *  @file SnapshotHistory.hpp
+ *  @brief Include file defining the Kiaro::Network::Snapshot and Kiaro::Network::SnapshotHistory classes.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_SNAPSHOTHISTORY_HPP_
+#define _INCLUDE_KIARO_NETWORK_SNAPSHOTHISTORY_HPP_
+
+#include <map>
+#include <vector>
+
+#include "engine/Common.hpp"
+#include <engine/Config.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        //! The serialized state of a single entity as it was in some snapshot.
+        struct EntityState
+        {
+            //! The type mask of the entity, so that the remote end knows what to create.
+            Kiaro::Common::U32 mTypeMask;
+            //! The bytes written by the entity's packUpdate, which hold only the properties that changed since the baseline.
+            std::vector<Kiaro::Common::U8> mData;
+            //! The bytes written by the entity's packInitialization, which the remote end needs to create it.
+            std::vector<Kiaro::Common::U8> mInitialization;
+            //! The sequence number of the snapshot whose state this brings the remote entity up to. Only kept by the server.
+            Kiaro::Common::U32 mSequence;
+            /**
+             *  The sequence number since which the entity has been in every snapshot sent to the remote host. Only kept by
+             *  the server.
+             */
+            Kiaro::Common::U32 mFirstSequence;
+        };
+
+        //! The state of every replicated entity at one point in time, keyed by network ID.
+        struct Snapshot
+        {
+            //! The sequence number of this snapshot. Sequence 0 is never used.
+            Kiaro::Common::U32 mSequence;
+            //! The server's time in milliseconds when this snapshot was taken.
+            Kiaro::Common::U32 mTime;
+
+            std::map<Kiaro::Common::U32, Kiaro::Network::EntityState> mEntityStates;
+        };
+
+        /**
+         *  @brief A ring of the most recent snapshots exchanged with one remote host.
+         *  @details The server keeps one of these per client holding what it sent, so that it can diff against whatever
+         *  the client last acknowledged. The client keeps one holding what it received, so that it can fill in whatever a diff
+         *  says is unchanged.
+         */
+        class SnapshotHistory
+        {
+            // Public Methods
+            public:
+                SnapshotHistory(void);
+
+                /**
+                 *  @brief Stores a new snapshot, replacing the oldest one held.
+                 *  @param sequence The sequence number of the new snapshot.
+                 *  @return A reference to the stored snapshot, which starts out empty.
+                 */
+                Kiaro::Network::Snapshot &push(const Kiaro::Common::U32 &sequence);
+
+                /**
+                 *  @brief Looks up a stored snapshot.
+                 *  @param sequence The sequence number of the snapshot to look up.
+                 *  @return A pointer to the snapshot or NULL if it was never stored or has since been replaced.
+                 */
+                Kiaro::Network::Snapshot *get(const Kiaro::Common::U32 &sequence);
+
+                /**
+                 *  @brief Records that the remote host has received the given snapshot.
+                 *  @param sequence The sequence number that was acknowledged. Older acknowledgements than the current one are ignored.
+                 */
+                void acknowledge(const Kiaro::Common::U32 &sequence);
+
+                //! Returns the sequence number of the newest acknowledged snapshot, or 0 if there is none.
+                Kiaro::Common::U32 getAcknowledgedSequence(void) { return mAcknowledgedSequence; }
+
+                /**
+                 *  @brief Returns the snapshot that a new snapshot should be diffed against.
+                 *  @param currentSequence The sequence number of the snapshot that is about to be sent.
+                 *  @return The newest acknowledged snapshot, or NULL if there is none or it is older than
+                 *  NETWORK_SNAPSHOT_MAXIMUM_BASELINE_AGE, in which case full state has to be sent instead.
+                 */
+                Kiaro::Network::Snapshot *getBaseline(const Kiaro::Common::U32 &currentSequence);
+
+                //! Forgets every snapshot and acknowledgement, as if newly constructed.
+                void clear(void);
+
+            // Private Members
+            private:
+                Kiaro::Network::Snapshot mSnapshots[NETWORK_SNAPSHOT_HISTORY_LENGTH];
+
+                Kiaro::Common::U32 mAcknowledgedSequence;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_SNAPSHOTHISTORY_HPP_
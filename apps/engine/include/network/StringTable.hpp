@@ -0,0 +1,108 @@
+/**
+ *  @file StringTable.hpp
+ *  @brief Include file defining the Kiaro::Network::StringTable class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_STRINGTABLE_HPP_
+#define _INCLUDE_KIARO_NETWORK_STRINGTABLE_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        class BitStream;
+    } // End NameSpace Support
+
+    namespace Network
+    {
+        /**
+         *  @brief Strings such as asset paths and names, each given a small ID so that it only has to cross the network
+         *  once and can be referred to by ID after that.
+         *  @details IDs are handed out in order starting from 0 and are never reused, so a connection only has to remember
+         *  how many of the server's strings it has been sent to know which ones are new. The server's table is seeded from
+         *  the asset manifest, which every client is sent in full when it shakes hands, and grows as
+         *  Kiaro::Game::Entities::EntityBase::packInitialization refers to strings that weren't in it. Strings are sent
+         *  reliably and in order, so anything referring to them by ID must either go out after them in the same traffic
+         *  class or wait for them to arrive.
+         */
+        class StringTable
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Returns the ID of a string, adding it to the table if it isn't there already.
+                 *  @param string The string to look up.
+                 *  @throw std::overflow_error Thrown when the table is full.
+                 *  @throw std::length_error Thrown when the string is longer than a Kiaro::Common::U16 can give the length of.
+                 */
+                Kiaro::Common::U16 insert(const std::string &string);
+
+                /**
+                 *  @brief Looks up the ID of a string without adding it.
+                 *  @return The ID, or sInvalidID if the string isn't in the table.
+                 */
+                Kiaro::Common::U16 getID(const std::string &string) const;
+
+                /**
+                 *  @brief Looks up a string by its ID.
+                 *  @return A pointer to the string, or NULL if no string has that ID.
+                 */
+                const std::string *getString(const Kiaro::Common::U16 &id) const { return id < mStrings.size() ? &mStrings[id] : NULL; }
+
+                //! Returns the number of strings in the table, which is also the ID the next one will be given.
+                size_t getCount(void) const { return mStrings.size(); }
+
+                //! Removes every string from the table.
+                void clear(void);
+
+                /**
+                 *  @brief Adds every path listed in an asset manifest, one per line. Blank lines and lines starting with
+                 *  a '#' are skipped.
+                 *  @param fileName The path of the manifest in the game's file system.
+                 *  @return True if the manifest could be read, false otherwise.
+                 */
+                bool loadManifest(const std::string &fileName);
+
+                /**
+                 *  @brief Writes a reference to a string, adding the string to the table if need be.
+                 *  @param out The stream to write to.
+                 *  @param string The string to refer to, or an empty string for none.
+                 */
+                void writeReference(Kiaro::Support::BitStream &out, const std::string &string);
+
+                /**
+                 *  @brief Reads a reference written by writeReference.
+                 *  @param in The stream to read from.
+                 *  @return A pointer to the string, or NULL if there was none or its ID isn't in the table.
+                 */
+                const std::string *readReference(Kiaro::Support::BitStream &in) const;
+
+            // Public Members
+            public:
+                //! The ID referring to no string at all. The table never hands it out.
+                static const Kiaro::Common::U16 sInvalidID = 0xFFFF;
+
+            // Private Members
+            private:
+                //! The strings in order of their IDs.
+                std::vector<std::string> mStrings;
+                //! The ID of every string in the table.
+                std::map<std::string, Kiaro::Common::U16> mIDs;
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_STRINGTABLE_HPP_
@@ -0,0 +1,114 @@
+/**
+ *  @file Transport.hpp
+ *  @brief Include file defining the Kiaro::Network::Transport interface.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_NETWORK_TRANSPORT_HPP_
+#define _INCLUDE_KIARO_NETWORK_TRANSPORT_HPP_
+
+#include <enet/enet.h>
+
+#include "engine/Common.hpp"
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        //! What ENet reports about a connection, as read by Kiaro::Network::Transport::sampleLink.
+        struct LinkStatistics
+        {
+            //! The round trip time in milliseconds.
+            Kiaro::Common::U32 mRoundTripTime;
+            //! The round trip time variance in milliseconds.
+            Kiaro::Common::U32 mRoundTripTimeVariance;
+            //! The packet loss, scaled by ENET_PEER_PACKET_LOSS_SCALE.
+            Kiaro::Common::U32 mPacketLoss;
+            //! The number of reliable bytes sent but not yet acknowledged.
+            Kiaro::Common::U32 mReliableBytesInTransit;
+        };
+
+        /**
+         *  @brief Interface for whatever carries packets between hosts underneath the server and client classes.
+         *  @details Transports speak in ENet's own structures whatever they are backed by, so ENet packets, peers and events
+         *  are passed through unchanged. A transport takes ownership of a packet that it accepts for sending, and received
+         *  packets are owned by whoever serviced them until they are destroyed with enet_packet_destroy.
+         */
+        class Transport
+        {
+            // Public Methods
+            public:
+                //! Standard virtual destructor.
+                virtual ~Transport(void) { }
+
+                /**
+                 *  @brief Starts connecting to a remote host. A connect event is produced once the connection is established.
+                 *  @param address The address of the remote host.
+                 *  @param channelCount The number of channels to open.
+                 *  @return The peer representing the remote host, or NULL if no connection could be started.
+                 */
+                virtual ENetPeer *connect(const ENetAddress &address, const size_t &channelCount) = 0;
+
+                /**
+                 *  @brief Produces the next event, waiting up to the given number of milliseconds for one.
+                 *  @param event The event is written here.
+                 *  @param timeout The time in milliseconds to wait for an event if none are ready.
+                 *  @return Greater than zero if an event was produced, zero if there was none and less than zero on failure.
+                 */
+                virtual Kiaro::Common::S32 service(ENetEvent &event, const Kiaro::Common::U32 &timeout) = 0;
+
+                /**
+                 *  @brief Queues a packet to be sent to a peer.
+                 *  @param peer The peer to send to.
+                 *  @param channel The channel to send on.
+                 *  @param packet The packet to send.
+                 *  @return Zero if the packet was accepted, in which case the transport owns it, and less than zero otherwise.
+                 */
+                virtual Kiaro::Common::S32 send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet) = 0;
+
+                //! Sends everything that has been queued right away instead of on the next service.
+                virtual void flush(void) = 0;
+
+                /**
+                 *  @brief Disconnects a peer.
+                 *  @param peer The peer to disconnect.
+                 *  @param now A boolean representing whether to drop the peer immediately rather than disconnect gracefully. No
+                 *  disconnect event is produced locally when dropping a peer immediately.
+                 */
+                virtual void disconnect(ENetPeer *peer, const bool &now) = 0;
+
+                /**
+                 *  @brief Forgets about a peer without telling the remote host.
+                 *  @param peer The peer to forget about.
+                 */
+                virtual void reset(ENetPeer *peer) = 0;
+
+                //! Returns the current time in milliseconds by the clock the transport keeps, for timing out on it.
+                virtual Kiaro::Common::U32 getTime(void) = 0;
+
+                /**
+                 *  @brief Takes a reading of how a connection is doing. By default this reads it straight off the peer.
+                 *  @param peer The peer to take a reading of.
+                 *  @param link The reading is written here.
+                 *  @return True if a reading was written, false if there is none to be had.
+                 */
+                virtual bool sampleLink(ENetPeer *peer, Kiaro::Network::LinkStatistics &link)
+                {
+                    link.mRoundTripTime = peer->roundTripTime;
+                    link.mRoundTripTimeVariance = peer->roundTripTimeVariance;
+                    link.mPacketLoss = peer->packetLoss;
+                    link.mReliableBytesInTransit = peer->reliableDataInTransit;
+
+                    return true;
+                }
+        };
+    } // End Namespace Network
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_NETWORK_TRANSPORT_HPP_
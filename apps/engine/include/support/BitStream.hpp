@@ -23,7 +23,16 @@ namespace Kiaro
 {
     namespace Support
     {
-        //! BitStreams are serialized chunks of data that allow for easy read/write operations.
+        /**
+         *  @brief BitStreams are serialized chunks of data that allow for easy read/write operations.
+         *  @details Data is read back in the reverse order that it was written, unless the BitStream is set to read forward
+         *  with setForward. Values written with writeBits and its
+         *  derivatives are packed at bit granularity; consecutive bit writes form a run that is closed off to a byte boundary
+         *  once whole bytes are written again (or the stream is read), so byte sized writes always remain byte aligned.
+         *  Multi-byte values are always stored little endian, whatever the host is, so hosts of either byte order can talk
+         *  to each other. On little endian hosts the conversion compiles away entirely. Raw data given to write goes in as
+         *  it is, so anything multi-byte in it has to be converted with the functions in EndianUtilities.hpp first.
+         */
         class BitStream
         {
             public:
@@ -31,10 +40,11 @@ namespace Kiaro
                  *  @brief Constructor accepting an initial array and length.
                  *  @param initial_data_array A pointer to a Kiaro::u8 array that utilize as our initial memory.
                  *  @param initial_data_length The size in bytes that our in parameter is, if specified.
-                 *  @warning If initial_data_array is specified, it may be deallocated if the BitStream allocates
-                 *  more memory when attempting to write beyond its current bounds.
-                 *  @warning When using this constructor, The Kiaro::Support::BitStream code will delete the input
-                 *  array upon deletion of itself or if it needs to readjust its array length.
+                 *  @param initialDataIndex The position reading and writing starts at. Everything before it is considered
+                 *  to be data already held by the BitStream, so incoming data should pass its full length here and a buffer
+                 *  that is to be written into should pass 0.
+                 *  @note The input array is never deleted by the BitStream. If a write goes beyond its bounds, the BitStream
+                 *  copies its contents into memory of its own and continues from there.
                  */
                 BitStream(Kiaro::Common::U8 *initialData = NULL, size_t initialDataLength = 0, size_t initialDataIndex = 0);
 
@@ -56,6 +66,7 @@ namespace Kiaro
                  *  should allocate its internal array to be.
                  *  @warning When using this constructor, the memory associated with the Kiaro::Support:BitStream's internal array
                  *  is destroyed when resizing and/or when the Kiaro::Support::BitStream instance itself is deleted.
+                 *  @note The initial length is only reserved capacity; the BitStream starts out empty.
                  */
                 BitStream(size_t initialDataLength);
 
@@ -91,6 +102,13 @@ namespace Kiaro
                  */
                  void writeU8(const Kiaro::Common::U8 &inData);
 
+                /**
+                 *  @brief Writes a Kiaro::u16 to the BitStream.
+                 *  @param in_data A Kiaro::u16 to write to the BitStream.
+                 *  @see BitStream::Write
+                 */
+                 void writeU16(const Kiaro::Common::U16 &inData);
+
                 /**
                  *  @brief Writes a Kiaro::u32 to the BitStream.
                  *  @param in_data A Kiaro::u32 to write to the BitStream.
@@ -105,6 +123,75 @@ namespace Kiaro
                  */
                 void writeString(const std::string &inString);
 
+                /**
+                 *  @brief Writes the lowest bits of a value to the BitStream at bit granularity.
+                 *  @param inData The value to write.
+                 *  @param bitCount The number of low bits of inData to write, between 0 and 32.
+                 */
+                void writeBits(const Kiaro::Common::U32 &inData, const Kiaro::Common::U8 &bitCount);
+
+                /**
+                 *  @brief Writes an integer known to lie within [minimum, maximum] using only as many bits as that range requires.
+                 *  @param inData The value to write. It is clamped into the range.
+                 *  @param minimum The smallest value inData may take.
+                 *  @param maximum The largest value inData may take.
+                 *  @see BitStream::writeBits
+                 */
+                void writeRangedU32(const Kiaro::Common::U32 &inData, const Kiaro::Common::U32 &minimum, const Kiaro::Common::U32 &maximum);
+
+                /**
+                 *  @brief Writes a Kiaro::f32 quantized to a fixed precision within [minimum, maximum].
+                 *  @param inData The value to write. It is clamped into the range.
+                 *  @param minimum The smallest value inData may take.
+                 *  @param maximum The largest value inData may take.
+                 *  @param precision The largest error that is acceptable once the value has been read back.
+                 *  @see BitStream::writeBits
+                 */
+                void writeQuantizedF32(const Kiaro::Common::F32 &inData, const Kiaro::Common::F32 &minimum, const Kiaro::Common::F32 &maximum,
+                                       const Kiaro::Common::F32 &precision);
+
+                /**
+                 *  @brief Writes a Kiaro::Common::U32 as a LEB128 variable length integer: seven bits to a byte, with the
+                 *  top bit of each byte set while more follow. Values below 128 take a single byte and no value takes more
+                 *  than five.
+                 *  @param inData The value to write.
+                 */
+                void writeVarU32(const Kiaro::Common::U32 &inData);
+
+                /**
+                 *  @brief Writes a Kiaro::Common::S32 as a variable length integer, zig-zag encoded first so that values
+                 *  close to zero take few bytes whatever their sign.
+                 *  @param inData The value to write.
+                 *  @see BitStream::writeVarU32
+                 */
+                void writeVarS32(const Kiaro::Common::S32 &inData);
+
+                /**
+                 *  @brief Writes a unit quaternion in the smallest three form: the index of its largest component in two
+                 *  bits, then the other three quantized within the range they can take. The largest component is rebuilt
+                 *  from the rest when read.
+                 *  @param inData The quaternion to write, which should be normalized.
+                 *  @param componentBits The number of bits to quantize each of the three components to, between 1 and 10.
+                 *  Ten bits keeps every component within a thousandth of where it was.
+                 *  @throws std::out_of_range Thrown when componentBits is out of range.
+                 */
+                void writeQuaternion(const Kiaro::Common::Quaternion &inData, const Kiaro::Common::U8 &componentBits = 10);
+
+                /**
+                 *  @brief Writes an array of Kiaro::Common::U16 as one block, converted to little endian in bulk rather
+                 *  than a value at a time. The values are read back in the order they were written, whichever way the
+                 *  BitStream reads.
+                 *  @param inData The array to write.
+                 *  @param count The number of values in the array. It is not written, so the reader has to know it.
+                 */
+                void writeU16Array(const Kiaro::Common::U16 *inData, const size_t &count);
+
+                //! @copydoc writeU16Array
+                void writeU32Array(const Kiaro::Common::U32 *inData, const size_t &count);
+
+                //! @copydoc writeU16Array
+                void writeF32Array(const Kiaro::Common::F32 *inData, const size_t &count);
+
                 /**
                  *  @brief Reads arbitrary data from the BitStream.
                  *  @param out_data_length The number in bytes to read.
@@ -141,6 +228,14 @@ namespace Kiaro
                  */
                 Kiaro::Common::U8 readU8(const bool &shouldMemcpy = false);
 
+                /**
+                 *  @brief Reads a Kiaro::u16 from the BitStream.
+                 *  @param should_memcpy A boolean representing whether or not the data should be copied.
+                 *  @return The next Kiaro::u16 in the BitStream.
+                 *  @see BitStream::Read
+                 */
+                Kiaro::Common::U16 readU16(const bool &shouldMemcpy = false);
+
                 /**
                  *  @brief Reads a Kiaro::u32 from the BitStream.
                  *  @param should_memcpy A boolean representing whether or not the data should be copied.
@@ -158,22 +253,183 @@ namespace Kiaro
                  */
                 Kiaro::Common::C8 *readString(const size_t &outStringLength = 0, const bool &shouldMemcpy = false);
 
+                /**
+                 *  @brief Reads a value that was written with writeBits.
+                 *  @param bitCount The number of bits the value was written with, between 0 and 32.
+                 *  @return The value that was read.
+                 *  @throws std::out_of_range Thrown when a read operation goes out of bounds.
+                 */
+                Kiaro::Common::U32 readBits(const Kiaro::Common::U8 &bitCount);
+
+                /**
+                 *  @brief Reads a value that was written with writeRangedU32.
+                 *  @param minimum The minimum the value was written with.
+                 *  @param maximum The maximum the value was written with.
+                 *  @return The value that was read.
+                 */
+                Kiaro::Common::U32 readRangedU32(const Kiaro::Common::U32 &minimum, const Kiaro::Common::U32 &maximum);
+
+                /**
+                 *  @brief Reads a value that was written with writeQuantizedF32.
+                 *  @param minimum The minimum the value was written with.
+                 *  @param maximum The maximum the value was written with.
+                 *  @param precision The precision the value was written with.
+                 *  @return The value that was read.
+                 */
+                Kiaro::Common::F32 readQuantizedF32(const Kiaro::Common::F32 &minimum, const Kiaro::Common::F32 &maximum,
+                                                    const Kiaro::Common::F32 &precision);
+
+                /**
+                 *  @brief Reads a value that was written with writeVarU32.
+                 *  @return The value that was read.
+                 *  @throws std::out_of_range Thrown when a read operation goes out of bounds or the value runs on for
+                 *  more than five bytes.
+                 */
+                Kiaro::Common::U32 readVarU32(void);
+
+                /**
+                 *  @brief Reads a value that was written with writeVarS32.
+                 *  @return The value that was read.
+                 *  @throws std::out_of_range Thrown when a read operation goes out of bounds or the value runs on for
+                 *  more than five bytes.
+                 */
+                Kiaro::Common::S32 readVarS32(void);
+
+                /**
+                 *  @brief Reads a quaternion that was written with writeQuaternion.
+                 *  @param componentBits The number of bits the quaternion was written with.
+                 *  @return The quaternion that was read, normalized.
+                 *  @throws std::out_of_range Thrown when a read operation goes out of bounds or componentBits is out of range.
+                 */
+                Kiaro::Common::Quaternion readQuaternion(const Kiaro::Common::U8 &componentBits = 10);
+
+                /**
+                 *  @brief Reads an array that was written with writeU16Array.
+                 *  @param outData The array to read into, which must hold count values.
+                 *  @param count The number of values the array was written with.
+                 *  @throws std::out_of_range Thrown when a read operation goes out of bounds.
+                 */
+                void readU16Array(Kiaro::Common::U16 *outData, const size_t &count);
+
+                //! @copydoc readU16Array
+                void readU32Array(Kiaro::Common::U32 *outData, const size_t &count);
+
+                //! @copydoc readU16Array
+                void readF32Array(Kiaro::Common::F32 *outData, const size_t &count);
+
+                /**
+                 *  @brief Closes off any partially written byte so that the next write begins on a byte boundary.
+                 *  @note This happens automatically when whole bytes are written or when the BitStream is read from.
+                 */
+                void flushBits(void);
+
+                /**
+                 *  @brief Returns the number of bits needed to represent every value from 0 to range.
+                 *  @param range The largest value that must be representable.
+                 *  @return The number of bits required.
+                 */
+                static Kiaro::Common::U8 getRequiredBits(const Kiaro::Common::U32 &range);
+
+                /**
+                 *  @brief Returns the number of bits writeQuantizedF32 uses for the given parameters.
+                 *  @return The number of bits required.
+                 */
+                static Kiaro::Common::U8 getQuantizedBits(const Kiaro::Common::F32 &minimum, const Kiaro::Common::F32 &maximum,
+                                                          const Kiaro::Common::F32 &precision);
+
+                /**
+                 *  @brief Returns the number of bytes writeVarU32 uses for the given value.
+                 *  @return The number of bytes required, between 1 and 5.
+                 */
+                static Kiaro::Common::U8 getVarU32Size(const Kiaro::Common::U32 &value);
+
+                //! Returns the number of bytes writeVarS32 uses for the given value.
+                static Kiaro::Common::U8 getVarS32Size(const Kiaro::Common::S32 &value);
+
+                //! Returns the number of bits writeQuaternion uses for the given number of bits per component.
+                static Kiaro::Common::U8 getQuaternionBits(const Kiaro::Common::U8 &componentBits) { return 2 + componentBits * 3; }
+
                 /**
                  *  @brief Returns the void pointer representation of the BitStream's contents.
                  *  @return A void pointer to the start of the BitStream's contents.
                  */
                 void *raw(const bool &shouldMemcpy = false);
 
+                /**
+                 *  @brief Switches the BitStream between reading back to front and reading in the order things were written,
+                 *  and moves the read position back to the start.
+                 *  @details A forward BitStream is a cursor over its data that starts at the first byte, so it can be read as
+                 *  more data is written on to the end -- such as a buffer of messages that is decoded while it is still
+                 *  arriving. Runs of bits are laid out differently in either direction, so data has to be written with the
+                 *  same setting it is going to be read with.
+                 *  @param forward True to read in the order written, false for the default of reading in reverse.
+                 */
+                void setForward(const bool &forward);
+
+                //! Returns true if the BitStream reads in the order things were written.
+                bool isForward(void) const { return mIsForward; }
+
+                /**
+                 *  @brief Returns the number of bytes that are yet to be read.
+                 *  @return A size_t representing the unread length in bytes.
+                 */
+                size_t getRemaining(void) const { return mIsForward ? mDataLength - mReadPointer : mDataPointer; }
+
+                /**
+                 *  @brief Returns the number of bytes of data that have been written to the BitStream.
+                 *  @return A size_t representing the length of the BitStream's contents in bytes.
+                 */
                 size_t length(void);
 
+                /**
+                 *  @brief Returns the number of bytes the BitStream may hold before it has to reallocate.
+                 *  @return A size_t representing the allocated size of the BitStream in bytes.
+                 */
+                size_t capacity(void);
+
+                /**
+                 *  @brief Ensures that the BitStream can hold at least the given number of bytes without reallocating.
+                 *  @param newCapacity A size_t representing the desired capacity in bytes.
+                 *  @note This never shrinks the BitStream.
+                 */
+                void reserve(const size_t &newCapacity);
+
+                /**
+                 *  @brief Empties the BitStream while keeping its allocated memory so that it may be reused.
+                 */
+                void clear(void);
+
+            private:
+                //! Reads a value written with writeBits from the front of the BitStream.
+                Kiaro::Common::U32 readBitsForward(const Kiaro::Common::U8 &bitCount);
+
             private:
                 //! The array where all BitStream data is read/written from.
                 Kiaro::Common::U8 *mData;
 
                 //! Keeps track of where we are currently in the BitStream during read and write operations.
                 size_t mDataPointer;
-                //! The current size of the BitStream in bytes.
+                //! The number of bytes of data currently held by the BitStream.
                 size_t mDataLength;
+                //! The allocated size of mData in bytes.
+                size_t mTotalSize;
+
+                /**
+                 *  @brief When writing, the number of bits used in the last byte of the current bit run. When reading, the number
+                 *  of bits that remain unread in the byte at mDataPointer.
+                 */
+                Kiaro::Common::U8 mBitIndex;
+                //! The byte index at which the current run of bit writes began.
+                size_t mBitRunStart;
+                //! A boolean representing whether or not a run of bit writes is still open.
+                bool mIsWritingBits;
+
+                //! A boolean representing whether or not reads start from the front of the data.
+                bool mIsForward;
+                //! When reading forward, the index of the next byte to be read.
+                size_t mReadPointer;
+                //! When reading forward, the number of bits already read from the byte before mReadPointer.
+                Kiaro::Common::U8 mReadBitIndex;
 
                 //! A boolean representing whether or not this Kiaro::Support::BitStream is the sole manager of the associated memory.
                 bool mIsManagingMemory;
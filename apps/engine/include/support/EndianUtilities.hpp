@@ -1,151 +1,249 @@
-/**
- *  @file EndianUtilities.hpp
- *  @brief Include file defining endian conversion functionality.
- *
+/**
+ *  @file EndianUtilities.hpp
+ *  @brief Include file defining endian conversion functionality.
+ *
  *  This software is licensed under the Draconic Free License version 1. Please refer
- *  to LICENSE.txt for more information.
- *
- *  @author Draconic Entertainment
- *  @version 0.0.0.0
- *  @date 3/19/2014
- *  @copyright (c) 2014 Draconic Entertainment
- */
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
 
-#include <EngineCommon.h>
+#ifndef _INCLUDE_KIARO_SUPPORT_ENDIANUTILITIES_HPP_
+#define _INCLUDE_KIARO_SUPPORT_ENDIANUTILITIES_HPP_
+
+#include <string.h>
+
+#include "engine/Common.hpp"
+
+#if defined(_MSC_VER)
+    #include <stdlib.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ENGINE_SSE2_SWAP 1
+#endif
+
+// Everything goes over the network little endian, so only big endian hosts ever swap anything
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define ENGINE_BIG_ENDIAN 1
+#else
+    #define ENGINE_BIG_ENDIAN 0
+#endif
 
 namespace Kiaro
 {
     namespace Support
     {
-        static inline void SwapEndianU32Ref(Kiaro::Common::U32 &from)
+        static inline Kiaro::Common::U16 SwapEndianU16(const Kiaro::Common::U16 &from)
         {
-            #if ENGINE_INLINE_ASM<1
-            from =	((255 & from) << 24) |			// First Byte to fourth position
-                    ((65280 & from) << 8) |			// Second byte to third position
-                    ((16711680 & from) >> 8) |		// Third byte to second position
-                    ((4278190080 & from) >> 24);	// Fourth byte to first position
+            #if defined(__GNUC__)
+            return __builtin_bswap16(from);
+            #elif defined(_MSC_VER)
+            return _byteswap_ushort(from);
             #else
-                #if defined(_MSC_VER)
-                __asm {
-                    push eax;
-                    mov eax, from;
-                    BSWAP eax;
-                    mov from, eax;
-                    pop eax;
-                }
-                #else
-                asm ("movl %0, %%eax; BSWAP %%eax; movl %%eax, %1"
-                    :"=r"(from)
-                    :"r"(from)
-                    :"%eax"
-                    );
-                #endif
+            return (Kiaro::Common::U16)((from << 8) | (from >> 8));
             #endif
         }
 
         static inline Kiaro::Common::U32 SwapEndianU32(const Kiaro::Common::U32 &from)
         {
-            Kiaro::Common::U32 result = from;
-            SwapEndianU32Ref(result);
-
-            return result;
+            #if defined(__GNUC__)
+            return __builtin_bswap32(from);
+            #elif defined(_MSC_VER)
+            return _byteswap_ulong(from);
+            #else
+            return (from << 24) | ((from & 0xFF00) << 8) | ((from >> 8) & 0xFF00) | (from >> 24);
+            #endif
         }
 
-        static inline void SwapEndianU64Ref(Kiaro::Common::U64 &from)
-        {
-            #if ENGINE_INLINE_ASM<1
-            from =  ((255 & from) << 56) |						// First Byte to eighth position
-                    ((65280 & from) << 40) |					// Second byte to seventh position
-                    ((16711680 & from) << 24) |					// Third byte to sixth position
-                    ((4278190080 & from) << 8) | 				// Fourth byte to fifth position
-                    ((1095216660480 & from) >> 8) | 			// Fifth byte to fourth position
-                    ((280375465082880 & from) >> 24) |			// Sixth byte to third position
-                    ((71776119061217280ULL & from) >> 40) |		// Seventh byte to second position
-                    ((18374686479671623680ULL & from) >> 56);	// Eighth byte to first position
-            #elif ENGINE_INLINE_ASM>1 && _ENGINE_64BIT>1
-                #if defined(_MSC_VER)
-                __asm {
-                    push rax;
-                    mov rax, from;
-                    BSWAP rax;
-                    mov from, rax;
-                    pop rax;
-                }
-                #else
-                asm ("mov %0, %%rax; BSWAP %%rax; mov %%rax, %1"
-                    :"=r"(from)
-                    :"r"(from)
-                    :"%rax"
-                    );
-                #endif
+        static inline Kiaro::Common::U64 SwapEndianU64(const Kiaro::Common::U64 &from)
+        {
+            #if defined(__GNUC__)
+            return __builtin_bswap64(from);
+            #elif defined(_MSC_VER)
+            return _byteswap_uint64(from);
+            #else
+            return ((Kiaro::Common::U64)SwapEndianU32((Kiaro::Common::U32)from) << 32) | SwapEndianU32((Kiaro::Common::U32)(from >> 32));
             #endif
         }
 
-        static inline Kiaro::Common::U64 SwapEndianU64(const Kiaro::Common::U64 &from)
+        static inline Kiaro::Common::F32 SwapEndianF32(const Kiaro::Common::F32 &from)
         {
-            Kiaro::Common::U64 result = from;
-            SwapEndianU64Ref(result);
+            // Copied through an integer rather than cast, which would break strict aliasing
+            Kiaro::Common::U32 bits;
+            memcpy(&bits, &from, sizeof(bits));
+            bits = SwapEndianU32(bits);
 
+            Kiaro::Common::F32 result;
+            memcpy(&result, &bits, sizeof(result));
             return result;
         }
 
-        static inline void SwapEndianU16Ref(Kiaro::Common::U16 &from)
+        static inline void SwapEndianU16Ref(Kiaro::Common::U16 &from) { from = SwapEndianU16(from); }
+        static inline void SwapEndianU32Ref(Kiaro::Common::U32 &from) { from = SwapEndianU32(from); }
+        static inline void SwapEndianU64Ref(Kiaro::Common::U64 &from) { from = SwapEndianU64(from); }
+        static inline void SwapEndianF32Ref(Kiaro::Common::F32 &from) { from = SwapEndianF32(from); }
+
+        //! Reverses the bytes of a value of any size in place.
+        static inline void SwapEndianArbitrary(void *from, const Kiaro::Common::U32 &size)
+        {
+            Kiaro::Common::U8 *array = (Kiaro::Common::U8*)from;
+
+            for (Kiaro::Common::U32 iteration = 0; iteration < size / 2; iteration++)
+            {
+                const Kiaro::Common::U8 swapped = array[iteration];
+                array[iteration] = array[size - iteration - 1];
+                array[size - iteration - 1] = swapped;
+            }
+        }
+
+        /**
+         *  @brief Swaps every value in an array of Kiaro::Common::U16 in place, eight at a time where SSE2 is around.
+         *  @param data The array, which does not have to be aligned.
+         *  @param count The number of values in the array.
+         */
+        static inline void SwapEndianU16Array(Kiaro::Common::U16 *data, const size_t &count)
         {
-            #if ENGINE_INLINE_ASM<1
-            from =  ((255 & from) << 8) |	// First Byte to second position
-                    ((65280 & from) >> 8);	// Second byte to first position
-            #else
-                #if defined(_MSC_VER)
-                __asm {
-                    push ax;
-                    mov ax, from;
-                    BSWAP ax;
-                    mov from, ax;
-                    pop ax;
-                }
-                #else
-                asm ("movw %0, %%ax; BSWAP %%ax; movw %%ax, %1"
-                    :"=r"(from)
-                    :"r"(from)
-                    :"%ax"
-                    );
-                #endif
+            size_t iteration = 0;
+
+            #if defined(ENGINE_SSE2_SWAP)
+            for (; iteration + 8 <= count; iteration += 8)
+            {
+                __m128i values = _mm_loadu_si128((const __m128i *)&data[iteration]);
+                values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+                _mm_storeu_si128((__m128i *)&data[iteration], values);
+            }
             #endif
+
+            for (; iteration < count; iteration++)
+                data[iteration] = SwapEndianU16(data[iteration]);
         }
 
-        static inline Kiaro::Common::U16 SwapEndianU16(const Kiaro::Common::U16 &from)
+        /**
+         *  @brief Swaps as many whole blocks of four 32-bit values at the start of an array as SSE2 can.
+         *  @return The number of values swapped, which the caller swaps the rest from.
+         */
+        static inline size_t SwapEndian32Blocks(void *data, const size_t &count)
         {
-            Kiaro::Common::U16 result = from;
-            SwapEndianU16Ref(result);
+            size_t iteration = 0;
 
-            return result;
+            #if defined(ENGINE_SSE2_SWAP)
+            Kiaro::Common::U8 *bytes = (Kiaro::Common::U8 *)data;
+
+            for (; iteration + 4 <= count; iteration += 4)
+            {
+                __m128i values = _mm_loadu_si128((const __m128i *)&bytes[iteration * 4]);
+
+                // Trade the halves of each value, then the bytes of each half
+                values = _mm_shufflehi_epi16(_mm_shufflelo_epi16(values, 0xB1), 0xB1);
+                values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+                _mm_storeu_si128((__m128i *)&bytes[iteration * 4], values);
+            }
+            #endif
+
+            return iteration;
         }
 
-        static inline void SwapEndianF32Ref(Kiaro::Common::F32 &from)
+        /**
+         *  @brief Swaps every value in an array of Kiaro::Common::U32 in place, four at a time where SSE2 is around.
+         *  @param data The array, which does not have to be aligned.
+         *  @param count The number of values in the array.
+         */
+        static inline void SwapEndianU32Array(Kiaro::Common::U32 *data, const size_t &count)
         {
-            SwapEndianU32Ref(*(Kiaro::Common::U32*)&from);
+            for (size_t iteration = SwapEndian32Blocks(data, count); iteration < count; iteration++)
+                data[iteration] = SwapEndianU32(data[iteration]);
         }
 
-        static inline Kiaro::Common::F32 SwapEndianF32(const Kiaro::Common::F32 &from)
+        //! Swaps every value in an array of Kiaro::Common::F32 in place. Floats swap exactly as integers of the same size do.
+        static inline void SwapEndianF32Array(Kiaro::Common::F32 *data, const size_t &count)
         {
-            Kiaro::Common::F32 result = from;
-            SwapEndianF32Ref(result);
+            for (size_t iteration = SwapEndian32Blocks(data, count); iteration < count; iteration++)
+                data[iteration] = SwapEndianF32(data[iteration]);
+        }
 
-            return result;
+        /**
+         *  @brief Converts a value between the host's byte order and the little endian order it is sent over the network
+         *  in. The conversion goes both ways, and compiles to nothing on little endian hosts.
+         */
+        static inline Kiaro::Common::U16 ConvertLittleEndianU16(const Kiaro::Common::U16 &from)
+        {
+            #if ENGINE_BIG_ENDIAN
+            return SwapEndianU16(from);
+            #else
+            return from;
+            #endif
         }
 
-        static inline void SwapEndianArbitrary(void *from, const Kiaro::Common::U32 &size)
+        //! @copydoc ConvertLittleEndianU16
+        static inline Kiaro::Common::U32 ConvertLittleEndianU32(const Kiaro::Common::U32 &from)
         {
-            Kiaro::Common::U8 *array = (Kiaro::Common::U8*)from;
+            #if ENGINE_BIG_ENDIAN
+            return SwapEndianU32(from);
+            #else
+            return from;
+            #endif
+        }
 
-            // Create a copy of the array to read from
-            Kiaro::Common::U8 *copy_from = (Kiaro::Common::U8*)malloc(size);
-            memcpy(copy_from, from, size);
+        //! @copydoc ConvertLittleEndianU16
+        static inline Kiaro::Common::U64 ConvertLittleEndianU64(const Kiaro::Common::U64 &from)
+        {
+            #if ENGINE_BIG_ENDIAN
+            return SwapEndianU64(from);
+            #else
+            return from;
+            #endif
+        }
 
-            for (Kiaro::Common::U32 i = 0; i < size; i++)
-                array[i] = copy_from[size - i];
+        //! @copydoc ConvertLittleEndianU16
+        static inline Kiaro::Common::F32 ConvertLittleEndianF32(const Kiaro::Common::F32 &from)
+        {
+            #if ENGINE_BIG_ENDIAN
+            return SwapEndianF32(from);
+            #else
+            return from;
+            #endif
+        }
+
+        /**
+         *  @brief Converts the bytes of a value of any size in place between the host's byte order and little endian.
+         *  @param from The value.
+         *  @param size The size of the value in bytes.
+         */
+        static inline void ConvertLittleEndianArbitrary(void *from, const Kiaro::Common::U32 &size)
+        {
+            #if ENGINE_BIG_ENDIAN
+            SwapEndianArbitrary(from, size);
+            #endif
+        }
 
-            free(copy_from);
+        //! Converts an array of Kiaro::Common::U16 in place between the host's byte order and little endian.
+        static inline void ConvertLittleEndianU16Array(Kiaro::Common::U16 *data, const size_t &count)
+        {
+            #if ENGINE_BIG_ENDIAN
+            SwapEndianU16Array(data, count);
+            #endif
+        }
+
+        //! Converts an array of Kiaro::Common::U32 in place between the host's byte order and little endian.
+        static inline void ConvertLittleEndianU32Array(Kiaro::Common::U32 *data, const size_t &count)
+        {
+            #if ENGINE_BIG_ENDIAN
+            SwapEndianU32Array(data, count);
+            #endif
+        }
+
+        //! Converts an array of Kiaro::Common::F32 in place between the host's byte order and little endian.
+        static inline void ConvertLittleEndianF32Array(Kiaro::Common::F32 *data, const size_t &count)
+        {
+            #if ENGINE_BIG_ENDIAN
+            SwapEndianF32Array(data, count);
+            #endif
         }
-    }
-}
+    } // End Namespace Support
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_SUPPORT_ENDIANUTILITIES_HPP_
@@ -0,0 +1,457 @@
+/**
+ *  @file FieldList.hpp
+ *  @brief Include file defining the Kiaro::Support::FieldList template and the codecs its fields are serialized with.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_SUPPORT_FIELDLIST_HPP_
+#define _INCLUDE_KIARO_SUPPORT_FIELDLIST_HPP_
+
+#include <type_traits>
+#include <utility>
+
+#include <engine/Common.hpp>
+#include <engine/Config.hpp>
+
+#include <support/BitStream.hpp>
+#include <support/EndianUtilities.hpp>
+
+/**
+ *  @brief Names a member of a class as a field of a Kiaro::Support::FieldList, serialized with the default codec for its type.
+ *  @param owner The class the member belongs to.
+ *  @param member The name of the member.
+ */
+#define KIARO_NETWORKED_FIELD(owner, member) Kiaro::Support::Field<owner, decltype(owner::member), &owner::member>
+
+/**
+ *  @brief Names a member of a class as a field of a Kiaro::Support::FieldList, serialized with the given codec.
+ *  @param owner The class the member belongs to.
+ *  @param member The name of the member.
+ *  @param codec The codec to serialize the member with.
+ */
+#define KIARO_NETWORKED_FIELD_CODEC(owner, member, codec) Kiaro::Support::Field<owner, decltype(owner::member), &owner::member, codec>
+
+/**
+ *  @brief Names a getter and setter of a class as a field of a Kiaro::Support::FieldList, for state the class doesn't
+ *  keep in a member of its own. The field is serialized with the default codec for the type the getter returns.
+ *  @param owner The class the methods belong to. They may be inherited.
+ *  @param getter The name of a const method taking nothing and returning the value.
+ *  @param setter The name of a method taking the value by const reference.
+ */
+#define KIARO_NETWORKED_ACCESSOR(owner, getter, setter) Kiaro::Support::AccessorField<owner, decltype(&owner::getter), &owner::getter, decltype(&owner::setter), &owner::setter>
+
+/**
+ *  @brief Names a getter and setter of a class as a field of a Kiaro::Support::FieldList, serialized with the given codec.
+ *  @param owner The class the methods belong to. They may be inherited.
+ *  @param getter The name of a const method taking nothing and returning the value.
+ *  @param setter The name of a method taking the value by const reference.
+ *  @param codec The codec to serialize the value with.
+ */
+#define KIARO_NETWORKED_ACCESSOR_CODEC(owner, getter, setter, codec) Kiaro::Support::AccessorField<owner, decltype(&owner::getter), &owner::getter, decltype(&owner::setter), &owner::setter, codec>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        //! The starting value of a schema hash, which is the 32-bit FNV-1a offset basis.
+        static const Kiaro::Common::U32 sSchemaHashBasis = 2166136261U;
+
+        //! Mixes one byte into a schema hash with FNV-1a.
+        constexpr Kiaro::Common::U32 hashSchemaByte(const Kiaro::Common::U32 hash, const Kiaro::Common::U32 byte)
+        {
+            return (hash ^ (byte & 0xFF)) * 16777619U;
+        }
+
+        //! Mixes a codec's schema ID into a schema hash, lowest byte first.
+        constexpr Kiaro::Common::U32 hashSchemaID(const Kiaro::Common::U32 hash, const Kiaro::Common::U32 schemaID)
+        {
+            return hashSchemaByte(hashSchemaByte(hashSchemaByte(hashSchemaByte(hash, schemaID), schemaID >> 8), schemaID >> 16), schemaID >> 24);
+        }
+
+        /**
+         *  @brief The codec a field is serialized with unless it names another. Values are copied into the stream byte for
+         *  byte, exactly as the BitStream write and read methods for their type do, with numbers put in little endian order.
+         *  Plain structures go as they are laid out in memory.
+         *  @details A codec is any class with static write, read, isEqual, isBitPacked, getBits and getSchemaID methods
+         *  shaped like these. getBits is the number of bits a value takes up, which for anything that isn't bit packed is
+         *  a whole number of bytes. getSchemaID tells the encoding apart from every other codec's, so that changing how a
+         *  field is sent changes the schema hash of whatever it's in.
+         */
+        template <typename valueType>
+        struct FieldCodec
+        {
+            static_assert(std::is_arithmetic<valueType>::value || std::is_pod<valueType>::value,
+                          "FieldCodec: Only plain values can be copied into a BitStream as they are!");
+
+            static void write(Kiaro::Support::BitStream &out, const valueType &value)
+            {
+                valueType wireValue = value;
+
+                if (std::is_arithmetic<valueType>::value)
+                    Kiaro::Support::ConvertLittleEndianArbitrary(&wireValue, sizeof(valueType));
+
+                out.write(&wireValue, sizeof(valueType));
+            }
+
+            static valueType read(Kiaro::Support::BitStream &in)
+            {
+                valueType result;
+                memcpy(&result, in.read(sizeof(valueType)), sizeof(valueType));
+
+                if (std::is_arithmetic<valueType>::value)
+                    Kiaro::Support::ConvertLittleEndianArbitrary(&result, sizeof(valueType));
+
+                return result;
+            }
+
+            static bool isEqual(const valueType &first, const valueType &second) { return first == second; }
+
+            static constexpr bool isBitPacked(void) { return false; }
+
+            static constexpr Kiaro::Common::U32 getBits(void) { return sizeof(valueType) * 8; }
+
+            static constexpr Kiaro::Common::U32 getSchemaID(void)
+            {
+                return sizeof(valueType) | (std::is_floating_point<valueType>::value ? 0x100 : 0) | (std::is_signed<valueType>::value ? 0x200 : 0);
+            }
+        };
+
+        //! Booleans are packed into a single bit.
+        template <>
+        struct FieldCodec<bool>
+        {
+            static void write(Kiaro::Support::BitStream &out, const bool &value) { out.writeBool(value); }
+
+            static bool read(Kiaro::Support::BitStream &in) { return in.readBool(); }
+
+            static bool isEqual(const bool &first, const bool &second) { return first == second; }
+
+            static constexpr bool isBitPacked(void) { return true; }
+
+            static constexpr Kiaro::Common::U32 getBits(void) { return 1; }
+
+            static constexpr Kiaro::Common::U32 getSchemaID(void) { return 0x400; }
+        };
+
+        //! 64-bit values go as two halves with the upper one written first, as BitStream has no 64-bit writes.
+        template <>
+        struct FieldCodec<Kiaro::Common::U64>
+        {
+            static void write(Kiaro::Support::BitStream &out, const Kiaro::Common::U64 &value)
+            {
+                out.writeU32((Kiaro::Common::U32)(value >> 32));
+                out.writeU32((Kiaro::Common::U32)value);
+            }
+
+            static Kiaro::Common::U64 read(Kiaro::Support::BitStream &in)
+            {
+                Kiaro::Common::U64 result = in.readU32();
+                result |= (Kiaro::Common::U64)in.readU32() << 32;
+
+                return result;
+            }
+
+            static bool isEqual(const Kiaro::Common::U64 &first, const Kiaro::Common::U64 &second) { return first == second; }
+
+            static constexpr bool isBitPacked(void) { return false; }
+
+            static constexpr Kiaro::Common::U32 getBits(void) { return 64; }
+
+            static constexpr Kiaro::Common::U32 getSchemaID(void) { return 0x808; }
+        };
+
+        //! Vectors go as three whole Kiaro::Common::F32s, X first.
+        template <>
+        struct FieldCodec<Kiaro::Common::Vector3DF>
+        {
+            static void write(Kiaro::Support::BitStream &out, const Kiaro::Common::Vector3DF &value)
+            {
+                out.writeF32(value.X);
+                out.writeF32(value.Y);
+                out.writeF32(value.Z);
+            }
+
+            static Kiaro::Common::Vector3DF read(Kiaro::Support::BitStream &in)
+            {
+                Kiaro::Common::Vector3DF result;
+                result.Z = in.readF32();
+                result.Y = in.readF32();
+                result.X = in.readF32();
+
+                return result;
+            }
+
+            static bool isEqual(const Kiaro::Common::Vector3DF &first, const Kiaro::Common::Vector3DF &second)
+            {
+                return first.X == second.X && first.Y == second.Y && first.Z == second.Z;
+            }
+
+            static constexpr bool isBitPacked(void) { return false; }
+
+            static constexpr Kiaro::Common::U32 getBits(void) { return sizeof(Kiaro::Common::F32) * 3 * 8; }
+
+            static constexpr Kiaro::Common::U32 getSchemaID(void) { return 0x3000 | Kiaro::Support::FieldCodec<Kiaro::Common::F32>::getSchemaID(); }
+        };
+
+        /**
+         *  @brief Codec for positions in the world, each axis quantized to NETWORK_POSITION_PRECISION within the range
+         *  NETWORK_POSITION_MINIMUM to NETWORK_POSITION_MAXIMUM.
+         */
+        struct QuantizedPositionCodec
+        {
+            static void write(Kiaro::Support::BitStream &out, const Kiaro::Common::Vector3DF &value)
+            {
+                out.writeQuantizedF32(value.X, NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION);
+                out.writeQuantizedF32(value.Y, NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION);
+                out.writeQuantizedF32(value.Z, NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION);
+            }
+
+            static Kiaro::Common::Vector3DF read(Kiaro::Support::BitStream &in)
+            {
+                Kiaro::Common::Vector3DF result;
+                result.Z = in.readQuantizedF32(NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION);
+                result.Y = in.readQuantizedF32(NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION);
+                result.X = in.readQuantizedF32(NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION);
+
+                return result;
+            }
+
+            static bool isEqual(const Kiaro::Common::Vector3DF &first, const Kiaro::Common::Vector3DF &second)
+            {
+                return first.X == second.X && first.Y == second.Y && first.Z == second.Z;
+            }
+
+            static constexpr bool isBitPacked(void) { return true; }
+
+            static Kiaro::Common::U32 getBits(void)
+            {
+                return Kiaro::Support::BitStream::getQuantizedBits(NETWORK_POSITION_MINIMUM, NETWORK_POSITION_MAXIMUM, NETWORK_POSITION_PRECISION) * 3;
+            }
+
+            //! The range and the number of steps in it are part of the ID, so changing either changes the schema.
+            static constexpr Kiaro::Common::U32 getSchemaID(void)
+            {
+                return Kiaro::Support::hashSchemaID(Kiaro::Support::hashSchemaID(0x01000000, (Kiaro::Common::S32)NETWORK_POSITION_MINIMUM),
+                                                    (Kiaro::Common::U32)((NETWORK_POSITION_MAXIMUM - NETWORK_POSITION_MINIMUM) / NETWORK_POSITION_PRECISION));
+            }
+        };
+
+        /**
+         *  @brief One member of a class as a field of a Kiaro::Support::FieldList. This is usually named with the
+         *  KIARO_NETWORKED_FIELD and KIARO_NETWORKED_FIELD_CODEC macros rather than spelled out.
+         *  @param ownerClass The class the member belongs to.
+         *  @param valueType The type of the member.
+         *  @param member A pointer to the member.
+         *  @param codecClass The codec the member is serialized with.
+         */
+        template <typename ownerClass, typename valueType, valueType ownerClass::*member, typename codecClass = Kiaro::Support::FieldCodec<valueType> >
+        struct Field
+        {
+            typedef valueType Value;
+
+            static const Value &get(const ownerClass &owner) { return owner.*member; }
+
+            static void pack(const ownerClass &owner, Kiaro::Support::BitStream &out) { codecClass::write(out, owner.*member); }
+
+            static void unpack(ownerClass &owner, Kiaro::Support::BitStream &in) { owner.*member = codecClass::read(in); }
+
+            static bool isEqual(const ownerClass &owner, const Value &value) { return codecClass::isEqual(owner.*member, value); }
+
+            static constexpr bool isBitPacked(void) { return codecClass::isBitPacked(); }
+
+            static Kiaro::Common::U32 getBits(void) { return codecClass::getBits(); }
+
+            static constexpr Kiaro::Common::U32 getSchemaID(void) { return codecClass::getSchemaID(); }
+        };
+
+        /**
+         *  @brief A value a class gets and sets through methods as a field of a Kiaro::Support::FieldList. This is usually
+         *  named with the KIARO_NETWORKED_ACCESSOR and KIARO_NETWORKED_ACCESSOR_CODEC macros rather than spelled out.
+         *  @param ownerClass The class the field belongs to.
+         *  @param getterType The type of a pointer to the getter.
+         *  @param getter A pointer to the getter.
+         *  @param setterType The type of a pointer to the setter.
+         *  @param setter A pointer to the setter.
+         *  @param codecClass The codec the value is serialized with.
+         */
+        template <typename ownerClass, typename getterType, getterType getter, typename setterType, setterType setter,
+                  typename codecClass = Kiaro::Support::FieldCodec<typename std::decay<decltype((std::declval<const ownerClass &>().*getter)())>::type> >
+        struct AccessorField
+        {
+            typedef typename std::decay<decltype((std::declval<const ownerClass &>().*getter)())>::type Value;
+
+            static Value get(const ownerClass &owner) { return (owner.*getter)(); }
+
+            static void pack(const ownerClass &owner, Kiaro::Support::BitStream &out) { codecClass::write(out, (owner.*getter)()); }
+
+            static void unpack(ownerClass &owner, Kiaro::Support::BitStream &in) { (owner.*setter)(codecClass::read(in)); }
+
+            static bool isEqual(const ownerClass &owner, const Value &value) { return codecClass::isEqual((owner.*getter)(), value); }
+
+            static constexpr bool isBitPacked(void) { return codecClass::isBitPacked(); }
+
+            static Kiaro::Common::U32 getBits(void) { return codecClass::getBits(); }
+
+            static constexpr Kiaro::Common::U32 getSchemaID(void) { return codecClass::getSchemaID(); }
+        };
+
+        /**
+         *  @brief The serialized fields of a class, in the order they are written. Everything about serializing them is
+         *  generated from the list: packing, unpacking in reverse as BitStream requires, the exact size, which fields
+         *  changed since their values were last committed and a hash of the layout. Every field is a call to a static method known at
+         *  compile time, so the whole list inlines down to the same writes and reads as doing it by hand.
+         *  @details Field masks have the first field in the lowest bit, so a list can have at most 32 fields. The sizes
+         *  assume the list starts on a byte boundary, as it does after anything but bit packed writes.
+         */
+        template <typename... fieldClasses>
+        struct FieldList;
+
+        //! The end of every field list.
+        template <>
+        struct FieldList<>
+        {
+            struct Values { };
+
+            template <typename ownerClass>
+            static void pack(const ownerClass &owner, Kiaro::Support::BitStream &out) { }
+
+            template <typename ownerClass>
+            static void unpack(ownerClass &owner, Kiaro::Support::BitStream &in) { }
+
+            template <typename ownerClass>
+            static void packFields(const ownerClass &owner, const Kiaro::Common::U32 &mask, Kiaro::Support::BitStream &out) { }
+
+            template <typename ownerClass>
+            static void unpackFields(ownerClass &owner, const Kiaro::Common::U32 &mask, Kiaro::Support::BitStream &in) { }
+
+            template <typename ownerClass>
+            static Kiaro::Common::U32 getDirtyMask(const ownerClass &owner, const Values &committed) { return 0; }
+
+            template <typename ownerClass>
+            static void store(const ownerClass &owner, Values &committed) { }
+
+            static Kiaro::Common::U32 getSize(const Kiaro::Common::U32 &mask = 0xFFFFFFFF, const Kiaro::Common::U32 &runBits = 0)
+            {
+                return (runBits + 7) / 8;
+            }
+
+            static constexpr Kiaro::Common::U32 getCount(void) { return 0; }
+
+            static constexpr Kiaro::Common::U32 getSchemaHash(const Kiaro::Common::U32 hash = Kiaro::Support::sSchemaHashBasis) { return hash; }
+        };
+
+        template <typename fieldClass, typename... remainingFieldClasses>
+        struct FieldList<fieldClass, remainingFieldClasses...>
+        {
+            typedef Kiaro::Support::FieldList<remainingFieldClasses...> Remaining;
+
+            static_assert(sizeof...(remainingFieldClasses) < 32, "FieldList: A field list can have at most 32 fields!");
+
+            //! A copy of the value of every field, to tell later which of them changed since.
+            struct Values
+            {
+                Values(void) : mValue(), mRemaining() { }
+
+                typename fieldClass::Value mValue;
+                typename Remaining::Values mRemaining;
+            };
+
+            //! Writes every field.
+            template <typename ownerClass>
+            static void pack(const ownerClass &owner, Kiaro::Support::BitStream &out)
+            {
+                fieldClass::pack(owner, out);
+                Remaining::pack(owner, out);
+            }
+
+            //! Reads every field written by pack.
+            template <typename ownerClass>
+            static void unpack(ownerClass &owner, Kiaro::Support::BitStream &in)
+            {
+                Remaining::unpack(owner, in);
+                fieldClass::unpack(owner, in);
+            }
+
+            //! Writes only the fields in the mask.
+            template <typename ownerClass>
+            static void packFields(const ownerClass &owner, const Kiaro::Common::U32 &mask, Kiaro::Support::BitStream &out)
+            {
+                if (mask & 1)
+                    fieldClass::pack(owner, out);
+
+                Remaining::packFields(owner, mask >> 1, out);
+            }
+
+            //! Reads the fields written by packFields with the same mask, leaving the rest as they are.
+            template <typename ownerClass>
+            static void unpackFields(ownerClass &owner, const Kiaro::Common::U32 &mask, Kiaro::Support::BitStream &in)
+            {
+                Remaining::unpackFields(owner, mask >> 1, in);
+
+                if (mask & 1)
+                    fieldClass::unpack(owner, in);
+            }
+
+            //! Returns the mask of the fields whose values differ from the committed ones.
+            template <typename ownerClass>
+            static Kiaro::Common::U32 getDirtyMask(const ownerClass &owner, const Values &committed)
+            {
+                return (fieldClass::isEqual(owner, committed.mValue) ? 0 : 1) | (Remaining::getDirtyMask(owner, committed.mRemaining) << 1);
+            }
+
+            //! Copies the value of every field.
+            template <typename ownerClass>
+            static void store(const ownerClass &owner, Values &committed)
+            {
+                committed.mValue = fieldClass::get(owner);
+                Remaining::store(owner, committed.mRemaining);
+            }
+
+            /**
+             *  @brief Returns the mask of the fields whose values differ from the committed ones, then commits the
+             *  current values in their place.
+             */
+            template <typename ownerClass>
+            static Kiaro::Common::U32 commit(const ownerClass &owner, Values &committed)
+            {
+                const Kiaro::Common::U32 result = getDirtyMask(owner, committed);
+                store(owner, committed);
+
+                return result;
+            }
+
+            /**
+             *  @brief Returns the exact number of bytes that packing the fields in the mask writes.
+             *  @param runBits The number of bits written so far in the current run of bit packed fields.
+             */
+            static Kiaro::Common::U32 getSize(const Kiaro::Common::U32 &mask = 0xFFFFFFFF, const Kiaro::Common::U32 &runBits = 0)
+            {
+                if (!(mask & 1))
+                    return Remaining::getSize(mask >> 1, runBits);
+
+                // Bit packed fields share bytes until something byte sized closes off their run
+                if (fieldClass::isBitPacked())
+                    return Remaining::getSize(mask >> 1, runBits + fieldClass::getBits());
+
+                return (runBits + 7) / 8 + fieldClass::getBits() / 8 + Remaining::getSize(mask >> 1, 0);
+            }
+
+            //! Returns the number of fields.
+            static constexpr Kiaro::Common::U32 getCount(void) { return 1 + Remaining::getCount(); }
+
+            //! Returns a hash of the codecs of the fields in order, which changes whenever the layout does.
+            static constexpr Kiaro::Common::U32 getSchemaHash(const Kiaro::Common::U32 hash = Kiaro::Support::sSchemaHashBasis)
+            {
+                return Remaining::getSchemaHash(Kiaro::Support::hashSchemaID(hash, fieldClass::getSchemaID()));
+            }
+        };
+    } // End Namespace Support
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_SUPPORT_FIELDLIST_HPP_
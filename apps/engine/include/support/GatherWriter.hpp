@@ -0,0 +1,97 @@
+/**
+ *  @file GatherWriter.hpp
+ *  @brief Include file defining the Kiaro::Support::GatherWriter class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_SUPPORT_GATHERWRITER_HPP_
+#define _INCLUDE_KIARO_SUPPORT_GATHERWRITER_HPP_
+
+#include <vector>
+
+#include <engine/Common.hpp>
+#include <support/BitStream.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief Composes a message out of bytes of its own and references to bytes held elsewhere, such as entity state
+         *  that has already been serialized once and is sent to many clients.
+         *  @details Whatever is written to getStream and whatever is passed to reference end up in the message in the
+         *  order they were added. Referenced bytes are not copied until gather puts the whole message together in its
+         *  final destination, so they must stay alive and unchanged until then.
+         */
+        class GatherWriter
+        {
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the initial capacity of the bytes the writer holds itself.
+                 *  @param initialCapacity The number of bytes to allocate up front.
+                 */
+                GatherWriter(const size_t &initialCapacity = 64);
+
+                //! Returns the stream to write the writer's own bytes to.
+                Kiaro::Support::BitStream &getStream(void) { return mStream; }
+
+                /**
+                 *  @brief Adds bytes held elsewhere to the message without copying them.
+                 *  @param data A pointer to the bytes, which must outlive the next call to gather.
+                 *  @param length The number of bytes.
+                 */
+                void reference(const void *data, const size_t &length);
+
+                /**
+                 *  @brief Returns the length of the complete message.
+                 *  @return A size_t representing the length of the message in bytes.
+                 */
+                size_t length(void);
+
+                /**
+                 *  @brief Copies the complete message into the given memory.
+                 *  @param destination Where to put the message, which must have room for length() bytes.
+                 *  @note The message may be gathered any number of times, but must be cleared before it is written to again.
+                 */
+                void gather(Kiaro::Common::U8 *destination);
+
+                //! Empties the writer while keeping its allocated memory so that it may be reused.
+                void clear(void);
+
+            // Private Methods
+            private:
+                //! Makes the bytes written to mStream since the last segment into a segment of their own.
+                void closeOwnedSegment(void);
+
+            // Private Members
+            private:
+                //! A run of bytes in the message.
+                struct Segment
+                {
+                    //! The referenced bytes, or NULL if the bytes are the writer's own.
+                    const Kiaro::Common::U8 *mData;
+                    //! Where the bytes start in mStream, if they are the writer's own.
+                    size_t mOffset;
+                    size_t mLength;
+                };
+
+                //! The writer's own bytes. Segments refer to them by offset since the stream may move them when it grows.
+                Kiaro::Support::BitStream mStream;
+                std::vector<Segment> mSegments;
+
+                //! The offset in mStream of the first byte that is not yet part of a segment.
+                size_t mOwnedStart;
+                //! The number of bytes in the message that are referenced rather than held.
+                size_t mReferencedLength;
+        };
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_KIARO_SUPPORT_GATHERWRITER_HPP_
@@ -0,0 +1,143 @@
+/**
+ *  @file InterpolationBuffer.hpp
+ *  @brief Include file defining and providing logic for the Kiaro::Support::InterpolationBuffer template class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_SUPPORT_INTERPOLATIONBUFFER_HPP_
+#define _INCLUDE_KIARO_SUPPORT_INTERPOLATIONBUFFER_HPP_
+
+#include <stddef.h>
+
+#include <algorithm>
+
+#include <engine/Common.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief Keeps the last few timestamped values of something that changes over time, such as the position of a
+         *  replicated entity, so that it can be sampled at any time in between them.
+         *  @details The stored type needs to support addition and subtraction with itself and multiplication by a
+         *  Kiaro::Common::F32. Times are in milliseconds and may wrap around; they are only ever compared by their
+         *  difference.
+         */
+        template <typename storedType, size_t capacity>
+        class InterpolationBuffer
+        {
+            static_assert(capacity >= 2, "InterpolationBuffer: The capacity must be at least two!");
+
+            // Public Methods
+            public:
+                //! Standard constructor.
+                InterpolationBuffer(void) : mNewest(0), mCount(0) { }
+
+                /**
+                 *  @brief Adds a value. A value at the same time as the newest one replaces it, and anything older than
+                 *  that arrived out of order and is ignored.
+                 *  @param time The time of the value in milliseconds.
+                 *  @param value The value.
+                 */
+                void push(const Kiaro::Common::U32 &time, const storedType &value)
+                {
+                    if (mCount > 0)
+                    {
+                        const Kiaro::Common::S32 age = (Kiaro::Common::S32)(mSamples[mNewest].mTime - time);
+
+                        if (age > 0)
+                            return;
+                        else if (age == 0)
+                        {
+                            mSamples[mNewest].mValue = value;
+                            return;
+                        }
+
+                        mNewest = (mNewest + 1) % capacity;
+                    }
+
+                    mSamples[mNewest].mTime = time;
+                    mSamples[mNewest].mValue = value;
+                    mCount = std::min(mCount + 1, capacity);
+                }
+
+                /**
+                 *  @brief Works out the value at some time. In between two values it is interpolated; past the newest it is
+                 *  extrapolated from the newest two for a while and then held, and before the oldest the oldest is used.
+                 *  @param time The time to sample at in milliseconds.
+                 *  @param maximumExtrapolation How far past the newest value in milliseconds to keep extrapolating.
+                 *  @param out The value is written here.
+                 *  @return A boolean representing whether or not there was anything to sample.
+                 */
+                bool sample(const Kiaro::Common::U32 &time, const Kiaro::Common::U32 &maximumExtrapolation, storedType &out) const
+                {
+                    if (mCount == 0)
+                        return false;
+
+                    // Walk back from the newest value to the first one at or before the time
+                    for (size_t age = 0; age < mCount; age++)
+                    {
+                        const Sample &earlier = getSample(age);
+                        const Kiaro::Common::S32 elapsed = (Kiaro::Common::S32)(time - earlier.mTime);
+
+                        if (elapsed < 0)
+                            continue;
+
+                        if (age == 0)
+                        {
+                            if (mCount < 2)
+                            {
+                                out = earlier.mValue;
+                                return true;
+                            }
+
+                            const Sample &previous = getSample(1);
+                            const Kiaro::Common::F32 extrapolated = std::min<Kiaro::Common::U32>(elapsed, maximumExtrapolation);
+
+                            out = earlier.mValue + (earlier.mValue - previous.mValue) * (extrapolated / (Kiaro::Common::F32)(earlier.mTime - previous.mTime));
+                            return true;
+                        }
+
+                        const Sample &later = getSample(age - 1);
+                        out = earlier.mValue + (later.mValue - earlier.mValue) * (elapsed / (Kiaro::Common::F32)(later.mTime - earlier.mTime));
+                        return true;
+                    }
+
+                    out = getSample(mCount - 1).mValue;
+                    return true;
+                }
+
+                //! Forgets every value.
+                void clear(void) { mCount = 0; }
+
+                //! Returns whether or not there are no values.
+                bool empty(void) const { return mCount == 0; }
+
+            // Private Members
+            private:
+                //! A single timestamped value.
+                struct Sample
+                {
+                    Kiaro::Common::U32 mTime;
+                    storedType mValue;
+                };
+
+                //! Returns the value that many values older than the newest one.
+                const Sample &getSample(const size_t &age) const { return mSamples[(mNewest + capacity - age) % capacity]; }
+
+                Sample mSamples[capacity];
+                //! The slot of the newest value.
+                size_t mNewest;
+                size_t mCount;
+        };
+    } // End Namespace Support
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_SUPPORT_INTERPOLATIONBUFFER_HPP_
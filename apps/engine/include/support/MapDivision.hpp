@@ -14,14 +14,20 @@
 #ifndef _INCLUDE_KIARO_SUPPORT_MAPDIVISION_HPP_
 #define _INCLUDE_KIARO_SUPPORT_MAPDIVISION_HPP_
 
+#include <map>
+#include <vector>
+
 #include <engine/Common.hpp>
 
 namespace Kiaro
 {
-    namespace CES
+    namespace Game
     {
-        class Entity;
-    } // End NameSpace CES
+        namespace Entities
+        {
+            class EntityBase;
+        } // End NameSpace Entities
+    } // End NameSpace Game
 
     namespace Support
     {
@@ -30,25 +36,69 @@ namespace Kiaro
             public:
                 MapDivisionSquare(void);
 
-                std::vector<Kiaro::CES::Entity*> mContents;
+                std::vector<Kiaro::Game::Entities::EntityBase*> mContents;
         }; // End Class MapDivisionSquare
 
+        /**
+         *  @brief A square grid over the map, kept at several levels of detail, that entities are sorted into by position.
+         *  @details The grid covers mResolution units along the X and Z axes, centered on the origin. LOD 0 is a single
+         *  square covering everything and every following LOD halves the size of the squares. Entities outside of the
+         *  grid are sorted into the nearest edge square.
+         */
         class MapDivision
         {
             // Public Methods
             public:
+                /**
+                 *  @brief Returns the MapDivision instance, creating it if necessary.
+                 *  @param power The grid covers 2^power units along each axis.
+                 *  @param divisions The number of LODs to build. This is capped to power, as the finest LOD never goes below 2x2 units.
+                 */
                 static MapDivision *Get(Kiaro::Common::U32 power = 12, Kiaro::Common::U32 divisions = 999);
                 static void Destroy(void);
 
+                /**
+                 *  @brief Sorts an entity into the grid, or moves it if it was already in there.
+                 *  @param entity The entity to sort.
+                 *  @param position The position of the entity.
+                 */
+                void insert(Kiaro::Game::Entities::EntityBase *entity, const Kiaro::Common::Vector3DF &position);
+
+                void remove(Kiaro::Game::Entities::EntityBase *entity);
+
+                /**
+                 *  @brief Collects every entity in the squares overlapping a circle on the X/Z plane.
+                 *  @param center The center of the circle.
+                 *  @param radius The radius of the circle.
+                 *  @param out The vector to append the entities to. Entities outside of the circle but in one of
+                 *  the overlapping squares are included, so callers should do their own distance checks.
+                 *  @note The finest LOD whose squares are no smaller than a quarter of the radius is used, so at most 9x9
+                 *  squares are visited. They cover far less of the grid outside of the circle than squares as large as the
+                 *  radius would.
+                 */
+                void query(const Kiaro::Common::Vector3DF &center, const Kiaro::Common::F32 &radius, std::vector<Kiaro::Game::Entities::EntityBase*> &out);
+
+                //! The number of LODs in the grid.
                 const Kiaro::Common::U32 mDivisions;
+                //! The number of units the grid covers along each axis.
                 const size_t mResolution;
 
-            // Private Members
+            // Private Methods
             private:
                 MapDivision(Kiaro::Common::U32 power, Kiaro::Common::U32 divisions = 999);
 
+                //! Returns the index of the square along one axis of the given LOD that a coordinate falls into.
+                Kiaro::Common::U32 getSquareIndex(const Kiaro::Common::F32 &coordinate, const Kiaro::Common::U32 &lod);
+
+                void removeFromSquares(Kiaro::Game::Entities::EntityBase *entity, const Kiaro::Common::U32 &finestX, const Kiaro::Common::U32 &finestY);
+
+            // Private Members
+            private:
                 //! 3D Array: LOD,X,Y
                 std::vector<std::vector<std::vector<MapDivisionSquare>>> mLODs;
+
+                //! The square in the finest LOD that each entity is in. Its squares in coarser LODs follow by halving.
+                std::map<Kiaro::Game::Entities::EntityBase*, std::pair<Kiaro::Common::U32, Kiaro::Common::U32> > mEntitySquares;
         }; // End Class MapDivision
     } // End NameSpace Support
 } // End NameSpace Kiaro
@@ -0,0 +1,91 @@
+/**
+ *  @file RingBuffer.hpp
+ *  @brief Include file defining and providing logic for the Kiaro::Support::RingBuffer template class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#ifndef _INCLUDE_KIARO_SUPPORT_RINGBUFFER_HPP_
+#define _INCLUDE_KIARO_SUPPORT_RINGBUFFER_HPP_
+
+#include <stddef.h>
+
+#include <atomic>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief A bounded queue that one thread pushes onto while another thread pops off of, without any locking.
+         *  @details Exactly one thread may call push and full and exactly one other thread may call pop and empty. The
+         *  head and tail only ever count up; an element's slot is its position modulo the capacity.
+         */
+        template <typename storedType, size_t capacity>
+        class RingBuffer
+        {
+            static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "RingBuffer: The capacity must be a power of two!");
+
+            // Public Methods
+            public:
+                //! Standard constructor.
+                RingBuffer(void) : mHead(0), mTail(0) { }
+
+                /**
+                 *  @brief Pushes an element onto the end of the queue. Only the producing thread may call this.
+                 *  @param element The element to push.
+                 *  @return A boolean representing whether or not there was room for the element.
+                 */
+                bool push(const storedType &element)
+                {
+                    const size_t tail = mTail.load(std::memory_order_relaxed);
+                    if (tail - mHead.load(std::memory_order_acquire) == capacity)
+                        return false;
+
+                    mElements[tail & (capacity - 1)] = element;
+                    mTail.store(tail + 1, std::memory_order_release);
+
+                    return true;
+                }
+
+                /**
+                 *  @brief Pops the element at the front of the queue. Only the consuming thread may call this.
+                 *  @param out The popped element is written here.
+                 *  @return A boolean representing whether or not there was anything to pop.
+                 */
+                bool pop(storedType &out)
+                {
+                    const size_t head = mHead.load(std::memory_order_relaxed);
+                    if (head == mTail.load(std::memory_order_acquire))
+                        return false;
+
+                    out = mElements[head & (capacity - 1)];
+                    mHead.store(head + 1, std::memory_order_release);
+
+                    return true;
+                }
+
+                //! Returns whether or not the queue is full. Only meaningful to the producing thread.
+                bool full(void) const { return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_acquire) == capacity; }
+
+                //! Returns whether or not the queue is empty. Only meaningful to the consuming thread.
+                bool empty(void) const { return mHead.load(std::memory_order_relaxed) == mTail.load(std::memory_order_acquire); }
+
+            // Private Members
+            private:
+                storedType mElements[capacity];
+
+                //! The number of elements ever popped. Only written by the consuming thread.
+                std::atomic<size_t> mHead;
+                //! The number of elements ever pushed. Only written by the producing thread.
+                std::atomic<size_t> mTail;
+        };
+    } // End Namespace Support
+} // End Namespace Kiaro
+#endif // _INCLUDE_KIARO_SUPPORT_RINGBUFFER_HPP_
@@ -12,6 +12,8 @@
  */
 
 #include <iostream>
+#include <cstdlib>
+#include <stdexcept>
 
 #include <physfs.h>
 
@@ -24,8 +26,12 @@
 #include <engine/Logging.hpp>
 
 #include <engine/Common.hpp>
+#include <engine/Config.hpp>
 #include <engine/CoreSingleton.hpp>
 
+#include <game/LoadGenerator.hpp>
+#include <game/DemoReplay.hpp>
+
 #include <support/CommandLineParser.hpp>
 #include <support/MapDivision.hpp>
 #include <support/SchedulerSingleton.hpp>
@@ -69,11 +75,91 @@ static void gameFlagHandler(Kiaro::Support::CommandLineParser *parser, Kiaro::Co
     engineInstance->setMode(engineMode);
     engineInstance->setTargetServer((char*)targetServerIP.c_str(), 11595);
     engineInstance->setGame(arguments[0]);
+    engineInstance->setNetworkThreaded(parser->hasFlag("-netthread"));
+
+    // Check for the -netstats [seconds] [file] flag
+    if (parser->hasFlag("-netstats"))
+    {
+        const std::string interval = parser->getFlagArgument("-netstats", 0);
+        engineInstance->setStatisticsOutput(interval.empty() ? NETWORK_STATISTICS_INTERVAL : std::atoi(interval.c_str()), parser->getFlagArgument("-netstats", 1));
+    }
+
+    // Check for the -record <file> flag
+    if (parser->hasFlag("-record"))
+        engineInstance->setDemoRecording(parser->getFlagArgument("-record", 0));
+
     engineInstance->run(0, argv);
 
     Kiaro::Engine::CoreSingleton::destroy();
 }
 
+static void loadTestFlagHandler(Kiaro::Support::CommandLineParser *parser, Kiaro::Common::C8 *argv[], const std::vector<std::string> &arguments, bool otherFlags)
+{
+    if (otherFlags)
+        return;
+
+    if (arguments.empty() || arguments.size() > 3)
+    {
+        std::cerr << "No bot count specified." << std::endl << std::endl;
+
+        parser->displayHelp(parser, argv, arguments, otherFlags);
+        return;
+    }
+
+    Kiaro::Game::LoadSettings settings;
+    settings.mBotCount = std::atoi(arguments[0].c_str());
+
+    if (arguments.size() >= 2)
+        settings.mInputRate = std::atoi(arguments[1].c_str());
+    if (arguments.size() >= 3)
+        settings.mDuration = std::atoi(arguments[2].c_str());
+
+    // Load a running server rather than one of our own
+    if (parser->hasFlag("-server"))
+        settings.mTargetAddress = parser->getFlagArgument("-server", 0);
+
+    settings.mNetworkThreaded = parser->hasFlag("-netthread");
+
+    enet_initialize();
+
+    Kiaro::Game::LoadGenerator *generator = new Kiaro::Game::LoadGenerator(settings);
+    generator->run();
+    delete generator;
+
+    enet_deinitialize();
+}
+
+static void replayFlagHandler(Kiaro::Support::CommandLineParser *parser, Kiaro::Common::C8 *argv[], const std::vector<std::string> &arguments, bool otherFlags)
+{
+    if (otherFlags)
+        return;
+
+    if (arguments.empty() || arguments.size() > 2)
+    {
+        std::cerr << "No demo file specified." << std::endl << std::endl;
+
+        parser->displayHelp(parser, argv, arguments, otherFlags);
+        return;
+    }
+
+    const bool realTime = arguments.size() == 2 && arguments[1] == "realtime";
+
+    enet_initialize();
+
+    try
+    {
+        Kiaro::Game::DemoReplay *replay = new Kiaro::Game::DemoReplay(arguments[0], realTime);
+        replay->run();
+        delete replay;
+    }
+    catch (std::runtime_error &e)
+    {
+        std::cerr << "Failed to replay '" << arguments[0] << "': " << e.what() << std::endl;
+    }
+
+    enet_deinitialize();
+}
+
 #if ENGINE_TESTS>0
 static void testsFlagHandler(Kiaro::Support::CommandLineParser *parser, Kiaro::Common::C8 *argv[], const std::vector<std::string> &arguments, bool otherFlags)
 {
@@ -187,6 +273,36 @@ Kiaro::Common::S32 main(Kiaro::Common::S32 argc, Kiaro::Common::C8 *argv[])
     currentFlagEntry->responder = NULL; // No Responder
     commandLineParser.setFlagResponder(currentFlagEntry);
 
+    currentFlagEntry = new Kiaro::Support::CommandLineParser::FlagEntry;
+    currentFlagEntry->name = "-netthread";
+    currentFlagEntry->description = "Service the network on a thread of its own rather than once per frame.";
+    currentFlagEntry->responder = NULL; // No Responder
+    commandLineParser.setFlagResponder(currentFlagEntry);
+
+    currentFlagEntry = new Kiaro::Support::CommandLineParser::FlagEntry;
+    currentFlagEntry->name = "-netstats";
+    currentFlagEntry->description = "[seconds] [file] : Periodically write the network statistics of every client on a dedicated server to the log or a file.";
+    currentFlagEntry->responder = NULL; // No Responder
+    commandLineParser.setFlagResponder(currentFlagEntry);
+
+    currentFlagEntry = new Kiaro::Support::CommandLineParser::FlagEntry;
+    currentFlagEntry->name = "-loadtest";
+    currentFlagEntry->description = "<bots> [inputs per second] [seconds] : Load a server with headless bots and report how it held up.";
+    currentFlagEntry->responder = new Kiaro::Support::CommandLineParser::FlagResponder::StaticDelegateType(loadTestFlagHandler);
+    commandLineParser.setFlagResponder(currentFlagEntry);
+
+    currentFlagEntry = new Kiaro::Support::CommandLineParser::FlagEntry;
+    currentFlagEntry->name = "-record";
+    currentFlagEntry->description = "<file> : Record every packet received by the client or the server to a demo file.";
+    currentFlagEntry->responder = NULL; // No Responder
+    commandLineParser.setFlagResponder(currentFlagEntry);
+
+    currentFlagEntry = new Kiaro::Support::CommandLineParser::FlagEntry;
+    currentFlagEntry->name = "-replay";
+    currentFlagEntry->description = "<file> [realtime] : Feed a demo file back through the packet handlers as fast as possible, or in real time, and report how long it took.";
+    currentFlagEntry->responder = new Kiaro::Support::CommandLineParser::FlagResponder::StaticDelegateType(replayFlagHandler);
+    commandLineParser.setFlagResponder(currentFlagEntry);
+
     currentFlagEntry = new Kiaro::Support::CommandLineParser::FlagEntry;
     currentFlagEntry->name = "-v";
     currentFlagEntry->description = "Print versioning information.";
@@ -11,6 +11,10 @@
  *  @copyright (c) 2014 Draconic Entertainment
  */
 
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
 #include <engine/CoreSingleton.hpp>
 
 #include <irrlicht.h>
@@ -70,6 +74,22 @@ namespace Kiaro
             mTargetServerPort = port;
         }
 
+        void CoreSingleton::setNetworkThreaded(const bool &networkThreaded)
+        {
+            mNetworkThreaded = networkThreaded;
+        }
+
+        void CoreSingleton::setStatisticsOutput(const Kiaro::Common::U32 &interval, const std::string &fileName)
+        {
+            mStatisticsInterval = interval;
+            mStatisticsFileName = fileName;
+        }
+
+        void CoreSingleton::setDemoRecording(const std::string &fileName)
+        {
+            mDemoFileName = fileName;
+        }
+
         void CoreSingleton::setGame(const std::string &gameName)
         {
             mGameName = gameName;
@@ -107,25 +127,42 @@ namespace Kiaro
                 case Kiaro::ENGINE_CLIENTCONNECT:
                 {
                     mClient = Kiaro::Game::OutgoingClientSingleton::getPointer();
-                    mClient->connect(mTargetServerAddress, mTargetServerPort, 5000);
-
-                    if (!mClient->isConnected())
-                    {
-                        std::cerr << "EngineInstance: Failed to connect to remote host with server flag" << std::endl;
+                    mClient->setUsesNetworkThread(mNetworkThreaded);
 
-                        return 1;
-                    }
+                    // This only starts the connection; the main loop keeps running while it is made
+                    mClient->connect(mTargetServerAddress, mTargetServerPort);
                     break;
                 }
                 case Kiaro::ENGINE_DEDICATED:
                 {
                     videoDriver = irr::video::EDT_NULL;
-                    mServer = Kiaro::Game::ServerSingleton::getPointer("0.0.0.0", 11595, 32);
+                    mServer = Kiaro::Game::ServerSingleton::getPointer("0.0.0.0", 11595, NETWORK_MAXIMUM_CLIENTS);
+
+                    if (mNetworkThreaded)
+                        mServer->startNetworkThread();
 
                     break;
                 }
             }
 
+            // Nothing has been received yet, so the demo misses nothing
+            if (!mDemoFileName.empty())
+            {
+                try
+                {
+                    if (mServer)
+                        mServer->startRecording(mDemoFileName);
+                    else
+                        mClient->startRecording(mDemoFileName);
+
+                    std::cout << "EngineInstance: Recording a demo to '" << mDemoFileName << "'" << std::endl;
+                }
+                catch (std::runtime_error &e)
+                {
+                    std::cerr << "EngineInstance: Failed to start recording to '" << mDemoFileName << "': " << e.what() << std::endl;
+                }
+            }
+
             // Init the Input listener
             Kiaro::Engine::InputListenerSingleton *inputListener = Kiaro::Engine::InputListenerSingleton::getPointer();
 
@@ -164,8 +201,23 @@ namespace Kiaro
 
             irr::core::dimension2d<irr::u32> lastDisplaySize = mIrrlichtDevice->getVideoDriver()->getScreenSize();
 
+            // Statistics go to the log unless they were given a file of their own
+            std::ofstream statisticsFile;
+            if (mServer && mStatisticsInterval && !mStatisticsFileName.empty())
+            {
+                statisticsFile.open(mStatisticsFileName.c_str(), std::ios::out | std::ios::app);
+
+                if (!statisticsFile.is_open())
+                    std::cerr << "EngineInstance: Failed to open network statistics file '" << mStatisticsFileName << "'; writing them to the log" << std::endl;
+            }
+
+            std::ostream &statisticsStream = statisticsFile.is_open() ? (std::ostream &)statisticsFile : std::cout;
+            const Kiaro::Common::U64 statisticsInterval = mStatisticsInterval * 1000000ULL;
+            Kiaro::Common::U64 nextStatisticsTime = Kiaro::Support::Time::getCurrentTimeMicroseconds() + statisticsInterval;
+
             // Start the Loop
             Kiaro::Common::F32 deltaTimeSeconds = 0.0f;
+            bool awaitingConnection = mEngineMode == Kiaro::ENGINE_CLIENTCONNECT;
 
             while (mRunning && mIrrlichtDevice->run())
             {
@@ -188,9 +240,39 @@ namespace Kiaro
                         }
 
                         CEGUI::System::getSingleton().injectTimePulse(deltaTimeSeconds);
+
+                        // Our own player moves before the frame is sent off rather than a round trip later
+                        Kiaro::Common::U8 buttons = 0;
+                        if (inputListener->isKeyDown(irr::KEY_KEY_W))
+                            buttons |= Kiaro::Game::INPUT_FORWARD;
+                        if (inputListener->isKeyDown(irr::KEY_KEY_S))
+                            buttons |= Kiaro::Game::INPUT_BACKWARD;
+                        if (inputListener->isKeyDown(irr::KEY_KEY_A))
+                            buttons |= Kiaro::Game::INPUT_LEFT;
+                        if (inputListener->isKeyDown(irr::KEY_KEY_D))
+                            buttons |= Kiaro::Game::INPUT_RIGHT;
+
+                        const Kiaro::Common::U32 frameMilliseconds = (Kiaro::Common::U32)(deltaTimeSeconds * 1000.0f);
+                        mClient->sendInput(buttons, std::min<Kiaro::Common::U32>(std::max<Kiaro::Common::U32>(frameMilliseconds, 1), 255));
+
                         mClient->update();
+                        mClient->dispatch();
+
+                        // There's nothing to fall back on if the server given with the server flag can't be reached
+                        if (awaitingConnection && mClient->getConnectionState() != Kiaro::Network::CONNECTION_CONNECTING)
+                        {
+                            awaitingConnection = false;
+
+                            if (!mClient->isConnected())
+                            {
+                                std::cerr << "EngineInstance: Failed to connect to remote host with server flag" << std::endl;
+                                mRunning = false;
+                            }
+                        }
 
                         // Since we're a client, render the frame right after updating
+                        mClient->interpolate();
+
                         mIrrlichtDevice->getVideoDriver()->beginScene(true, true, mClearColor);
                         mIrrlichtDevice->getSceneManager()->drawAll();
 
@@ -200,7 +282,19 @@ namespace Kiaro
                     }
 
                     if (mServer)
+                    {
                         mServer->update();
+                        mServer->dispatch();
+
+                        const Kiaro::Common::U64 currentTime = Kiaro::Support::Time::getCurrentTimeMicroseconds();
+                        if (statisticsInterval && currentTime >= nextStatisticsTime)
+                        {
+                            mServer->writeStatistics(statisticsStream);
+                            statisticsStream.flush();
+
+                            nextStatisticsTime = currentTime + statisticsInterval;
+                        }
+                    }
 
                     // Make sure that it takes at least 32ms to complete a single tick to help make sync easier, but only
                     // if we're actually running a sim. If we're not, we shouldn't have to enforce the tickrate
@@ -239,8 +333,8 @@ namespace Kiaro
             mRunning = false;
         }
 
-        CoreSingleton::CoreSingleton(void) : mEngineMode(Kiaro::ENGINE_CLIENT), mIrrlichtDevice(0x00), mTargetServerAddress("127.0.0.1"), mTargetServerPort(11595), mClient(NULL), mServer(NULL),
-        mRunning(false), mClearColor(Kiaro::Common::ColorRGBA(0, 0, 0, 0))
+        CoreSingleton::CoreSingleton(void) : mEngineMode(Kiaro::ENGINE_CLIENT), mIrrlichtDevice(0x00), mTargetServerAddress("127.0.0.1"), mTargetServerPort(11595), mClient(NULL), mServer(NULL), mNetworkThreaded(false),
+        mStatisticsInterval(0), mRunning(false), mClearColor(Kiaro::Common::ColorRGBA(0, 0, 0, 0))
         {
 
         }
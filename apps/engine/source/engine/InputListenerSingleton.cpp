@@ -37,7 +37,11 @@ namespace Kiaro
             InputListenerSingleton_Instance = NULL;
         }
 
-        InputListenerSingleton::InputListenerSingleton(void) { }
+        InputListenerSingleton::InputListenerSingleton(void)
+        {
+            for (irr::u32 iteration = 0; iteration < irr::KEY_KEY_CODES_COUNT; iteration++)
+                mKeyStates[iteration] = false;
+        }
 
         InputListenerSingleton::~InputListenerSingleton(void) { }
 
@@ -68,6 +72,10 @@ namespace Kiaro
                     }
                 }
             }
+            else if (event.EventType == irr::EET_KEY_INPUT_EVENT)
+                mKeyStates[event.KeyInput.Key] = event.KeyInput.PressedDown;
+
+            return false;
         }
     } // End Namespace Game
 } // End Namespace Kiaro
@@ -0,0 +1,134 @@
+/**
+ *  @file BotClient.cpp
+ *  @brief Source code file defining logic for the Kiaro::Game::BotClient class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/5/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <iostream>
+#include <algorithm>
+
+#include <support/BitStream.hpp>
+
+#include <game/BotClient.hpp>
+#include <game/packets/packets.hpp>
+#include <game/entities/EntityBase.hpp>
+
+#include <engine/Config.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        BotClient::BotClient(const Kiaro::Common::U64 &inputInterval, const Kiaro::Common::U64 &firstInputTime) : mInputInterval(inputInterval),
+        mNextInputTime(firstInputTime), mCurrentTime(0), mPingsSent(0), mInputSequence(0)
+        {
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::HandShake>(new EasyDelegate::MemberDelegate<BotClient, void, Kiaro::Game::Packets::HandShake &>(this, &BotClient::onHandShake));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::Snapshot>(new EasyDelegate::MemberDelegate<BotClient, void, Kiaro::Game::Packets::Snapshot &>(this, &BotClient::onSnapshot));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::Ping>(new EasyDelegate::MemberDelegate<BotClient, void, Kiaro::Game::Packets::Ping &>(this, &BotClient::onPing));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::ControlEntity>(new EasyDelegate::MemberDelegate<BotClient, void, Kiaro::Game::Packets::ControlEntity &>(this, &BotClient::onControlEntity));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::StringTableUpdate>(new EasyDelegate::MemberDelegate<BotClient, void, Kiaro::Game::Packets::StringTableUpdate &>(this, &BotClient::onStringTableUpdate));
+        }
+
+        BotClient::~BotClient(void)
+        {
+
+        }
+
+        void BotClient::update(const Kiaro::Common::U64 &currentTime)
+        {
+            mCurrentTime = currentTime;
+            Kiaro::Network::OutgoingClientBase::update();
+
+            if (!isReady() || currentTime < mNextInputTime)
+                return;
+
+            sendInput();
+
+            Kiaro::Game::Packets::Ping ping;
+            ping.mSequence = mPingsSent++;
+            ping.mTimestamp = currentTime;
+            send(&ping);
+
+            // Keep to the schedule even if an update came late, but never try to catch up on missed inputs
+            mNextInputTime += mInputInterval;
+            if (mNextInputTime <= currentTime)
+                mNextInputTime += ((currentTime - mNextInputTime) / mInputInterval + 1) * mInputInterval;
+        }
+
+        void BotClient::onReceivePacket(Kiaro::Support::BitStream &incomingStream)
+        {
+            mPacketRegistry.dispatch(incomingStream, NULL, mCurrentStage, &mStatistics);
+        }
+
+        void BotClient::onConnected(void)
+        {
+            Kiaro::Game::Packets::HandShake handShake;
+            handShake.mVersionMajor = 1;
+            handShake.mVersionMinor = 2;
+            handShake.mVersionRevision = 3;
+            handShake.mVersionBuild = 4;
+            handShake.mSchemaHash = Kiaro::Game::Entities::getSchemaHash();
+
+            send(&handShake);
+        }
+
+        void BotClient::onDisconnected(void)
+        {
+            mCurrentStage = 0;
+
+            mInputSequence = 0;
+            mRecentInputs.clear();
+        }
+
+        void BotClient::onConnectFailed(void)
+        {
+            std::cerr << "BotClient: Failed to connect to the server" << std::endl;
+        }
+
+        void BotClient::onHandShake(Kiaro::Game::Packets::HandShake &packet)
+        {
+            mCurrentStage = 1;
+        }
+
+        void BotClient::onSnapshot(Kiaro::Game::Packets::Snapshot &packet)
+        {
+            // Acknowledge it as a real client would, so that the server sends deltas, but don't bother applying it
+            Kiaro::Game::Packets::SnapshotAck ack;
+            ack.mSequence = packet.mSequence;
+            send(&ack);
+        }
+
+        void BotClient::onPing(Kiaro::Game::Packets::Ping &packet)
+        {
+            if (packet.mTimestamp <= mCurrentTime)
+                mRoundTripTimes.push_back(mCurrentTime - packet.mTimestamp);
+        }
+
+        void BotClient::sendInput(void)
+        {
+            static const Kiaro::Common::U8 sSquareButtons[4] = { Kiaro::Game::INPUT_FORWARD, Kiaro::Game::INPUT_RIGHT, Kiaro::Game::INPUT_BACKWARD, Kiaro::Game::INPUT_LEFT };
+
+            Kiaro::Game::InputCommand command;
+            command.mSequence = ++mInputSequence;
+            command.mDuration = std::min<Kiaro::Common::U64>(std::max<Kiaro::Common::U64>(mInputInterval / 1000, 1), 255);
+
+            // Turn a corner about every second
+            command.mButtons = sSquareButtons[(mInputSequence * mInputInterval / 1000000) % 4];
+
+            mRecentInputs.push_back(command);
+            if (mRecentInputs.size() > NETWORK_INPUT_REDUNDANCY)
+                mRecentInputs.pop_front();
+
+            Kiaro::Game::Packets::Input input;
+            input.mCommands.assign(mRecentInputs.begin(), mRecentInputs.end());
+            send(&input);
+        }
+    } // End Namespace Game
+} // End Namespace Kiaro
@@ -0,0 +1,129 @@
+/**
+ *  @file DemoReplay.cpp
+ *  @brief Source code file defining logic for the Kiaro::Game::DemoReplay class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <iostream>
+
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <support/Time.hpp>
+
+#include <network/DemoFile.hpp>
+#include <network/LoopbackTransport.hpp>
+
+#include <game/DemoReplay.hpp>
+#include <game/ServerSingleton.hpp>
+#include <game/OutgoingClientSingleton.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        //! The length of a tick in microseconds, the same as a dedicated server's.
+        static const Kiaro::Common::U64 sTickMicroseconds = 32000;
+
+        DemoReplay::DemoReplay(const std::string &fileName, const bool &realTime) : mRealTime(realTime), mPlayer(new Kiaro::Network::DemoPlayer(fileName)),
+        mNetwork(NULL), mServer(NULL)
+        {
+            if (mPlayer->getSource() != Kiaro::Network::DEMO_SOURCE_SERVER)
+                return;
+
+            // Senders are told apart by port, so there can be as many as there are ports
+            mNetwork = new Kiaro::Network::LoopbackNetwork(0);
+            mServer = Kiaro::Game::ServerSingleton::getPointer(new Kiaro::Network::LoopbackTransport(mNetwork), 0x10000);
+        }
+
+        DemoReplay::~DemoReplay(void)
+        {
+            if (mServer)
+            {
+                mServer->stopReplay();
+                Kiaro::Game::ServerSingleton::destroy();
+            }
+
+            delete mNetwork;
+            delete mPlayer;
+        }
+
+        bool DemoReplay::run(void)
+        {
+            std::cout << "DemoReplay: Replaying a " << (mServer ? "server" : "client") << " demo " << (mRealTime ? "in real time" : "as fast as possible") << std::endl;
+
+            Kiaro::Game::OutgoingClientSingleton *client = mServer ? NULL : Kiaro::Game::OutgoingClientSingleton::getPointer();
+
+            Kiaro::Common::U64 recordCount = 0;
+            Kiaro::Common::U64 byteCount = 0;
+            Kiaro::Common::U64 demoTime = 0;
+            Kiaro::Common::U64 nextTickTime = sTickMicroseconds;
+
+            // One record is reused throughout so that its buffer only grows to the largest packet once
+            Kiaro::Network::DemoRecord record;
+
+            const Kiaro::Common::U64 startTime = Kiaro::Support::Time::getCurrentTimeMicroseconds();
+            while (mPlayer->read(record))
+            {
+                if (mRealTime)
+                {
+                    const Kiaro::Common::U64 elapsedTime = Kiaro::Support::Time::getCurrentTimeMicroseconds() - startTime;
+
+                    if (elapsedTime < record.mTime)
+                        boost::this_thread::sleep(boost::posix_time::microseconds(record.mTime - elapsedTime));
+                }
+
+                // Every tick that ran before this packet arrived runs before it is handled
+                while (nextTickTime <= record.mTime)
+                {
+                    tick();
+                    nextTickTime += sTickMicroseconds;
+                }
+
+                if (mServer)
+                    mServer->replay(record);
+                else
+                    client->replay(record);
+
+                recordCount++;
+                byteCount += record.mData.size();
+                demoTime = record.mTime;
+            }
+
+            tick();
+
+            const Kiaro::Common::F64 elapsedSeconds = (Kiaro::Support::Time::getCurrentTimeMicroseconds() - startTime) / 1000000.0;
+            const Kiaro::Common::F64 demoSeconds = demoTime / 1000000.0;
+
+            std::cout << "DemoReplay: Replayed " << recordCount << " packets (" << byteCount << " bytes) covering " << demoSeconds << " seconds in " <<
+            elapsedSeconds << " seconds" << std::endl;
+
+            if (elapsedSeconds > 0.0)
+                std::cout << "DemoReplay: " << recordCount / elapsedSeconds << " packets per second, " << byteCount / elapsedSeconds / (1024.0 * 1024.0) <<
+                " MB per second" << std::endl;
+
+            return recordCount != 0;
+        }
+
+        void DemoReplay::tick(void)
+        {
+            if (!mServer)
+            {
+                Kiaro::Game::OutgoingClientSingleton::getPointer()->interpolate();
+                return;
+            }
+
+            mServer->update();
+            mServer->dispatch();
+
+            mNetwork->advance(sTickMicroseconds / 1000);
+        }
+    } // End Namespace Game
+} // End Namespace Kiaro
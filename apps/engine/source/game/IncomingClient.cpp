@@ -0,0 +1,209 @@
+/**
+ *  @file IncomingClient.cpp
+ *  @brief Source code file defining logic for the Kiaro::Game::IncomingClient class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/5/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include <engine/Config.hpp>
+
+#include <game/IncomingClient.hpp>
+#include <game/entities/EntityBase.hpp>
+#include <game/entities/Player.hpp>
+#include <game/packets/packets.hpp>
+
+#include <network/StringTable.hpp>
+
+#include <support/BitStream.hpp>
+#include <support/MapDivision.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        IncomingClient::IncomingClient(ENetPeer *connecting, Kiaro::Network::ServerBase *server) : Kiaro::Network::IncomingClientBase(connecting, server),
+        mViewpoint(0, 0, 0), mSnapshotBudget(NETWORK_SNAPSHOT_BUDGET), mPlayer(NULL), mInputSequence(0),
+        mStringCount(0)
+        {
+
+        }
+
+        IncomingClient::~IncomingClient(void)
+        {
+
+        }
+
+        void IncomingClient::reset(ENetPeer *connecting)
+        {
+            Kiaro::Network::IncomingClientBase::reset(connecting);
+
+            mViewpoint = Kiaro::Common::Vector3DF(0, 0, 0);
+            mSnapshotBudget = NETWORK_SNAPSHOT_BUDGET;
+            mPlayer = NULL;
+            mInputSequence = 0;
+            mStringCount = 0;
+
+            // Clearing keeps the scratch vectors' memory around for the next client
+            mEntityPriorities.clear();
+            mPrioritizedEntities.clear();
+            mRelevantEntitySet.clear();
+            mRelevanceCandidates.clear();
+        }
+
+        void IncomingClient::updateRelevance(Kiaro::Support::MapDivision *mapDivision)
+        {
+            const Kiaro::Common::F32 enterDistanceSQ = NETWORK_RELEVANCE_RADIUS * NETWORK_RELEVANCE_RADIUS;
+            const Kiaro::Common::F32 exitDistance = NETWORK_RELEVANCE_RADIUS + NETWORK_RELEVANCE_HYSTERESIS;
+            const Kiaro::Common::F32 exitDistanceSQ = exitDistance * exitDistance;
+
+            mRelevanceCandidates.clear();
+            mapDivision->query(mViewpoint, exitDistance, mRelevanceCandidates);
+
+            std::set<Kiaro::Game::Entities::EntityBase *> relevantEntitySet;
+            for (std::vector<Kiaro::Game::Entities::EntityBase *>::iterator it = mRelevanceCandidates.begin(); it != mRelevanceCandidates.end(); it++)
+            {
+                const Kiaro::Common::F32 distanceSQ = (*it)->getPosition().getDistanceFromSQ(mViewpoint);
+
+                if (distanceSQ <= enterDistanceSQ || (distanceSQ <= exitDistanceSQ && isRelevant(*it)))
+                    relevantEntitySet.insert(*it);
+            }
+
+            mRelevantEntitySet.swap(relevantEntitySet);
+        }
+
+        void IncomingClient::buildSnapshot(const Kiaro::Network::Snapshot &current, const Kiaro::Network::Snapshot *baseline, Kiaro::Support::BitStream &stateStream,
+                                           Kiaro::Network::Snapshot &out)
+        {
+            out.mTime = current.mTime;
+
+            // Whatever was in the last snapshot sent may still exist on the client
+            const Kiaro::Network::Snapshot *previous = getSnapshotHistory().get(out.mSequence - 1);
+
+            // Accumulate priority for everything relevant, forgetting whatever no longer is
+            std::map<Kiaro::Game::Entities::EntityBase *, Kiaro::Common::F32> entityPriorities;
+            mPrioritizedEntities.clear();
+
+            for (std::set<Kiaro::Game::Entities::EntityBase *>::iterator it = mRelevantEntitySet.begin(); it != mRelevantEntitySet.end(); it++)
+            {
+                Kiaro::Game::Entities::EntityBase *entity = *it;
+
+                const Kiaro::Common::F32 distance = entity->getPosition().getDistanceFrom(mViewpoint);
+                const Kiaro::Common::F32 speed = entity->getVelocity().getLength();
+
+                const Kiaro::Common::F32 priority = entity->getNetworkPriority() * (1.0f + (speed / NETWORK_PRIORITY_VELOCITY_SCALE)) /
+                                                    (1.0f + (distance / NETWORK_PRIORITY_DISTANCE_SCALE));
+
+                std::map<Kiaro::Game::Entities::EntityBase *, Kiaro::Common::F32>::iterator accumulated = mEntityPriorities.find(entity);
+                const Kiaro::Common::F32 accumulatedPriority = priority + (accumulated != mEntityPriorities.end() ? accumulated->second : 0.0f);
+
+                entityPriorities[entity] = accumulatedPriority;
+
+                if (entity == mPlayer)
+                    mPrioritizedEntities.push_back(std::make_pair(std::numeric_limits<Kiaro::Common::F32>::max(), entity));
+                else
+                    mPrioritizedEntities.push_back(std::make_pair(accumulatedPriority, entity));
+            }
+
+            mEntityPriorities.swap(entityPriorities);
+            std::sort(mPrioritizedEntities.begin(), mPrioritizedEntities.end(), std::greater<std::pair<Kiaro::Common::F32, Kiaro::Game::Entities::EntityBase *> >());
+
+            Kiaro::Common::S32 remainingBudget = (Kiaro::Common::S32)mSnapshotBudget - Kiaro::Game::Packets::Snapshot::getHeaderSize();
+
+            for (std::vector<std::pair<Kiaro::Common::F32, Kiaro::Game::Entities::EntityBase *> >::iterator it = mPrioritizedEntities.begin(); it != mPrioritizedEntities.end(); it++)
+            {
+                Kiaro::Game::Entities::EntityBase *entity = it->second;
+                const Kiaro::Common::U32 netID = entity->getNetID();
+
+                std::map<Kiaro::Common::U32, Kiaro::Network::EntityState>::const_iterator currentState = current.mEntityStates.find(netID);
+                if (currentState == current.mEntityStates.end())
+                    continue;
+
+                Kiaro::Network::EntityState state;
+                state.mTypeMask = currentState->second.mTypeMask;
+                state.mSequence = out.mSequence;
+                state.mFirstSequence = out.mSequence;
+
+                if (previous)
+                {
+                    std::map<Kiaro::Common::U32, Kiaro::Network::EntityState>::const_iterator previousState = previous->mEntityStates.find(netID);
+                    if (previousState != previous->mEntityStates.end())
+                        state.mFirstSequence = previousState->second.mFirstSequence;
+                }
+
+                const Kiaro::Network::EntityState *baselineState = Kiaro::Game::Packets::Snapshot::getBaselineState(netID, state, baseline);
+
+                // Only a full entry creates the entity on the client, so that's the only time it needs initializing
+                if (!baselineState)
+                    state.mInitialization = currentState->second.mInitialization;
+                const Kiaro::Common::U32 changedMask = baselineState ? entity->getChangedMask(baselineState->mSequence) : entity->getPropertyMask();
+
+                // The client already has everything the baseline gave it, so only what changed since goes
+                if (!changedMask)
+                    state.mData = baselineState->mData;
+                else if (changedMask == entity->getPropertyMask())
+                    state.mData = currentState->second.mData;
+                else
+                {
+                    stateStream.clear();
+                    entity->packUpdate(stateStream, changedMask);
+                    stateStream.flushBits();
+
+                    const Kiaro::Common::U8 *stateData = (const Kiaro::Common::U8 *)stateStream.raw();
+                    state.mData.assign(stateData, stateData + stateStream.length());
+                }
+
+                const Kiaro::Common::S32 entrySize = Kiaro::Game::Packets::Snapshot::getEntrySize(netID, state, baselineState);
+                const Kiaro::Common::S32 unchangedEntrySize = Kiaro::Game::Packets::Snapshot::getEntrySize(netID, state, &state);
+
+                // Unchanged entities cost no more than deferring them would, so they always go in
+                if (entrySize <= remainingBudget || (baselineState && entrySize == unchangedEntrySize))
+                {
+                    out.mEntityStates[netID] = state;
+                    mEntityPriorities[entity] = 0.0f;
+                    remainingBudget -= entrySize;
+                }
+                else if (baselineState)
+                {
+                    // Leaving the entity out entirely would destroy it on the client, so it stays as the client has it
+                    Kiaro::Network::EntityState &deferredState = out.mEntityStates[netID];
+                    deferredState = *baselineState;
+                    deferredState.mFirstSequence = state.mFirstSequence;
+
+                    remainingBudget -= unchangedEntrySize;
+                }
+            }
+        }
+
+        void IncomingClient::sendStrings(const Kiaro::Network::StringTable &strings)
+        {
+            // A whole manifest is split up so that no one packet grows much past a message buffer
+            while (mStringCount < strings.getCount())
+            {
+                Kiaro::Game::Packets::StringTableUpdate update;
+                update.mFirstID = mStringCount;
+
+                Kiaro::Common::U32 packetSize = update.getPacketSize();
+                while (mStringCount < strings.getCount() && (update.mStrings.empty() || packetSize < NETWORK_MESSAGE_BUFFER_SIZE))
+                {
+                    const std::string &string = *strings.getString(mStringCount);
+
+                    update.mStrings.push_back(string);
+                    packetSize += sizeof(Kiaro::Common::U16) + string.size();
+                    mStringCount++;
+                }
+
+                send(&update);
+            }
+        }
+    } // End Namespace Game
+} // End Namespace Kiaro
@@ -0,0 +1,250 @@
+/**
+ *  @file LoadGenerator.cpp
+ *  @brief Source code file defining logic for the Kiaro::Game::LoadGenerator class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/5/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <iostream>
+#include <algorithm>
+
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <support/Time.hpp>
+
+#include <game/LoadGenerator.hpp>
+#include <game/BotClient.hpp>
+#include <game/ServerSingleton.hpp>
+#include <game/entities/RigidProp.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        LoadGenerator::LoadGenerator(const Kiaro::Game::LoadSettings &settings) : mSettings(settings), mNetwork(NULL), mServer(NULL)
+        {
+            if (!mSettings.mTargetAddress.empty())
+                return;
+
+            // A network thread services the server whenever it likes, so simulated time would make no sense to it
+            mNetwork = new Kiaro::Network::LoopbackNetwork(mSettings.mSeed, !mSettings.mNetworkThreaded);
+            mNetwork->setConditions(mSettings.mConditions);
+
+            mServer = Kiaro::Game::ServerSingleton::getPointer(new Kiaro::Network::LoopbackTransport(mNetwork, mSettings.mTargetPort), mSettings.mBotCount);
+
+            if (mSettings.mNetworkThreaded)
+                mServer->startNetworkThread();
+
+            for (Kiaro::Common::U32 iteration = 0; iteration < mSettings.mEntityCount; iteration++)
+            {
+                Kiaro::Game::Entities::EntityBase *entity = new Kiaro::Game::Entities::RigidProp();
+
+                mServer->addDynamicEntity(entity);
+                mEntities.push_back(entity);
+            }
+        }
+
+        LoadGenerator::~LoadGenerator(void)
+        {
+            for (std::vector<Kiaro::Game::BotClient *>::iterator it = mBots.begin(); it != mBots.end(); it++)
+                delete *it;
+
+            if (mServer)
+                Kiaro::Game::ServerSingleton::destroy();
+
+            for (std::vector<Kiaro::Game::Entities::EntityBase *>::iterator it = mEntities.begin(); it != mEntities.end(); it++)
+                delete *it;
+
+            delete mNetwork;
+        }
+
+        bool LoadGenerator::run(void)
+        {
+            std::cout << "LoadGenerator: Connecting " << mSettings.mBotCount << " bots" << std::endl;
+
+            // With no input rate, the first input is scheduled for never
+            const Kiaro::Common::U64 inputInterval = mSettings.mInputRate ? 1000000 / mSettings.mInputRate : 0;
+
+            for (Kiaro::Common::U32 iteration = 0; iteration < mSettings.mBotCount; iteration++)
+            {
+                // Stagger the bots so that their inputs don't all land on the same tick
+                const Kiaro::Common::U64 firstInputTime = inputInterval ? getTime() + inputInterval * iteration / mSettings.mBotCount : ~0ULL;
+                Kiaro::Game::BotClient *bot = new Kiaro::Game::BotClient(inputInterval, firstInputTime);
+                mBots.push_back(bot);
+
+                if (mNetwork)
+                {
+                    ENetAddress address;
+                    address.host = ENET_HOST_TO_NET_32(0x7F000001);
+                    address.port = mSettings.mTargetPort;
+
+                    bot->connect(new Kiaro::Network::LoopbackTransport(mNetwork), address);
+                }
+                else
+                    bot->connect(mSettings.mTargetAddress, mSettings.mTargetPort);
+            }
+
+            // Tick until every bot has either connected or given up
+            bool connecting = true;
+            while (connecting)
+            {
+                tick(getTime());
+
+                connecting = false;
+                for (std::vector<Kiaro::Game::BotClient *>::iterator it = mBots.begin(); it != mBots.end(); it++)
+                    connecting |= (*it)->getConnectionState() == Kiaro::Network::CONNECTION_CONNECTING;
+            }
+
+            mTickTimes.clear();
+
+            std::vector<Kiaro::Common::U64> bytesReceived;
+            std::vector<Kiaro::Common::U64> bytesSent;
+            for (std::vector<Kiaro::Game::BotClient *>::iterator it = mBots.begin(); it != mBots.end(); it++)
+            {
+                bytesReceived.push_back((*it)->getBytesReceived());
+                bytesSent.push_back((*it)->getBytesSent());
+            }
+
+            const Kiaro::Common::U64 startTime = getTime();
+            const Kiaro::Common::U64 endTime = startTime + mSettings.mDuration * 1000000ULL;
+
+            std::cout << "LoadGenerator: Running for " << mSettings.mDuration << " seconds" << std::endl;
+
+            Kiaro::Common::U64 currentTime = startTime;
+            while (currentTime < endTime)
+            {
+                tick(currentTime);
+                currentTime = getTime();
+            }
+
+            // Only count what was sent and received while the test was running
+            for (size_t iteration = 0; iteration < mBots.size(); iteration++)
+            {
+                bytesReceived[iteration] = mBots[iteration]->getBytesReceived() - bytesReceived[iteration];
+                bytesSent[iteration] = mBots[iteration]->getBytesSent() - bytesSent[iteration];
+            }
+
+            report(currentTime - startTime, bytesReceived, bytesSent);
+
+            for (std::vector<Kiaro::Game::BotClient *>::iterator it = mBots.begin(); it != mBots.end(); it++)
+                if ((*it)->isConnected())
+                    return true;
+
+            return false;
+        }
+
+        void LoadGenerator::tick(const Kiaro::Common::U64 &currentTime)
+        {
+            const Kiaro::Common::U64 tickStartTime = Kiaro::Support::Time::getCurrentTimeMicroseconds();
+
+            if (mServer)
+            {
+                mServer->update();
+                mServer->dispatch();
+
+                mTickTimes.push_back(Kiaro::Support::Time::getCurrentTimeMicroseconds() - tickStartTime);
+            }
+
+            for (std::vector<Kiaro::Game::BotClient *>::iterator it = mBots.begin(); it != mBots.end(); it++)
+            {
+                (*it)->update(currentTime);
+                (*it)->dispatch();
+            }
+
+            // A network thread services the server on wall time, so only a network without one can be run ahead
+            if (mNetwork && !mSettings.mNetworkThreaded)
+                mNetwork->advance(mSettings.mTickMilliseconds);
+            else
+            {
+                const Kiaro::Common::U64 tickTime = mSettings.mTickMilliseconds * 1000ULL;
+                const Kiaro::Common::U64 tickDuration = Kiaro::Support::Time::getCurrentTimeMicroseconds() - tickStartTime;
+
+                if (tickDuration < tickTime)
+                    boost::this_thread::sleep(boost::posix_time::microseconds(tickTime - tickDuration));
+            }
+        }
+
+        Kiaro::Common::U64 LoadGenerator::getTime(void)
+        {
+            if (mNetwork)
+                return mNetwork->getTime() * 1000;
+
+            return Kiaro::Support::Time::getCurrentTimeMicroseconds();
+        }
+
+        void LoadGenerator::report(const Kiaro::Common::U64 &elapsedTime, std::vector<Kiaro::Common::U64> &bytesReceived, std::vector<Kiaro::Common::U64> &bytesSent)
+        {
+            Kiaro::Common::U32 connectedCount = 0;
+            Kiaro::Common::U32 pingsSent = 0;
+            std::vector<Kiaro::Common::U64> roundTripTimes;
+
+            for (std::vector<Kiaro::Game::BotClient *>::iterator it = mBots.begin(); it != mBots.end(); it++)
+            {
+                if ((*it)->isConnected())
+                    connectedCount++;
+
+                pingsSent += (*it)->getPingsSent();
+                roundTripTimes.insert(roundTripTimes.end(), (*it)->getRoundTripTimes().begin(), (*it)->getRoundTripTimes().end());
+            }
+
+            const Kiaro::Common::F32 elapsedSeconds = elapsedTime / 1000000.0f;
+            std::cout << "LoadGenerator: " << connectedCount << " of " << mBots.size() << " bots were connected at the end of " << elapsedSeconds << " seconds" << std::endl;
+
+            if (!mTickTimes.empty())
+            {
+                Kiaro::Common::U64 totalTickTime = 0;
+                for (std::vector<Kiaro::Common::U64>::iterator it = mTickTimes.begin(); it != mTickTimes.end(); it++)
+                    totalTickTime += *it;
+
+                std::sort(mTickTimes.begin(), mTickTimes.end());
+
+                std::cout << "LoadGenerator: Server tick time (ms): mean " << totalTickTime / 1000.0f / mTickTimes.size() << ", p50 " << getPercentile(mTickTimes, 50) / 1000.0f <<
+                ", p99 " << getPercentile(mTickTimes, 99) / 1000.0f << ", max " << mTickTimes.back() / 1000.0f << " over " << mTickTimes.size() << " ticks" << std::endl;
+            }
+
+            if (!mBots.empty() && elapsedSeconds > 0.0f)
+            {
+                Kiaro::Common::U64 totalReceived = 0;
+                Kiaro::Common::U64 totalSent = 0;
+                for (size_t iteration = 0; iteration < mBots.size(); iteration++)
+                {
+                    totalReceived += bytesReceived[iteration];
+                    totalSent += bytesSent[iteration];
+                }
+
+                std::cout << "LoadGenerator: Bytes per second per client: server to client mean " << totalReceived / elapsedSeconds / mBots.size() <<
+                ", max " << *std::max_element(bytesReceived.begin(), bytesReceived.end()) / elapsedSeconds << "; client to server mean " <<
+                totalSent / elapsedSeconds / mBots.size() << ", max " << *std::max_element(bytesSent.begin(), bytesSent.end()) / elapsedSeconds << std::endl;
+            }
+
+            if (!roundTripTimes.empty())
+            {
+                std::sort(roundTripTimes.begin(), roundTripTimes.end());
+
+                std::cout << "LoadGenerator: Input round trip time (ms): p50 " << getPercentile(roundTripTimes, 50) / 1000.0f << ", p90 " << getPercentile(roundTripTimes, 90) / 1000.0f <<
+                ", p99 " << getPercentile(roundTripTimes, 99) / 1000.0f << ", max " << roundTripTimes.back() / 1000.0f << "; " << roundTripTimes.size() << " of " << pingsSent <<
+                " inputs came back" << std::endl;
+            }
+        }
+
+        Kiaro::Common::U64 LoadGenerator::getPercentile(const std::vector<Kiaro::Common::U64> &values, const Kiaro::Common::F32 &percentile)
+        {
+            if (values.empty())
+                return 0;
+
+            // Nearest rank
+            size_t rank = (size_t)(percentile / 100.0f * values.size() + 0.5f);
+            if (rank > 0)
+                rank--;
+
+            return values[std::min(rank, values.size() - 1)];
+        }
+    } // End Namespace Game
+} // End Namespace Kiaro
@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <iostream>
+#include <algorithm>
 
 #include <enet/enet.h>
 #include <boost/regex.hpp>
@@ -23,9 +24,13 @@
 #include <engine/CoreSingleton.hpp>
 
 #include <game/packets/packets.hpp>
+#include <game/entities/EntityBase.hpp>
+#include <game/entities/Player.hpp>
+#include <game/entities/Types.hpp>
 #include <game/OutgoingClientSingleton.hpp>
 
 #include <support/BitStream.hpp>
+#include <support/Time.hpp>
 
 #include <network/OutgoingClientBase.hpp>
 
@@ -33,53 +38,214 @@ namespace Kiaro
 {
     namespace Game
     {
-        Kiaro::Network::OutgoingClientBase *OutgoingClientSingleton_Instance = NULL;
+        OutgoingClientSingleton *OutgoingClientSingleton_Instance = NULL;
 
-        OutgoingClientSingleton::OutgoingClientSingleton(ENetPeer *incoming, Kiaro::Network::ServerBase *server)
+        OutgoingClientSingleton::OutgoingClientSingleton(ENetPeer *incoming, Kiaro::Network::ServerBase *server) : mInterpolationDelay(NETWORK_INTERPOLATION_DELAY),
+        mHasServerTime(false), mServerTimeOffset(0), mControlledNetID(0), mInputSequence(0)
         {
-
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::HandShake>(new EasyDelegate::MemberDelegate<OutgoingClientSingleton, void, Kiaro::Game::Packets::HandShake &>(this, &OutgoingClientSingleton::onHandShake));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::Snapshot>(new EasyDelegate::MemberDelegate<OutgoingClientSingleton, void, Kiaro::Game::Packets::Snapshot &>(this, &OutgoingClientSingleton::onSnapshot));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::ControlEntity>(new EasyDelegate::MemberDelegate<OutgoingClientSingleton, void, Kiaro::Game::Packets::ControlEntity &>(this, &OutgoingClientSingleton::onControlEntity));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::StringTableUpdate>(new EasyDelegate::MemberDelegate<OutgoingClientSingleton, void, Kiaro::Game::Packets::StringTableUpdate &>(this, &OutgoingClientSingleton::onStringTableUpdate));
         }
 
         OutgoingClientSingleton::~OutgoingClientSingleton(void)
         {
-            if (mInternalPeer)
+            for (std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *>::iterator it = mReplicatedEntities.begin(); it != mReplicatedEntities.end(); it++)
+                delete it->second;
+        }
+
+        void OutgoingClientSingleton::onReceivePacket(Kiaro::Support::BitStream &incomingStream)
+        {
+            mPacketRegistry.dispatch(incomingStream, NULL, mCurrentStage, &mStatistics);
+        }
+
+        void OutgoingClientSingleton::onHandShake(Kiaro::Game::Packets::HandShake &packet)
+        {
+            // NOTE: Would rather printf here but then the stdout override doesn't work
+            std::cout << "OutgoingClient: Server Version is " << (Kiaro::Common::U32)packet.mVersionMajor << "."
+            << (Kiaro::Common::U32)packet.mVersionMinor << "." << (Kiaro::Common::U32)packet.mVersionRevision << "."
+            << (Kiaro::Common::U32)packet.mVersionBuild << std::endl;
+
+            if (packet.mSchemaHash != Kiaro::Game::Entities::getSchemaHash())
             {
-                enet_peer_reset(mInternalPeer);
-                mInternalPeer = NULL;
+                std::cerr << "OutgoingClient: The server serializes entities differently than we do; disconnecting" << std::endl;
+                disconnect();
+
+                return;
             }
 
-            if (mInternalHost)
+            mCurrentStage = 1;
+        }
+
+        void OutgoingClientSingleton::onSnapshot(Kiaro::Game::Packets::Snapshot &packet)
+        {
+            // Snapshots are unreliable, so anything older than what we already have is of no use
+            if (packet.mSequence <= mSnapshotHistory.getAcknowledgedSequence())
+                return;
+
+            // Left unacknowledged so the server keeps sending it until the strings its initializations refer to are here
+            if (mStringTable.getCount() < packet.mStringCount)
+                return;
+
+            Kiaro::Network::Snapshot *baseline = NULL;
+            if (packet.mBaselineSequence != 0 && !(baseline = mSnapshotHistory.get(packet.mBaselineSequence)))
             {
-                enet_host_destroy(mInternalHost);
-                mInternalHost = NULL;
+                std::cerr << "OutgoingClient: Dropping snapshot " << packet.mSequence << "; baseline " << packet.mBaselineSequence << " is no longer known" << std::endl;
+                return;
             }
+
+            Kiaro::Network::Snapshot snapshot;
+            if (!packet.decode(baseline, snapshot))
+            {
+                std::cerr << "OutgoingClient: Dropping snapshot " << packet.mSequence << "; it does not match its baseline" << std::endl;
+                return;
+            }
+
+            mSnapshotHistory.push(packet.mSequence) = snapshot;
+            mSnapshotHistory.acknowledge(packet.mSequence);
+
+            // Follow the quickest snapshots straight away and drift slowly towards slower ones, so that one late
+            // snapshot doesn't drag everything backwards but the clocks can't wander apart either
+            const Kiaro::Common::S32 serverTimeOffset = (Kiaro::Common::S32)(snapshot.mTime - getLocalTime());
+
+            if (!mHasServerTime || serverTimeOffset > mServerTimeOffset)
+                mServerTimeOffset = serverTimeOffset;
+            else if (serverTimeOffset < mServerTimeOffset)
+                mServerTimeOffset--;
+
+            mHasServerTime = true;
+
+            // Whatever the server has applied is already part of the state we're about to receive
+            while (!mPendingInputs.empty() && (Kiaro::Common::S32)(mPendingInputs.front().mSequence - packet.mInputSequence) <= 0)
+                mPendingInputs.pop_front();
+
+            applySnapshot(snapshot);
+
+            // Replay the rest of our input on top of where the server had our player
+            std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *>::iterator controlled = mReplicatedEntities.find(mControlledNetID);
+            if (controlled != mReplicatedEntities.end() && controlled->second->getTypeMask() == Kiaro::Game::Entities::ENTITY_PLAYER)
+            {
+                Kiaro::Game::Entities::Player *player = static_cast<Kiaro::Game::Entities::Player *>(controlled->second);
+                player->setPredicted(true);
+
+                for (std::deque<Kiaro::Game::InputCommand>::iterator it = mPendingInputs.begin(); it != mPendingInputs.end(); it++)
+                    player->applyInput(*it);
+            }
+
+            Kiaro::Game::Packets::SnapshotAck ack;
+            ack.mSequence = packet.mSequence;
+            send(&ack);
         }
 
-        void OutgoingClientSingleton::onReceivePacket(Kiaro::Support::BitStream &incomingStream)
+        void OutgoingClientSingleton::onControlEntity(Kiaro::Game::Packets::ControlEntity &packet)
         {
-            // We need to know what type of packet it is first
-            Kiaro::Network::PacketBase basePacket;
-            basePacket.unpackData(incomingStream);
+            mControlledNetID = packet.mNetID;
+        }
 
-            switch (basePacket.getType())
+        void OutgoingClientSingleton::onStringTableUpdate(Kiaro::Game::Packets::StringTableUpdate &packet)
+        {
+            // Updates are reliable and ordered, so anything else means the two tables no longer agree
+            if (packet.mFirstID != mStringTable.getCount())
             {
-                case Kiaro::Game::Packets::PACKET_HANDSHAKE:
+                std::cerr << "OutgoingClient: Dropping string table update starting at " << packet.mFirstID << "; expected " << mStringTable.getCount() << std::endl;
+                return;
+            }
+
+            for (std::vector<std::string>::const_iterator it = packet.mStrings.begin(); it != packet.mStrings.end(); it++)
+                mStringTable.insert(*it);
+        }
+
+        void OutgoingClientSingleton::sendInput(const Kiaro::Common::U8 &buttons, const Kiaro::Common::U8 &duration)
+        {
+            if (mConnectionState != Kiaro::Network::CONNECTION_CONNECTED || mCurrentStage < Kiaro::Game::Packets::Input::sAcceptedStage)
+                return;
+
+            Kiaro::Game::InputCommand command;
+            command.mSequence = ++mInputSequence;
+            command.mButtons = buttons;
+            command.mDuration = duration;
+
+            // Should the server stop acknowledging for long enough, the oldest input just stops being replayed
+            mPendingInputs.push_back(command);
+            if (mPendingInputs.size() > NETWORK_INPUT_HISTORY_LENGTH)
+                mPendingInputs.pop_front();
+
+            std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *>::iterator controlled = mReplicatedEntities.find(mControlledNetID);
+            if (controlled != mReplicatedEntities.end() && controlled->second->getTypeMask() == Kiaro::Game::Entities::ENTITY_PLAYER)
+                static_cast<Kiaro::Game::Entities::Player *>(controlled->second)->applyInput(command);
+
+            Kiaro::Game::Packets::Input input;
+            const size_t sentCount = std::min<size_t>(mPendingInputs.size(), NETWORK_INPUT_REDUNDANCY);
+            input.mCommands.assign(mPendingInputs.end() - sentCount, mPendingInputs.end());
+
+            send(&input);
+        }
+
+        void OutgoingClientSingleton::applySnapshot(const Kiaro::Network::Snapshot &snapshot)
+        {
+            // Anything the server stopped sending no longer exists for us
+            for (std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *>::iterator it = mReplicatedEntities.begin(); it != mReplicatedEntities.end();)
+            {
+                if (snapshot.mEntityStates.find(it->first) == snapshot.mEntityStates.end())
+                {
+                    delete it->second;
+                    mReplicatedEntities.erase(it++);
+                }
+                else
+                    it++;
+            }
+
+            for (std::map<Kiaro::Common::U32, Kiaro::Network::EntityState>::const_iterator it = snapshot.mEntityStates.begin(); it != snapshot.mEntityStates.end(); it++)
+            {
+                Kiaro::Game::Entities::EntityBase *&entity = mReplicatedEntities[it->first];
+
+                if (!entity)
                 {
-                    Kiaro::Game::Packets::HandShake receivedHandshake;
-                    receivedHandshake.unpackData(incomingStream);
+                    entity = Kiaro::Game::Entities::createEntity(it->second.mTypeMask);
 
-                    // NOTE: Would rather printf here but then the stdout override doesn't work
-                    std::cout << "OutgoingClient: Server Version is " << (Kiaro::Common::U32)receivedHandshake.mVersionMajor << "."
-                    << (Kiaro::Common::U32)receivedHandshake.mVersionMinor << "." << (Kiaro::Common::U32)receivedHandshake.mVersionRevision << "."
-                    << (Kiaro::Common::U32)receivedHandshake.mVersionBuild << std::endl;
+                    if (!entity)
+                    {
+                        std::cerr << "OutgoingClient: Cannot create replicated entity of type " << it->second.mTypeMask << std::endl;
+                        mReplicatedEntities.erase(it->first);
+                        continue;
+                    }
 
-                    mCurrentStage = 1;
+                    entity->setNetID(it->first);
 
-                    break;
+                    if (!it->second.mInitialization.empty())
+                    {
+                        Kiaro::Support::BitStream initializationStream((Kiaro::Common::U8 *)&it->second.mInitialization[0], it->second.mInitialization.size(), it->second.mInitialization.size());
+                        entity->unpackInitialization(initializationStream, mStringTable);
+                    }
                 }
+
+                if (it->second.mData.empty())
+                    continue;
+
+                // The stream only reads, so it is fine for it to point at the snapshot's own copy of the state
+                Kiaro::Support::BitStream stateStream((Kiaro::Common::U8 *)&it->second.mData[0], it->second.mData.size(), it->second.mData.size());
+                entity->setUpdateTime(snapshot.mTime);
+                entity->unpackUpdate(stateStream);
             }
         }
 
+        void OutgoingClientSingleton::interpolate(void)
+        {
+            if (!mHasServerTime)
+                return;
+
+            const Kiaro::Common::U32 renderTime = getLocalTime() + mServerTimeOffset - mInterpolationDelay;
+
+            for (std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *>::iterator it = mReplicatedEntities.begin(); it != mReplicatedEntities.end(); it++)
+                it->second->interpolate(renderTime);
+        }
+
+        Kiaro::Common::U32 OutgoingClientSingleton::getLocalTime(void)
+        {
+            return (Kiaro::Common::U32)(Kiaro::Support::Time::getCurrentTimeMicroseconds() / 1000);
+        }
+
         void OutgoingClientSingleton::onConnected(void)
         {
             std::cout << "OutgoingClient: Established connection to remote host" << std::endl;
@@ -90,13 +256,27 @@ namespace Kiaro
             handShake.mVersionMinor = 2;
             handShake.mVersionRevision = 3;
             handShake.mVersionBuild = 4;
+            handShake.mSchemaHash = Kiaro::Game::Entities::getSchemaHash();
 
-            send(&handShake, true);
+            send(&handShake);
         }
 
         void OutgoingClientSingleton::onDisconnected(void)
         {
             std::cout << "OutgoingClient: Received disconnect event" << std::endl;
+
+            // Whatever was replicated belonged to that server
+            for (std::map<Kiaro::Common::U32, Kiaro::Game::Entities::EntityBase *>::iterator it = mReplicatedEntities.begin(); it != mReplicatedEntities.end(); it++)
+                delete it->second;
+
+            mReplicatedEntities.clear();
+            mSnapshotHistory = Kiaro::Network::SnapshotHistory();
+            mStringTable.clear();
+            mHasServerTime = false;
+
+            mPendingInputs.clear();
+            mControlledNetID = 0;
+            mInputSequence = 0;
         }
 
         void OutgoingClientSingleton::onConnectFailed(void)
@@ -104,7 +284,7 @@ namespace Kiaro
 
         }
 
-        Kiaro::Network::OutgoingClientBase *OutgoingClientSingleton::getPointer(void)
+        OutgoingClientSingleton *OutgoingClientSingleton::getPointer(void)
         {
             if (!OutgoingClientSingleton_Instance)
                 OutgoingClientSingleton_Instance = new OutgoingClientSingleton(NULL, NULL);
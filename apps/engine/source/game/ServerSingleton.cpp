@@ -13,6 +13,12 @@
 
 #include <game/packets/packets.hpp>
 #include <game/ServerSingleton.hpp>
+#include <network/Transport.hpp>
+#include <game/IncomingClient.hpp>
+#include <game/entities/Player.hpp>
+
+#include <support/BitStream.hpp>
+#include <support/Time.hpp>
 
 namespace Kiaro
 {
@@ -28,6 +34,16 @@ namespace Kiaro
             return ServerSingleton_Instance;
         }
 
+        ServerSingleton *ServerSingleton::getPointer(Kiaro::Network::Transport *transport, const Kiaro::Common::U32 &maximumClientCount)
+        {
+            if (!ServerSingleton_Instance)
+                ServerSingleton_Instance = new ServerSingleton(transport, maximumClientCount);
+            else
+                delete transport;
+
+            return ServerSingleton_Instance;
+        }
+
         void ServerSingleton::destroy(void)
         {
             if (ServerSingleton_Instance)
@@ -37,15 +53,42 @@ namespace Kiaro
         }
 
         ServerSingleton::ServerSingleton(const std::string &listenAddress, const Kiaro::Common::U16 &listenPort, const Kiaro::Common::U32 &maximumClientCount) : ServerBase(listenAddress, listenPort, maximumClientCount),
-        mLastPacketSender(NULL)
+        mLastPacketSender(NULL), mNextNetID(1), mSnapshotSequence(0), mEntityStateStream(NETWORK_MAXIMUM_ENTITY_STATE_SIZE)
         {
-            // Create the map division
-            Kiaro::Support::MapDivision::Get(12);
+            initialize();
+        }
+
+        ServerSingleton::ServerSingleton(Kiaro::Network::Transport *transport, const Kiaro::Common::U32 &maximumClientCount) : ServerBase(transport, maximumClientCount),
+        mLastPacketSender(NULL), mNextNetID(1), mSnapshotSequence(0), mEntityStateStream(NETWORK_MAXIMUM_ENTITY_STATE_SIZE)
+        {
+            initialize();
+        }
+
+        void ServerSingleton::initialize(void)
+        {
+            // Create the map division; eight LODs bring the finest squares down to 32 units
+            mMapDivision = Kiaro::Support::MapDivision::Get(12, 8);
+
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::HandShake>(new EasyDelegate::MemberDelegate<ServerSingleton, void, Kiaro::Game::Packets::HandShake &>(this, &ServerSingleton::onHandShake));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::SnapshotAck>(new EasyDelegate::MemberDelegate<ServerSingleton, void, Kiaro::Game::Packets::SnapshotAck &>(this, &ServerSingleton::onSnapshotAck));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::Ping>(new EasyDelegate::MemberDelegate<ServerSingleton, void, Kiaro::Game::Packets::Ping &>(this, &ServerSingleton::onPing));
+            mPacketRegistry.registerPacket<Kiaro::Game::Packets::Input>(new EasyDelegate::MemberDelegate<ServerSingleton, void, Kiaro::Game::Packets::Input &>(this, &ServerSingleton::onInput));
+
+            // Every asset the game knows of ahead of time is sent once at handshake rather than by name wherever it's used
+            if (!mStringTable.loadManifest(NETWORK_STRING_TABLE_MANIFEST))
+                std::cerr << "Server: Cannot load the asset manifest '" << NETWORK_STRING_TABLE_MANIFEST << "'" << std::endl;
         }
 
         ServerSingleton::~ServerSingleton(void)
         {
+            // Clients still connected are deleted along with the server, so their players have to go with them
+            for (size_t iteration = 0; iteration < mClients.getCount(); iteration++)
+            {
+                Kiaro::Game::IncomingClient *client = static_cast<Kiaro::Game::IncomingClient *>(mClients.getClient(iteration));
 
+                delete client->getPlayer();
+                client->setPlayer(NULL);
+            }
         }
 
         void ServerSingleton::onClientConnected(Kiaro::Network::IncomingClientBase *client)
@@ -56,37 +99,194 @@ namespace Kiaro
         void ServerSingleton::onClientDisconnected(Kiaro::Network::IncomingClientBase *client)
         {
             std::cout << "Server: Received disconnection from x.x.x.x:" << client->getPort() << std::endl;
+
+            Kiaro::Game::IncomingClient *incomingClient = static_cast<Kiaro::Game::IncomingClient *>(client);
+            Kiaro::Game::Entities::Player *player = incomingClient->getPlayer();
+
+            if (player)
+            {
+                removeDynamicEntity(player);
+                incomingClient->setPlayer(NULL);
+
+                delete player;
+            }
+        }
+
+        Kiaro::Network::IncomingClientBase *ServerSingleton::createIncomingClient(ENetPeer *connecting)
+        {
+            return new Kiaro::Game::IncomingClient(connecting, this);
         }
 
         void ServerSingleton::onReceivePacket(Kiaro::Support::BitStream &incomingStream, Kiaro::Network::IncomingClientBase *sender)
         {
             mLastPacketSender = sender;
+            mPacketRegistry.dispatch(incomingStream, sender, sender->getStage(), &sender->getStatistics());
+            mLastPacketSender = NULL;
+        }
 
-            Kiaro::Network::PacketBase basePacket;
-            basePacket.unpackData(incomingStream);
+        void ServerSingleton::onHandShake(Kiaro::Game::Packets::HandShake &packet)
+        {
+            std::cout << "Server: Client Version is " << (Kiaro::Common::U32)packet.mVersionMajor << "."
+            << (Kiaro::Common::U32)packet.mVersionMinor << "." << (Kiaro::Common::U32)packet.mVersionRevision << "."
+            << (Kiaro::Common::U32)packet.mVersionBuild << std::endl;
 
-            switch (basePacket.getType())
+            // A client that serializes entities differently would only ever misread its snapshots
+            const Kiaro::Common::U32 schemaHash = Kiaro::Game::Entities::getSchemaHash();
+            if (packet.mSchemaHash != schemaHash)
             {
-                case Kiaro::Game::Packets::PACKET_HANDSHAKE:
+                std::cerr << "Server: Turning away x.x.x.x:" << packet.mSender->getPort() << "; its entity schema " << std::hex << packet.mSchemaHash
+                << " does not match ours, " << schemaHash << std::dec << std::endl;
+
+                dropClient(packet.mSender);
+                return;
+            }
+
+            Kiaro::Game::Packets::HandShake handShake;
+            handShake.mVersionMajor = 1;
+            handShake.mVersionMinor = 2;
+            handShake.mVersionRevision = 3;
+            handShake.mVersionBuild = 4;
+            handShake.mSchemaHash = schemaHash;
+
+            packet.mSender->setStage(1);
+            packet.mSender->send(&handShake);
+
+            Kiaro::Game::IncomingClient *client = static_cast<Kiaro::Game::IncomingClient *>(packet.mSender);
+            client->sendStrings(mStringTable);
+
+            // Give the client a player of its own to move around
+            if (client->getPlayer())
+                return;
+
+            Kiaro::Game::Entities::Player *player = new Kiaro::Game::Entities::Player();
+            addDynamicEntity(player);
+            client->setPlayer(player);
+
+            Kiaro::Game::Packets::ControlEntity controlEntity;
+            controlEntity.mNetID = player->getNetID();
+            client->send(&controlEntity);
+        }
+
+        void ServerSingleton::onSnapshotAck(Kiaro::Game::Packets::SnapshotAck &packet)
+        {
+            // Never let a client acknowledge something it could not have been sent yet
+            if (packet.mSequence <= mSnapshotSequence)
+                packet.mSender->getSnapshotHistory().acknowledge(packet.mSequence);
+        }
+
+        void ServerSingleton::onPing(Kiaro::Game::Packets::Ping &packet)
+        {
+            packet.mSender->send(&packet);
+        }
+
+        void ServerSingleton::onInput(Kiaro::Game::Packets::Input &packet)
+        {
+            Kiaro::Game::IncomingClient *client = static_cast<Kiaro::Game::IncomingClient *>(packet.mSender);
+            Kiaro::Game::Entities::Player *player = client->getPlayer();
+
+            if (!player)
+                return;
+
+            Kiaro::Common::U32 inputSequence = client->getInputSequence();
+            for (std::vector<Kiaro::Game::InputCommand>::iterator it = packet.mCommands.begin(); it != packet.mCommands.end(); it++)
+                if ((Kiaro::Common::S32)(it->mSequence - inputSequence) > 0)
                 {
-                    Kiaro::Game::Packets::HandShake receivedHandshake;
-                    receivedHandshake.unpackData(incomingStream);
+                    player->applyInput(*it);
+                    inputSequence = it->mSequence;
+                }
 
-                    std::cout << "Server: Client Version is " << (Kiaro::Common::U32)receivedHandshake.mVersionMajor << "."
-                    << (Kiaro::Common::U32)receivedHandshake.mVersionMinor << "." << (Kiaro::Common::U32)receivedHandshake.mVersionRevision << "."
-                    << (Kiaro::Common::U32)receivedHandshake.mVersionBuild << std::endl;
+            client->setInputSequence(inputSequence);
+        }
 
-                    Kiaro::Game::Packets::HandShake handShake;
-                    handShake.mVersionMajor = 1;
-                    handShake.mVersionMinor = 2;
-                    handShake.mVersionRevision = 3;
-                    handShake.mVersionBuild = 4;
+        void ServerSingleton::update(void)
+        {
+            Kiaro::Network::ServerBase::update();
 
-                    sender->send(&handShake, true);
+            if (mIsRunning)
+                sendSnapshots();
+        }
+
+        void ServerSingleton::sendSnapshots(void)
+        {
+            mSnapshotSequence++;
+
+            // Serialize every entity in full once; each client then only gets what changed since its own baseline
+            Kiaro::Network::Snapshot currentSnapshot;
+            currentSnapshot.mSequence = mSnapshotSequence;
+            currentSnapshot.mTime = (Kiaro::Common::U32)(Kiaro::Support::Time::getCurrentTimeMicroseconds() / 1000);
+
+            for (std::set<Kiaro::Game::Entities::EntityBase *>::iterator it = mDynamicEntitySet.begin(); it != mDynamicEntitySet.end(); it++)
+            {
+                Kiaro::Game::Entities::EntityBase *entity = *it;
+                mMapDivision->insert(entity, entity->getPosition());
+                entity->commitChanges(mSnapshotSequence);
+
+                mEntityStateStream.clear();
+                entity->packUpdate(mEntityStateStream, entity->getPropertyMask());
+                mEntityStateStream.flushBits();
+
+                if (mEntityStateStream.length() > NETWORK_MAXIMUM_ENTITY_STATE_SIZE)
+                {
+                    std::cerr << "Server: Entity " << entity->getNetID() << " wrote " << mEntityStateStream.length() << " bytes of state, which is more than can be replicated!" << std::endl;
+                    continue;
                 }
+
+                const Kiaro::Common::U8 *stateData = (const Kiaro::Common::U8 *)mEntityStateStream.raw();
+
+                Kiaro::Network::EntityState &state = currentSnapshot.mEntityStates[entity->getNetID()];
+                state.mTypeMask = entity->getTypeMask();
+                state.mData.assign(stateData, stateData + mEntityStateStream.length());
+                state.mSequence = mSnapshotSequence;
+                state.mFirstSequence = mSnapshotSequence;
+
+                // Any strings this adds to the table go out to every client before the snapshot does
+                mEntityStateStream.clear();
+                entity->packInitialization(mEntityStateStream, mStringTable);
+                mEntityStateStream.flushBits();
+
+                if (mEntityStateStream.length() > NETWORK_MAXIMUM_ENTITY_STATE_SIZE)
+                {
+                    std::cerr << "Server: Entity " << entity->getNetID() << " wrote " << mEntityStateStream.length() << " bytes of initialization, which is more than can be replicated!" << std::endl;
+                    currentSnapshot.mEntityStates.erase(entity->getNetID());
+                    continue;
+                }
+
+                const Kiaro::Common::U8 *initializationData = (const Kiaro::Common::U8 *)mEntityStateStream.raw();
+                state.mInitialization.assign(initializationData, initializationData + mEntityStateStream.length());
             }
 
-            mLastPacketSender = NULL;
+            Kiaro::Game::Packets::Snapshot snapshotPacket;
+            for (size_t iteration = 0; iteration < mClients.getCount(); iteration++)
+            {
+                Kiaro::Game::IncomingClient *client = static_cast<Kiaro::Game::IncomingClient *>(mClients.getClient(iteration));
+
+                if (client->getStage() < Kiaro::Game::Packets::Snapshot::sAcceptedStage)
+                    continue;
+
+                client->sendStrings(mStringTable);
+
+                // Entities that drop out of the relevant set are left out of the snapshot, which destroys them on the client
+                if (client->getPlayer())
+                    client->setViewpoint(client->getPlayer()->getPosition());
+
+                client->updateRelevance(mMapDivision);
+
+                // A missing or stale baseline makes encode fall back to full state
+                Kiaro::Network::Snapshot *baseline = client->getSnapshotHistory().getBaseline(mSnapshotSequence);
+                Kiaro::Network::Snapshot &clientSnapshot = client->getSnapshotHistory().push(mSnapshotSequence);
+
+                // Fill the client's byte budget with its highest priority entities
+                client->buildSnapshot(currentSnapshot, baseline, mEntityStateStream, clientSnapshot);
+
+                snapshotPacket.encode(clientSnapshot, baseline);
+                snapshotPacket.mInputSequence = client->getInputSequence();
+                snapshotPacket.mStringCount = mStringTable.getCount();
+
+                // The entity state is in the client's snapshot history, so it only gets copied into the ENet packet itself
+                mSnapshotWriter.clear();
+                snapshotPacket.pack(mSnapshotWriter);
+                client->send(mSnapshotWriter, snapshotPacket.getType(), Kiaro::Game::Packets::Snapshot::sTrafficClass);
+            }
         }
 
         Kiaro::Network::IncomingClientBase *ServerSingleton::getLastPacketSender(void)
@@ -99,7 +299,21 @@ namespace Kiaro
 
         void ServerSingleton::addStaticEntity(Kiaro::Game::Entities::EntityBase *entity)
         {
+            entity->setNetID(mNextNetID++);
             mStaticEntitySet.insert(entity);
         }
+
+        void ServerSingleton::addDynamicEntity(Kiaro::Game::Entities::EntityBase *entity)
+        {
+            entity->setNetID(mNextNetID++);
+            mDynamicEntitySet.insert(entity);
+            mMapDivision->insert(entity, entity->getPosition());
+        }
+
+        void ServerSingleton::removeDynamicEntity(Kiaro::Game::Entities::EntityBase *entity)
+        {
+            mDynamicEntitySet.erase(entity);
+            mMapDivision->remove(entity);
+        }
     } // End Namespace Game
 } // End Namespace Kiaro
@@ -12,6 +12,13 @@
  */
 
 #include <game/entities/EntityBase.hpp>
+#include <game/entities/RigidProp.hpp>
+#include <game/entities/Player.hpp>
+#include <game/entities/Types.hpp>
+
+#include <network/StringTable.hpp>
+
+#include <support/BitStream.hpp>
 
 namespace Kiaro
 {
@@ -19,7 +26,7 @@ namespace Kiaro
     {
         namespace Entities
         {
-            EntityBase::EntityBase(const Kiaro::Game::Entities::TypeMask &typeMask) : mTypeMask(typeMask), mNetID(0), mSceneNode(NULL) { }
+            EntityBase::EntityBase(const Kiaro::Game::Entities::TypeMask &typeMask) : mTypeMask(typeMask), mNetID(0), mSceneNode(NULL), mUpdateTime(0) { }
 
             EntityBase::~EntityBase(void)
             {
@@ -47,30 +54,112 @@ namespace Kiaro
                     mSceneNode->drop();
 
                 mSceneNode = sceneManager->addMeshSceneNode(shapeFileMesh);
+                mShapeFile = filename;
             }
 
             Kiaro::Common::U32 EntityBase::getTypeMask(void) const { return mTypeMask; }
 
             Kiaro::Common::U32 EntityBase::getNetID(void) const { return mNetID; }
 
-            void EntityBase::packUpdate(Kiaro::Support::BitStream &out)
+            void EntityBase::setNetID(const Kiaro::Common::U32 &netID) { mNetID = netID; }
+
+            Kiaro::Common::Vector3DF EntityBase::getPosition(void) const
+            {
+                if (mSceneNode)
+                    return mSceneNode->getPosition();
+
+                return Kiaro::Common::Vector3DF(0, 0, 0);
+            }
+
+            Kiaro::Common::Vector3DF EntityBase::getVelocity(void) const { return Kiaro::Common::Vector3DF(0, 0, 0); }
+
+            Kiaro::Common::F32 EntityBase::getNetworkPriority(void) const { return 1.0f; }
+
+            void EntityBase::packData(Kiaro::Support::BitStream &out) { packUpdate(out, getPropertyMask()); }
+
+            void EntityBase::unpackData(Kiaro::Support::BitStream &in) { unpackUpdate(in); }
+
+            Kiaro::Common::U32 EntityBase::getPropertyMask(void) const
+            {
+                const Kiaro::Common::U32 propertyCount = getPropertyCount();
+
+                return propertyCount >= 32 ? 0xFFFFFFFF : (1U << propertyCount) - 1;
+            }
+
+            void EntityBase::commitChanges(const Kiaro::Common::U32 &sequence)
+            {
+                const Kiaro::Common::U32 changedMask = collectChanges();
+
+                if (changedMask == 0)
+                    return;
+
+                mChangeSequences.resize(getPropertyCount(), 0);
+
+                for (Kiaro::Common::U32 iteration = 0; iteration < mChangeSequences.size(); iteration++)
+                    if (changedMask & (1U << iteration))
+                        mChangeSequences[iteration] = sequence;
+            }
+
+            Kiaro::Common::U32 EntityBase::getChangedMask(const Kiaro::Common::U32 &sequence) const
+            {
+                if (sequence == 0)
+                    return getPropertyMask();
+
+                Kiaro::Common::U32 result = 0;
+                for (Kiaro::Common::U32 iteration = 0; iteration < mChangeSequences.size(); iteration++)
+                    if (mChangeSequences[iteration] != 0 && (Kiaro::Common::S32)(mChangeSequences[iteration] - sequence) > 0)
+                        result |= 1U << iteration;
+
+                return result;
+            }
+
+            void EntityBase::packUpdate(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask)
             {
+                const Kiaro::Common::U32 propertyMask = mask & getPropertyMask();
 
+                packProperties(out, propertyMask);
+                out.writeBits(propertyMask, getPropertyCount());
             }
 
             void EntityBase::unpackUpdate(Kiaro::Support::BitStream &in)
             {
+                unpackProperties(in, in.readBits(getPropertyCount()));
+            }
 
+            void EntityBase::packInitialization(Kiaro::Support::BitStream &out, Kiaro::Network::StringTable &strings)
+            {
+                strings.writeReference(out, mShapeFile);
             }
 
-            void EntityBase::packInitialization(Kiaro::Support::BitStream &out)
+            void EntityBase::unpackInitialization(Kiaro::Support::BitStream &in, const Kiaro::Network::StringTable &strings)
             {
+                const std::string *shapeFile = strings.readReference(in);
+
+                if (shapeFile)
+                    setShapeFile(*shapeFile);
+            }
+
+            EntityBase *createEntity(const Kiaro::Game::Entities::TypeMask &typeMask)
+            {
+                switch (typeMask)
+                {
+                    case Kiaro::Game::Entities::ENTITY_RIGIDPROP:
+                        return new Kiaro::Game::Entities::RigidProp();
+                    case Kiaro::Game::Entities::ENTITY_PLAYER:
+                        return new Kiaro::Game::Entities::Player();
+                }
 
+                return NULL;
             }
 
-            void EntityBase::unpackInitialization(Kiaro::Support::BitStream &in)
+            Kiaro::Common::U32 getSchemaHash(void)
             {
+                // The type masks go in too, so that swapping two entities' fields around still changes the hash
+                Kiaro::Common::U32 result = Kiaro::Support::hashSchemaID(Kiaro::Support::sSchemaHashBasis, Kiaro::Game::Entities::ENTITY_RIGIDPROP);
+                result = Kiaro::Game::Entities::RigidProp::NetworkedFields::getSchemaHash(result);
 
+                result = Kiaro::Support::hashSchemaID(result, Kiaro::Game::Entities::ENTITY_PLAYER);
+                return Kiaro::Game::Entities::Player::NetworkedFields::getSchemaHash(result);
             }
         } // End Namespace Entities
     } // End Namespace Game
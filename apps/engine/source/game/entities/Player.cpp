@@ -0,0 +1,112 @@
+/**
+ *  @file Player.cpp
+ *  @brief Source file implementing the Kiaro::Game::Entities::Player class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#include <algorithm>
+
+#include <game/entities/Player.hpp>
+#include <game/entities/Types.hpp>
+
+#include <game/InputCommand.hpp>
+
+#include <support/BitStream.hpp>
+
+#include <engine/Config.hpp>
+
+namespace Kiaro
+{
+    namespace Game
+    {
+        namespace Entities
+        {
+            //! How fast a player moves in units per second.
+            static const Kiaro::Common::F32 sPlayerMoveSpeed = 8.0f;
+
+            Player::Player(void) : Kiaro::Game::Entities::EntityBase(Kiaro::Game::Entities::ENTITY_PLAYER), mIsPredicted(false)
+            {
+
+            }
+
+            Player::~Player(void)
+            {
+
+            }
+
+            Kiaro::Common::Vector3DF Player::getPosition(void) const { return mPosition; }
+
+            Kiaro::Common::Vector3DF Player::getVelocity(void) const { return mVelocity; }
+
+            void Player::applyInput(const Kiaro::Game::InputCommand &command)
+            {
+                Kiaro::Common::Vector3DF direction;
+
+                if (command.mButtons & Kiaro::Game::INPUT_FORWARD)
+                    direction.Z += 1.0f;
+                if (command.mButtons & Kiaro::Game::INPUT_BACKWARD)
+                    direction.Z -= 1.0f;
+                if (command.mButtons & Kiaro::Game::INPUT_RIGHT)
+                    direction.X += 1.0f;
+                if (command.mButtons & Kiaro::Game::INPUT_LEFT)
+                    direction.X -= 1.0f;
+
+                // Don't move any faster diagonally
+                if (direction.X != 0.0f && direction.Z != 0.0f)
+                    direction = direction * 0.70710678f;
+
+                mVelocity = direction * sPlayerMoveSpeed;
+                mPosition += mVelocity * (command.mDuration / 1000.0f);
+
+                mPosition.X = std::min(std::max(mPosition.X, NETWORK_POSITION_MINIMUM), NETWORK_POSITION_MAXIMUM);
+                mPosition.Z = std::min(std::max(mPosition.Z, NETWORK_POSITION_MINIMUM), NETWORK_POSITION_MAXIMUM);
+            }
+
+            void Player::packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask)
+            {
+                NetworkedFields::packFields(*this, mask, out);
+            }
+
+            void Player::unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask)
+            {
+                NetworkedFields::unpackFields(*this, mask, in);
+
+                // A predicted player has its unacknowledged input replayed on top of this by the client
+                mPositionHistory.push(mUpdateTime, mPosition);
+            }
+
+            void Player::instantiate(void)
+            {
+
+            }
+
+            void Player::interpolate(const Kiaro::Common::U32 &renderTime)
+            {
+                if (!mSceneNode)
+                    return;
+
+                if (mIsPredicted)
+                {
+                    mSceneNode->setPosition(mPosition);
+                    return;
+                }
+
+                Kiaro::Common::Vector3DF position;
+                if (mPositionHistory.sample(renderTime, NETWORK_EXTRAPOLATION_LIMIT, position))
+                    mSceneNode->setPosition(position);
+            }
+
+            void Player::update(const Kiaro::Common::F32 &deltaTimeSeconds)
+            {
+
+            }
+        } // End Namespace Entities
+    } // End Namespace Game
+} // End Namespace Kiaro
@@ -14,13 +14,18 @@
 #include <game/entities/RigidProp.hpp>
 #include <game/entities/Types.hpp>
 
+#include <support/BitStream.hpp>
+#include <support/FieldList.hpp>
+
+#include <engine/Config.hpp>
+
 namespace Kiaro
 {
     namespace Game
     {
         namespace Entities
         {
-            RigidProp::RigidProp(void) : Kiaro::Game::Entities::EntityBase(Kiaro::Game::Entities::ENTITY_RIGIDPROP)
+            RigidProp::RigidProp(void) : Kiaro::Game::Entities::EntityBase(Kiaro::Game::Entities::ENTITY_RIGIDPROP), mPosition(0, 0, 0)
             {
 
             }
@@ -30,29 +35,35 @@ namespace Kiaro
 
             }
 
-            void RigidProp::packUpdate(Kiaro::Support::BitStream &out)
+            void RigidProp::setPosition(const Kiaro::Common::Vector3DF &position)
             {
-
+                mPosition = position;
             }
 
-            void RigidProp::unpackUpdate(Kiaro::Support::BitStream &in)
+            void RigidProp::packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask)
             {
-
+                NetworkedFields::packFields(*this, mask, out);
             }
 
-            void RigidProp::packInitialization(Kiaro::Support::BitStream &out)
+            void RigidProp::unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask)
             {
+                NetworkedFields::unpackFields(*this, mask, in);
 
+                // The scene node is only moved once it's time to draw it there
+                mPositionHistory.push(mUpdateTime, mPosition);
             }
 
-            void RigidProp::unpackInitialization(Kiaro::Support::BitStream &in)
+            void RigidProp::instantiate(void)
             {
 
             }
 
-            void RigidProp::instantiate(void)
+            void RigidProp::interpolate(const Kiaro::Common::U32 &renderTime)
             {
+                Kiaro::Common::Vector3DF position;
 
+                if (mSceneNode && mPositionHistory.sample(renderTime, NETWORK_EXTRAPOLATION_LIMIT, position))
+                    mSceneNode->setPosition(position);
             }
 
             void RigidProp::update(const Kiaro::Common::F32 &deltaTimeSeconds)
@@ -15,8 +15,12 @@
 #include <game/entities/Types.hpp>
 #include <game/ServerSingleton.hpp>
 
+#include <network/StringTable.hpp>
+
 #include <support/BitStream.hpp>
+#include <support/FieldList.hpp>
 
+#include <engine/Config.hpp>
 #include <engine/FileReadObject.hpp>
 
 namespace Kiaro
@@ -31,9 +35,9 @@ namespace Kiaro
                 instantiate();
             }
 
-            Terrain::Terrain(Kiaro::Support::BitStream &in) : Kiaro::Game::Entities::EntityBase(Kiaro::Game::Entities::ENTITY_TERRAIN)
+            Terrain::Terrain(Kiaro::Support::BitStream &in, const Kiaro::Network::StringTable &strings) : Kiaro::Game::Entities::EntityBase(Kiaro::Game::Entities::ENTITY_TERRAIN)
             {
-                unpackInitialization(in);
+                unpackInitialization(in, strings);
             }
 
             Terrain::~Terrain(void)
@@ -41,42 +45,62 @@ namespace Kiaro
 
             }
 
-            void Terrain::packUpdate(Kiaro::Support::BitStream &out)
+            void Terrain::setPosition(const Kiaro::Common::Vector3DF &position)
             {
-                const Kiaro::Common::Vector3DF &position = mSceneNode->getPosition();
+                if (!mSceneNode)
+                    return;
 
+                mSceneNode->setPosition(position);
             }
 
-            void Terrain::unpackUpdate(Kiaro::Support::BitStream &in)
+            Kiaro::Common::Vector3DF Terrain::getScale(void) const
             {
+                if (mSceneNode)
+                    return mSceneNode->getScale();
 
+                return Kiaro::Common::Vector3DF(1, 1, 1);
             }
 
-            void Terrain::packInitialization(Kiaro::Support::BitStream &out)
+            void Terrain::setScale(const Kiaro::Common::Vector3DF &scale)
             {
-                const Kiaro::Common::Vector3DF &position = mSceneNode->getPosition();
+                if (!mSceneNode)
+                    return;
 
-                out.writeF32(position.X);
-                out.writeF32(position.Y);
-                out.writeF32(position.Z);
-                out.writeString(mTerrainFile);
+                mSceneNode->setScale(scale);
             }
 
-            void Terrain::unpackInitialization(Kiaro::Support::BitStream &in)
+            void Terrain::packProperties(Kiaro::Support::BitStream &out, const Kiaro::Common::U32 &mask)
             {
-                mTerrainFile = in.readString();
+                NetworkedFields::packFields(*this, mask, out);
+            }
 
-                instantiate();
+            void Terrain::unpackProperties(Kiaro::Support::BitStream &in, const Kiaro::Common::U32 &mask)
+            {
+                NetworkedFields::unpackFields(*this, mask, in);
+            }
 
-                if (mSceneNode)
+            void Terrain::packInitialization(Kiaro::Support::BitStream &out, Kiaro::Network::StringTable &strings)
+            {
+                Kiaro::Support::QuantizedPositionCodec::write(out, mSceneNode->getPosition());
+                strings.writeReference(out, mTerrainFile);
+            }
+
+            void Terrain::unpackInitialization(Kiaro::Support::BitStream &in, const Kiaro::Network::StringTable &strings)
+            {
+                const std::string *terrainFile = strings.readReference(in);
+                const Kiaro::Common::Vector3DF position = Kiaro::Support::QuantizedPositionCodec::read(in);
+
+                if (!terrainFile)
                 {
-                    Kiaro::Common::Vector3DF position;
-                    position.Z = in.readF32();
-                    position.Y = in.readF32();
-                    position.X = in.readF32();
+                    std::cerr << "Terrain: Received a terrain file that isn't in the string table" << std::endl;
+                    return;
+                }
 
+                mTerrainFile = *terrainFile;
+                instantiate();
+
+                if (mSceneNode)
                     mSceneNode->setPosition(position);
-                }
             }
 
             void Terrain::instantiate(void)
@@ -0,0 +1,105 @@
+/**
+ *  @file ClientTable.cpp
+ *  @brief Source file implementing the Kiaro::Network::ClientTable class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <stdexcept>
+
+#include <network/ClientTable.hpp>
+#include <network/IncomingClientBase.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        ClientTable::ClientTable(const Kiaro::Common::U32 &capacity)
+        {
+            if (capacity > 0x10000)
+                throw std::out_of_range("ClientTable: Too many slots for a client handle to address!");
+
+            Slot emptySlot;
+            emptySlot.mClient = NULL;
+            emptySlot.mGeneration = 1;
+            emptySlot.mPosition = 0;
+
+            mSlots.resize(capacity, emptySlot);
+            mClients.reserve(capacity);
+            mClientSlots.reserve(capacity);
+
+            // Hand out the lowest slots first
+            mFreeSlots.reserve(capacity);
+            for (Kiaro::Common::U32 iteration = capacity; iteration > 0; iteration--)
+                mFreeSlots.push_back(iteration - 1);
+        }
+
+        Kiaro::Network::ClientHandle ClientTable::insert(Kiaro::Network::IncomingClientBase *client)
+        {
+            if (mFreeSlots.empty())
+                return Kiaro::Network::ClientHandle();
+
+            const Kiaro::Common::U16 index = mFreeSlots.back();
+            mFreeSlots.pop_back();
+
+            Slot &slot = mSlots[index];
+            slot.mClient = client;
+            slot.mPosition = mClients.size();
+
+            mClients.push_back(client);
+            mClientSlots.push_back(index);
+
+            const Kiaro::Network::ClientHandle handle(index, slot.mGeneration);
+            client->setHandle(handle);
+
+            return handle;
+        }
+
+        Kiaro::Network::IncomingClientBase *ClientTable::remove(const Kiaro::Network::ClientHandle &handle)
+        {
+            Kiaro::Network::IncomingClientBase *client = get(handle);
+            if (!client)
+                return NULL;
+
+            Slot &slot = mSlots[handle.mIndex];
+
+            // Fill the hole with the last client so that the rest stay packed
+            const Kiaro::Common::U16 lastIndex = mClientSlots.back();
+            mClients[slot.mPosition] = mClients.back();
+            mClientSlots[slot.mPosition] = lastIndex;
+            mSlots[lastIndex].mPosition = slot.mPosition;
+
+            mClients.pop_back();
+            mClientSlots.pop_back();
+
+            slot.mClient = NULL;
+
+            // Generation 0 marks an invalid handle, so it is skipped when the generation wraps
+            if (++slot.mGeneration == 0)
+                slot.mGeneration = 1;
+
+            mFreeSlots.push_back(handle.mIndex);
+
+            client->setHandle(Kiaro::Network::ClientHandle());
+            return client;
+        }
+
+        Kiaro::Network::IncomingClientBase *ClientTable::get(const Kiaro::Network::ClientHandle &handle) const
+        {
+            if (!handle.isValid() || handle.mIndex >= mSlots.size())
+                return NULL;
+
+            const Slot &slot = mSlots[handle.mIndex];
+            if (slot.mGeneration != handle.mGeneration)
+                return NULL;
+
+            return slot.mClient;
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
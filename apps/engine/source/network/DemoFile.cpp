@@ -0,0 +1,159 @@
+/**
+ *  @file DemoFile.cpp
+ *  @brief Source file implementing the Kiaro::Network::DemoRecorder and Kiaro::Network::DemoPlayer classes.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <string.h>
+#include <stdexcept>
+
+#include <network/DemoFile.hpp>
+
+#include <support/BitStream.hpp>
+#include <support/EndianUtilities.hpp>
+#include <support/Time.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        //! The bytes every demo file starts with.
+        static const Kiaro::Common::C8 sDemoMagic[4] = { 'K', 'D', 'E', 'M' };
+        //! The version of the demo format, bumped whenever it changes.
+        static const Kiaro::Common::U8 sDemoVersion = 1;
+
+        //! The size of the fixed part of every record: the time since the previous record in microseconds, the sender, the
+        //! length and the type.
+        static const size_t sRecordHeaderSize = sizeof(Kiaro::Common::U32) + sizeof(Kiaro::Common::U16) * 2 + sizeof(Kiaro::Common::U8);
+
+        DemoRecorder::DemoRecorder(const std::string &fileName, const Kiaro::Network::DEMO_SOURCE &source) : mStartTime(Kiaro::Support::Time::getCurrentTimeMicroseconds()),
+        mLastTime(0), mRecordCount(0)
+        {
+            mFile.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+            if (!mFile.is_open())
+                throw std::runtime_error("DemoRecorder: Unable to create demo file!");
+
+            const Kiaro::Common::U8 sourceByte = source;
+
+            mFile.write(sDemoMagic, sizeof(sDemoMagic));
+            mFile.write((const Kiaro::Common::C8 *)&sDemoVersion, sizeof(sDemoVersion));
+            mFile.write((const Kiaro::Common::C8 *)&sourceByte, sizeof(sourceByte));
+        }
+
+        DemoRecorder::~DemoRecorder(void)
+        {
+            mFile.close();
+        }
+
+        void DemoRecorder::record(const Kiaro::Common::U16 &sender, const Kiaro::Common::U8 *data, const Kiaro::Common::U16 &length)
+        {
+            const Kiaro::Common::U64 currentTime = Kiaro::Support::Time::getCurrentTimeMicroseconds() - mStartTime;
+
+            // Read the type the same way PacketRegistry::dispatch does, without touching the caller's stream
+            Kiaro::Common::U8 type = 0;
+            if (length >= sizeof(Kiaro::Common::U8) * 2)
+            {
+                Kiaro::Support::BitStream headerStream((Kiaro::Common::U8 *)data, length, length);
+
+                // Malformed packets are recorded all the same, just without a type
+                try
+                {
+                    headerStream.readVarU32();
+                    type = headerStream.readVarU32();
+                }
+                catch (std::out_of_range &)
+                {
+                    type = 0;
+                }
+            }
+
+            // A gap of over an hour between packets is only shortened, which a replay can live with
+            const Kiaro::Common::U64 timeDelta = currentTime - mLastTime;
+            mLastTime = currentTime;
+
+            Kiaro::Common::U8 header[sRecordHeaderSize];
+            const Kiaro::Common::U32 storedTimeDelta = Kiaro::Support::ConvertLittleEndianU32(timeDelta > 0xFFFFFFFF ? 0xFFFFFFFF : (Kiaro::Common::U32)timeDelta);
+            const Kiaro::Common::U16 storedSender = Kiaro::Support::ConvertLittleEndianU16(sender);
+            const Kiaro::Common::U16 storedLength = Kiaro::Support::ConvertLittleEndianU16(length);
+
+            // Headers are little endian like everything sent over the network, so demos play back on any host
+            memcpy(header, &storedTimeDelta, sizeof(Kiaro::Common::U32));
+            memcpy(header + 4, &storedSender, sizeof(Kiaro::Common::U16));
+            memcpy(header + 6, &storedLength, sizeof(Kiaro::Common::U16));
+            header[8] = type;
+
+            mFile.write((const Kiaro::Common::C8 *)header, sRecordHeaderSize);
+            mFile.write((const Kiaro::Common::C8 *)data, length);
+
+            mRecordCount++;
+        }
+
+        DemoPlayer::DemoPlayer(const std::string &fileName) : mSource(Kiaro::Network::DEMO_SOURCE_CLIENT), mLastTime(0)
+        {
+            mFile.open(fileName.c_str(), std::ios::in | std::ios::binary);
+
+            if (!mFile.is_open())
+                throw std::runtime_error("DemoPlayer: Unable to open demo file!");
+
+            Kiaro::Common::C8 magic[sizeof(sDemoMagic)];
+            Kiaro::Common::U8 version = 0;
+            Kiaro::Common::U8 source = 0;
+
+            mFile.read(magic, sizeof(magic));
+            mFile.read((Kiaro::Common::C8 *)&version, sizeof(version));
+            mFile.read((Kiaro::Common::C8 *)&source, sizeof(source));
+
+            if (!mFile || memcmp(magic, sDemoMagic, sizeof(sDemoMagic)) != 0)
+                throw std::runtime_error("DemoPlayer: File is not a demo!");
+
+            if (version != sDemoVersion)
+                throw std::runtime_error("DemoPlayer: Demo was recorded with a different version of the format!");
+
+            if (source > Kiaro::Network::DEMO_SOURCE_CLIENT)
+                throw std::runtime_error("DemoPlayer: Demo has an unknown source!");
+
+            mSource = (Kiaro::Network::DEMO_SOURCE)source;
+        }
+
+        DemoPlayer::~DemoPlayer(void)
+        {
+            mFile.close();
+        }
+
+        bool DemoPlayer::read(Kiaro::Network::DemoRecord &out)
+        {
+            Kiaro::Common::U8 header[sRecordHeaderSize];
+            if (!mFile.read((Kiaro::Common::C8 *)header, sRecordHeaderSize))
+                return false;
+
+            Kiaro::Common::U32 timeDelta;
+            Kiaro::Common::U16 length;
+
+            memcpy(&timeDelta, header, sizeof(Kiaro::Common::U32));
+            memcpy(&out.mSender, header + 4, sizeof(Kiaro::Common::U16));
+            memcpy(&length, header + 6, sizeof(Kiaro::Common::U16));
+            out.mType = header[8];
+
+            timeDelta = Kiaro::Support::ConvertLittleEndianU32(timeDelta);
+            out.mSender = Kiaro::Support::ConvertLittleEndianU16(out.mSender);
+            length = Kiaro::Support::ConvertLittleEndianU16(length);
+
+            out.mData.resize(length);
+            if (length && !mFile.read((Kiaro::Common::C8 *)&out.mData[0], length))
+                return false;
+
+            mLastTime += timeDelta;
+            out.mTime = mLastTime;
+
+            return true;
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
@@ -0,0 +1,75 @@
+/**
+ *  @file ENetTransport.cpp
+ *  @brief Source code file defining logic for the Kiaro::Network::ENetTransport class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/5/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <stdexcept>
+
+#include <network/ENetTransport.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        ENetTransport::ENetTransport(const ENetAddress *address, const size_t &peerCount, const size_t &channelCount, const Kiaro::Common::U32 &incomingBandwidth, const Kiaro::Common::U32 &outgoingBandwidth) :
+        mHost(NULL)
+        {
+            mHost = enet_host_create(address, peerCount, channelCount, incomingBandwidth, outgoingBandwidth);
+
+            if (!mHost)
+                throw std::runtime_error("ENetTransport: Failed to create ENet host!");
+        }
+
+        ENetTransport::~ENetTransport(void)
+        {
+            enet_host_destroy(mHost);
+            mHost = NULL;
+        }
+
+        ENetPeer *ENetTransport::connect(const ENetAddress &address, const size_t &channelCount)
+        {
+            return enet_host_connect(mHost, &address, channelCount, 0);
+        }
+
+        Kiaro::Common::S32 ENetTransport::service(ENetEvent &event, const Kiaro::Common::U32 &timeout)
+        {
+            return enet_host_service(mHost, &event, timeout);
+        }
+
+        Kiaro::Common::S32 ENetTransport::send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet)
+        {
+            return enet_peer_send(peer, channel, packet);
+        }
+
+        void ENetTransport::flush(void)
+        {
+            enet_host_flush(mHost);
+        }
+
+        void ENetTransport::disconnect(ENetPeer *peer, const bool &now)
+        {
+            if (now)
+                enet_peer_disconnect_now(peer, 0);
+            else
+                enet_peer_disconnect(peer, 0);
+        }
+
+        void ENetTransport::reset(ENetPeer *peer)
+        {
+            enet_peer_reset(peer);
+        }
+
+        Kiaro::Common::U32 ENetTransport::getTime(void)
+        {
+            return enet_time_get();
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
@@ -17,12 +17,15 @@
 #include <iostream>
 
 #include <network/IncomingClientBase.hpp>
+#include <network/ServerBase.hpp>
+#include <network/Transport.hpp>
 
 namespace Kiaro
 {
     namespace Network
     {
-        IncomingClientBase::IncomingClientBase(ENetPeer *connecting, Kiaro::Network::ServerBase *server) : mInternalClient(connecting)
+        IncomingClientBase::IncomingClientBase(ENetPeer *connecting, Kiaro::Network::ServerBase *server) : mCurrentStage(0), mInternalClient(connecting), mServer(server),
+        mMessageChannels(&mStatistics)
         {
 
         }
@@ -32,32 +35,64 @@ namespace Kiaro
 
         }
 
+        void IncomingClientBase::reset(ENetPeer *connecting)
+        {
+            mCurrentStage = 0;
+            mInternalClient = connecting;
+
+            mMessageChannels.clear();
+            mStatistics = Kiaro::Network::NetworkStatistics();
+            mSnapshotHistory.clear();
+        }
+
         void IncomingClientBase::onReceivePacket(Kiaro::Support::BitStream &incomingStream) { }
 
-        void IncomingClientBase::send(Kiaro::Network::PacketBase *packet, const bool &reliable)
+        void IncomingClientBase::send(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass)
         {
-            Kiaro::Common::U32 packet_flag = ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
-            if (reliable)
-                packet_flag = ENET_PACKET_FLAG_RELIABLE;
+            mMessageChannels.append(packet, trafficClass);
+        }
 
-                // TODO: Packet Size Query
-                Kiaro::Support::BitStream outStream(NULL, 0, 0);
-                packet->packData(outStream);
+        void IncomingClientBase::send(const void *message, const Kiaro::Common::U32 &length, const Kiaro::Common::U32 &packetType,
+        const Kiaro::Common::U64 &serializeMicroseconds, Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            mMessageChannels.append(message, length, packetType, serializeMicroseconds, trafficClass);
+        }
 
-                ENetPacket *enetPacket = enet_packet_create(outStream.raw(), outStream.length(), packet_flag);
-                enet_peer_send(mInternalClient, 0, enetPacket);
+        void IncomingClientBase::send(Kiaro::Support::GatherWriter &message, const Kiaro::Common::U32 &packetType, Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            mMessageChannels.append(message, packetType, trafficClass);
         }
 
-        bool IncomingClientBase::getIsOppositeEndian(void) { return mIsOppositeEndian; }
+        void IncomingClientBase::flush(void)
+        {
+            // Clients replayed from a demo have no peer to send to
+            if (!mInternalClient)
+            {
+                mMessageChannels.clear();
+                return;
+            }
+
+            mMessageChannels.flush(mServer->getTransport(), mInternalClient);
+        }
+
+        const Kiaro::Network::NetworkStatistics &IncomingClientBase::sampleStatistics(void)
+        {
+            Kiaro::Network::LinkStatistics link;
+            const bool hasLink = mInternalClient && mServer->getTransport()->sampleLink(mInternalClient, link);
+
+            mStatistics.sample(hasLink ? &link : NULL);
+            return mStatistics;
+        }
 
         void IncomingClientBase::disconnect(void)
         {
-            enet_peer_disconnect_now(mInternalClient, 0);
+            if (mInternalClient)
+                mServer->getTransport()->disconnect(mInternalClient, true);
         }
 
         Kiaro::Common::U16 IncomingClientBase::getPort(void)
         {
-            return mInternalClient->address.port;
+            return mInternalClient ? mInternalClient->address.port : 0;
         }
     } // End Namespace Network
 } // End Namespace Kiaro
@@ -0,0 +1,387 @@
+/**
+ *  @file LoopbackTransport.cpp
+ *  @brief Source code file defining logic for the Kiaro::Network::LoopbackNetwork and Kiaro::Network::LoopbackTransport classes.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/5/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+#include <boost/thread/thread.hpp>
+
+#include <network/LoopbackTransport.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        LoopbackNetwork::LoopbackNetwork(const Kiaro::Common::U32 &seed, const bool &simulatedTime) : mRandom(seed), mSimulatedTime(simulatedTime), mTime(0),
+        mStartTime(boost::posix_time::microsec_clock::universal_time()), mNextConnectID(1), mNextEphemeralPort(49152), mDeliveryCount(0)
+        {
+
+        }
+
+        LoopbackNetwork::~LoopbackNetwork(void)
+        {
+            if (!mTransports.empty())
+                std::cerr << "LoopbackNetwork: Destroyed while " << mTransports.size() << " transports were still using it!" << std::endl;
+        }
+
+        void LoopbackNetwork::setConditions(const Kiaro::Network::LinkConditions &conditions)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+            mConditions = conditions;
+        }
+
+        Kiaro::Network::LinkConditions LoopbackNetwork::getConditions(void)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+            return mConditions;
+        }
+
+        Kiaro::Common::U64 LoopbackNetwork::getTime(void)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+            return getTimeLocked();
+        }
+
+        void LoopbackNetwork::advance(const Kiaro::Common::U32 &milliseconds)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            if (mSimulatedTime)
+                mTime += milliseconds;
+        }
+
+        void LoopbackNetwork::bind(Kiaro::Network::LoopbackTransport *transport)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            if (transport->mPort == 0)
+            {
+                while (mTransports.count(mNextEphemeralPort))
+                    mNextEphemeralPort = mNextEphemeralPort == 0xFFFF ? 49152 : mNextEphemeralPort + 1;
+
+                transport->mPort = mNextEphemeralPort;
+            }
+            else if (mTransports.count(transport->mPort))
+                throw std::runtime_error("LoopbackNetwork: Port is already in use!");
+
+            mTransports[transport->mPort] = transport;
+        }
+
+        void LoopbackNetwork::unbind(Kiaro::Network::LoopbackTransport *transport)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            mTransports.erase(transport->mPort);
+
+            // The remote ends find out as they would when a host goes away
+            const Kiaro::Common::U64 currentTime = getTimeLocked();
+            for (std::vector<ENetPeer *>::iterator it = transport->mPeers.begin(); it != transport->mPeers.end(); it++)
+            {
+                ENetPeer *remote = mPeerStates[*it].mRemote;
+
+                if (remote)
+                {
+                    mPeerStates[remote].mRemote = NULL;
+                    deliver(remote, ENET_EVENT_TYPE_DISCONNECT, NULL, 0, currentTime + getTravelTime());
+                }
+
+                mPeerStates.erase(*it);
+                delete *it;
+            }
+
+            for (std::map<Kiaro::Network::LoopbackTransport::DeliveryKey, ENetEvent>::iterator it = transport->mIncomingEvents.begin(); it != transport->mIncomingEvents.end(); it++)
+                if (it->second.packet)
+                    enet_packet_destroy(it->second.packet);
+
+            transport->mPeers.clear();
+            transport->mIncomingEvents.clear();
+        }
+
+        ENetPeer *LoopbackNetwork::connect(Kiaro::Network::LoopbackTransport *transport, const ENetAddress &address, const size_t &channelCount)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            const Kiaro::Common::U32 connectID = mNextConnectID++;
+            ENetPeer *local = createPeer(transport, address.port, connectID);
+
+            // Nobody is listening, so the connection just never completes
+            std::map<Kiaro::Common::U16, Kiaro::Network::LoopbackTransport *>::iterator target = mTransports.find(address.port);
+            if (target == mTransports.end() || target->second == transport)
+                return local;
+
+            ENetPeer *remote = createPeer(target->second, transport->mPort, connectID);
+
+            PeerState &localState = mPeerStates[local];
+            PeerState &remoteState = mPeerStates[remote];
+            localState.mRemote = remote;
+            remoteState.mRemote = local;
+
+            // The listening end hears of the connection after one trip and the connecting end after the round trip
+            const Kiaro::Common::U64 currentTime = getTimeLocked();
+            remoteState.mConnectTime = currentTime + getTravelTime();
+            localState.mConnectTime = remoteState.mConnectTime + getTravelTime();
+
+            deliver(remote, ENET_EVENT_TYPE_CONNECT, NULL, 0, remoteState.mConnectTime);
+            deliver(local, ENET_EVENT_TYPE_CONNECT, NULL, 0, localState.mConnectTime);
+
+            return local;
+        }
+
+        Kiaro::Common::S32 LoopbackNetwork::service(Kiaro::Network::LoopbackTransport *transport, ENetEvent &event, const Kiaro::Common::U32 &timeout)
+        {
+            boost::unique_lock<boost::mutex> lock(mMutex);
+
+            const Kiaro::Common::U64 deadline = getTimeLocked() + timeout;
+            while (true)
+            {
+                const Kiaro::Common::U64 currentTime = getTimeLocked();
+
+                std::map<Kiaro::Network::LoopbackTransport::DeliveryKey, ENetEvent>::iterator next = transport->mIncomingEvents.begin();
+                while (next != transport->mIncomingEvents.end() && next->first.first <= currentTime)
+                {
+                    ENetEvent pending = next->second;
+                    transport->mIncomingEvents.erase(next);
+                    next = transport->mIncomingEvents.begin();
+
+                    // The peer was reset or dropped locally since this was sent
+                    if (pending.peer->connectID == 0)
+                    {
+                        if (pending.packet)
+                            enet_packet_destroy(pending.packet);
+
+                        continue;
+                    }
+
+                    if (pending.type == ENET_EVENT_TYPE_DISCONNECT)
+                        pending.peer->connectID = 0;
+
+                    event = pending;
+                    return 1;
+                }
+
+                if (currentTime >= deadline)
+                    return 0;
+
+                Kiaro::Common::U64 wakeTime = deadline;
+                if (next != transport->mIncomingEvents.end())
+                    wakeTime = std::min(wakeTime, next->first.first);
+
+                if (mSimulatedTime)
+                {
+                    mTime = wakeTime;
+                    continue;
+                }
+
+                lock.unlock();
+                boost::this_thread::sleep(boost::posix_time::milliseconds(wakeTime - currentTime));
+                lock.lock();
+            }
+        }
+
+        Kiaro::Common::S32 LoopbackNetwork::send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            std::map<ENetPeer *, PeerState>::iterator state = mPeerStates.find(peer);
+            if (state == mPeerStates.end() || peer->connectID == 0)
+                return -1;
+
+            // The other end went away without saying so; the packet goes nowhere
+            if (!state->second.mRemote)
+            {
+                enet_packet_destroy(packet);
+                return 0;
+            }
+
+            // Packets leave one after another at the bandwidth limit, then travel for the latency
+            const Kiaro::Common::U64 currentTime = getTimeLocked();
+            const Kiaro::Common::U64 sendTime = mConditions.mBandwidth ? packet->dataLength * 1000 / mConditions.mBandwidth : 0;
+
+            state->second.mLinkFreeTime = std::max(currentTime, state->second.mLinkFreeTime) + sendTime;
+
+            Kiaro::Common::U64 arrivalTime = state->second.mLinkFreeTime + getTravelTime();
+            arrivalTime = std::max(arrivalTime, mPeerStates[state->second.mRemote].mConnectTime);
+
+            if (packet->flags & ENET_PACKET_FLAG_RELIABLE)
+            {
+                if (mConditions.mLoss >= 1.0f)
+                {
+                    enet_packet_destroy(packet);
+                    return 0;
+                }
+
+                // Each loss costs a resend after the round trip, and reliable packets never overtake each other
+                while (getRandomChance() < mConditions.mLoss)
+                    arrivalTime += mConditions.mLatency * 2 + 1;
+
+                Kiaro::Common::U64 &lastArrivalTime = state->second.mReliableArrivalTimes[channel];
+                arrivalTime = std::max(arrivalTime, lastArrivalTime);
+                lastArrivalTime = arrivalTime;
+            }
+            else
+            {
+                if (getRandomChance() < mConditions.mLoss)
+                {
+                    enet_packet_destroy(packet);
+                    return 0;
+                }
+
+                if (getRandomChance() < mConditions.mReorder)
+                    arrivalTime += mConditions.mLatency + 1;
+            }
+
+            deliver(state->second.mRemote, ENET_EVENT_TYPE_RECEIVE, packet, channel, arrivalTime);
+            return 0;
+        }
+
+        void LoopbackNetwork::disconnect(ENetPeer *peer, const bool &now)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            std::map<ENetPeer *, PeerState>::iterator state = mPeerStates.find(peer);
+            if (state == mPeerStates.end() || peer->connectID == 0)
+                return;
+
+            const Kiaro::Common::U64 currentTime = getTimeLocked();
+            Kiaro::Common::U64 arrivalTime = currentTime + getTravelTime();
+
+            // A graceful disconnect lets the reliable packets already sent arrive first
+            if (!now)
+                for (std::map<Kiaro::Common::U8, Kiaro::Common::U64>::iterator it = state->second.mReliableArrivalTimes.begin(); it != state->second.mReliableArrivalTimes.end(); it++)
+                    arrivalTime = std::max(arrivalTime, it->second);
+
+            ENetPeer *remote = state->second.mRemote;
+            if (remote)
+            {
+                mPeerStates[remote].mRemote = NULL;
+                deliver(remote, ENET_EVENT_TYPE_DISCONNECT, NULL, 0, arrivalTime);
+            }
+
+            state->second.mRemote = NULL;
+
+            if (now)
+                peer->connectID = 0;
+            else
+                deliver(peer, ENET_EVENT_TYPE_DISCONNECT, NULL, 0, arrivalTime + getTravelTime());
+        }
+
+        void LoopbackNetwork::reset(ENetPeer *peer)
+        {
+            boost::lock_guard<boost::mutex> lock(mMutex);
+
+            std::map<ENetPeer *, PeerState>::iterator state = mPeerStates.find(peer);
+            if (state == mPeerStates.end())
+                return;
+
+            // The remote end isn't told; whatever it sends from now on is lost
+            if (state->second.mRemote)
+                mPeerStates[state->second.mRemote].mRemote = NULL;
+
+            state->second.mRemote = NULL;
+            peer->connectID = 0;
+        }
+
+        ENetPeer *LoopbackNetwork::createPeer(Kiaro::Network::LoopbackTransport *owner, const Kiaro::Common::U16 &remotePort, const Kiaro::Common::U32 &connectID)
+        {
+            ENetPeer *peer = new ENetPeer();
+            peer->address.host = ENET_HOST_TO_NET_32(0x7F000001);
+            peer->address.port = remotePort;
+            peer->connectID = connectID;
+
+            owner->mPeers.push_back(peer);
+
+            PeerState &state = mPeerStates[peer];
+            state.mOwner = owner;
+            state.mRemote = NULL;
+            state.mConnectTime = 0;
+            state.mLinkFreeTime = 0;
+
+            return peer;
+        }
+
+        void LoopbackNetwork::deliver(ENetPeer *peer, const ENetEventType &type, ENetPacket *packet, const Kiaro::Common::U8 &channel, const Kiaro::Common::U64 &time)
+        {
+            ENetEvent event;
+            event.type = type;
+            event.peer = peer;
+            event.channelID = channel;
+            event.data = 0;
+            event.packet = packet;
+
+            mPeerStates[peer].mOwner->mIncomingEvents[Kiaro::Network::LoopbackTransport::DeliveryKey(time, mDeliveryCount++)] = event;
+        }
+
+        Kiaro::Common::U64 LoopbackNetwork::getTravelTime(void)
+        {
+            if (!mConditions.mJitter)
+                return mConditions.mLatency;
+
+            return mConditions.mLatency + mRandom() % (mConditions.mJitter + 1);
+        }
+
+        Kiaro::Common::F32 LoopbackNetwork::getRandomChance(void)
+        {
+            // Only the top 24 bits, so that the result is exact in a float and never reaches 1
+            return (mRandom() >> 8) / 16777216.0f;
+        }
+
+        Kiaro::Common::U64 LoopbackNetwork::getTimeLocked(void)
+        {
+            if (mSimulatedTime)
+                return mTime;
+
+            return (boost::posix_time::microsec_clock::universal_time() - mStartTime).total_milliseconds();
+        }
+
+        LoopbackTransport::LoopbackTransport(Kiaro::Network::LoopbackNetwork *network, const Kiaro::Common::U16 &port) : mNetwork(network), mPort(port)
+        {
+            mNetwork->bind(this);
+        }
+
+        LoopbackTransport::~LoopbackTransport(void)
+        {
+            mNetwork->unbind(this);
+        }
+
+        ENetPeer *LoopbackTransport::connect(const ENetAddress &address, const size_t &channelCount)
+        {
+            return mNetwork->connect(this, address, channelCount);
+        }
+
+        Kiaro::Common::S32 LoopbackTransport::service(ENetEvent &event, const Kiaro::Common::U32 &timeout)
+        {
+            return mNetwork->service(this, event, timeout);
+        }
+
+        Kiaro::Common::S32 LoopbackTransport::send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet)
+        {
+            return mNetwork->send(peer, channel, packet);
+        }
+
+        void LoopbackTransport::disconnect(ENetPeer *peer, const bool &now)
+        {
+            mNetwork->disconnect(peer, now);
+        }
+
+        void LoopbackTransport::reset(ENetPeer *peer)
+        {
+            mNetwork->reset(peer);
+        }
+
+        Kiaro::Common::U32 LoopbackTransport::getTime(void)
+        {
+            return (Kiaro::Common::U32)mNetwork->getTime();
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
@@ -0,0 +1,200 @@
+/**
+ *  @file MessageBuffer.cpp
+ *  @brief Source code file defining logic for the Kiaro::Network::MessageBuffer class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#include <string.h>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+#include <engine/Config.hpp>
+
+#include <support/BitStream.hpp>
+#include <support/GatherWriter.hpp>
+#include <support/EndianUtilities.hpp>
+#include <support/Time.hpp>
+
+#include <network/PacketBase.hpp>
+#include <network/MessageBuffer.hpp>
+#include <network/Transport.hpp>
+#include <network/NetworkStatistics.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        //! The size of the length prefix in front of every message.
+        static const size_t sLengthPrefixSize = sizeof(Kiaro::Common::U16);
+
+        MessageBuffer::MessageBuffer(const Kiaro::Common::U8 &channel, const Kiaro::Common::U32 &packetFlags, Kiaro::Network::NetworkStatistics *statistics) : mChannel(channel),
+        mPacketFlags(packetFlags), mStatistics(statistics), mCurrentPacket(NULL), mCurrentLength(0)
+        {
+
+        }
+
+        MessageBuffer::~MessageBuffer(void)
+        {
+            clear();
+        }
+
+        void MessageBuffer::clear(void)
+        {
+            closePacket();
+
+            for (std::vector<ENetPacket *>::iterator it = mPendingPackets.begin(); it != mPendingPackets.end(); it++)
+                enet_packet_destroy(*it);
+
+            mPendingPackets.clear();
+        }
+
+        Kiaro::Common::U8 *MessageBuffer::reserve(const size_t &length)
+        {
+            if (mCurrentPacket && mCurrentLength + length > mCurrentPacket->dataLength)
+                closePacket();
+
+            // Messages too large to share a packet get one of their own
+            if (!mCurrentPacket)
+            {
+                mCurrentPacket = enet_packet_create(NULL, std::max<size_t>(length, NETWORK_MESSAGE_BUFFER_SIZE), mPacketFlags);
+                mCurrentLength = 0;
+            }
+
+            return mCurrentPacket->data + mCurrentLength;
+        }
+
+        void MessageBuffer::closePacket(void)
+        {
+            if (!mCurrentPacket)
+                return;
+
+            enet_packet_resize(mCurrentPacket, mCurrentLength);
+            mPendingPackets.push_back(mCurrentPacket);
+
+            mCurrentPacket = NULL;
+            mCurrentLength = 0;
+        }
+
+        void MessageBuffer::append(Kiaro::Network::PacketBase *packet)
+        {
+            const Kiaro::Common::U32 packetSize = packet->getPacketSize();
+
+            // Pack directly into the ENet packet rather than packing elsewhere and copying it over
+            Kiaro::Common::U8 *destination = reserve(sLengthPrefixSize + packetSize);
+
+            const Kiaro::Common::U64 packStartTime = mStatistics ? Kiaro::Support::Time::getCurrentTimeMicroseconds() : 0;
+
+            Kiaro::Support::BitStream outStream(destination + sLengthPrefixSize, packetSize, 0);
+            packet->packData(outStream);
+            outStream.flushBits();
+
+            // If getPacketSize() came up short, the stream will have moved on to memory of its own
+            if (outStream.capacity() != packetSize)
+            {
+                std::cerr << "MessageBuffer: Packet type " << packet->getType() << " wrote " << outStream.length() << " bytes but reported a size of " << packetSize << "!" << std::endl;
+
+                append(outStream.raw(), outStream.length(), packet->getType(), Kiaro::Support::Time::getCurrentTimeMicroseconds() - packStartTime);
+                return;
+            }
+
+            if (outStream.length() > 0xFFFF)
+                throw std::runtime_error("MessageBuffer: Message is too long to be sent!");
+
+            const Kiaro::Common::U16 messageLength = outStream.length();
+            const Kiaro::Common::U16 wireLength = Kiaro::Support::ConvertLittleEndianU16(messageLength);
+            memcpy(destination, &wireLength, sLengthPrefixSize);
+
+            mCurrentLength += sLengthPrefixSize + messageLength;
+
+            if (mStatistics)
+                mStatistics->recordMessageSent(packet->getType(), messageLength, Kiaro::Support::Time::getCurrentTimeMicroseconds() - packStartTime);
+        }
+
+        void MessageBuffer::append(const void *message, const Kiaro::Common::U32 &length, const Kiaro::Common::U32 &packetType,
+        const Kiaro::Common::U64 &serializeMicroseconds)
+        {
+            if (length > 0xFFFF)
+                throw std::runtime_error("MessageBuffer: Message is too long to be sent!");
+
+            Kiaro::Common::U8 *destination = reserve(sLengthPrefixSize + length);
+
+            const Kiaro::Common::U16 wireLength = Kiaro::Support::ConvertLittleEndianU16(length);
+            memcpy(destination, &wireLength, sLengthPrefixSize);
+            memcpy(destination + sLengthPrefixSize, message, length);
+
+            mCurrentLength += sLengthPrefixSize + length;
+
+            if (mStatistics)
+                mStatistics->recordMessageSent(packetType, length, serializeMicroseconds);
+        }
+
+        void MessageBuffer::append(Kiaro::Support::GatherWriter &message, const Kiaro::Common::U32 &packetType)
+        {
+            const Kiaro::Common::U64 gatherStartTime = mStatistics ? Kiaro::Support::Time::getCurrentTimeMicroseconds() : 0;
+
+            const size_t length = message.length();
+            if (length > 0xFFFF)
+                throw std::runtime_error("MessageBuffer: Message is too long to be sent!");
+
+            Kiaro::Common::U8 *destination = reserve(sLengthPrefixSize + length);
+
+            const Kiaro::Common::U16 wireLength = Kiaro::Support::ConvertLittleEndianU16(length);
+            memcpy(destination, &wireLength, sLengthPrefixSize);
+            message.gather(destination + sLengthPrefixSize);
+
+            mCurrentLength += sLengthPrefixSize + length;
+
+            if (mStatistics)
+                mStatistics->recordMessageSent(packetType, length, Kiaro::Support::Time::getCurrentTimeMicroseconds() - gatherStartTime);
+        }
+
+        void MessageBuffer::flush(Kiaro::Network::Transport *transport, ENetPeer *peer)
+        {
+            closePacket();
+
+            for (std::vector<ENetPacket *>::iterator it = mPendingPackets.begin(); it != mPendingPackets.end(); it++)
+            {
+                // The transport may have destroyed the packet already once it accepts it
+                const Kiaro::Common::U32 packetLength = (*it)->dataLength;
+
+                if (transport->send(peer, mChannel, *it) < 0)
+                    enet_packet_destroy(*it);
+                else if (mStatistics)
+                    mStatistics->recordPacketSent(packetLength);
+            }
+
+            mPendingPackets.clear();
+        }
+
+        bool MessageBuffer::split(const Kiaro::Common::U8 *data, const size_t &length, std::vector<std::pair<size_t, Kiaro::Common::U16> > &out)
+        {
+            // Walked from the front, the same way messages were appended
+            Kiaro::Support::BitStream inStream((Kiaro::Common::U8 *)data, length, length);
+            inStream.setForward(true);
+
+            while (inStream.getRemaining() > 0)
+            {
+                if (inStream.getRemaining() < sLengthPrefixSize)
+                    return false;
+
+                const Kiaro::Common::U16 messageLength = inStream.readU16();
+
+                if (inStream.getRemaining() < messageLength)
+                    return false;
+
+                out.push_back(std::make_pair(length - inStream.getRemaining(), messageLength));
+                inStream.read(messageLength);
+            }
+
+            return true;
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
@@ -0,0 +1,87 @@
+/**
+ *  @file MessageChannels.cpp
+ *  @brief Source file implementing the Kiaro::Network::MessageChannels class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <network/MessageChannels.hpp>
+#include <network/MessageBuffer.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        MessageChannels::MessageChannels(Kiaro::Network::NetworkStatistics *statistics)
+        {
+            for (Kiaro::Common::U32 iteration = 0; iteration < Kiaro::Network::TRAFFIC_CLASS_COUNT; iteration++)
+            {
+                const Kiaro::Network::TRAFFIC_CLASS trafficClass = (Kiaro::Network::TRAFFIC_CLASS)iteration;
+                mBuffers[iteration] = new Kiaro::Network::MessageBuffer(iteration, getPacketFlags(trafficClass), statistics);
+            }
+        }
+
+        MessageChannels::~MessageChannels(void)
+        {
+            for (Kiaro::Common::U32 iteration = 0; iteration < Kiaro::Network::TRAFFIC_CLASS_COUNT; iteration++)
+                delete mBuffers[iteration];
+        }
+
+        void MessageChannels::append(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            mBuffers[trafficClass]->append(packet);
+        }
+
+        void MessageChannels::append(const void *message, const Kiaro::Common::U32 &length, const Kiaro::Common::U32 &packetType,
+        const Kiaro::Common::U64 &serializeMicroseconds, Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            mBuffers[trafficClass]->append(message, length, packetType, serializeMicroseconds);
+        }
+
+        void MessageChannels::append(Kiaro::Support::GatherWriter &message, const Kiaro::Common::U32 &packetType, Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            mBuffers[trafficClass]->append(message, packetType);
+        }
+
+        void MessageChannels::flush(Kiaro::Network::Transport *transport, ENetPeer *peer)
+        {
+            for (Kiaro::Common::U32 iteration = 0; iteration < Kiaro::Network::TRAFFIC_CLASS_COUNT; iteration++)
+                mBuffers[iteration]->flush(transport, peer);
+        }
+
+        void MessageChannels::clear(void)
+        {
+            for (Kiaro::Common::U32 iteration = 0; iteration < Kiaro::Network::TRAFFIC_CLASS_COUNT; iteration++)
+                mBuffers[iteration]->clear();
+        }
+
+        Kiaro::Common::U32 MessageChannels::getPacketFlags(Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            switch (trafficClass)
+            {
+                case Kiaro::Network::TRAFFIC_RELIABLE_ORDERED:
+                case Kiaro::Network::TRAFFIC_RELIABLE_UNORDERED:
+                    return ENET_PACKET_FLAG_RELIABLE;
+
+                // ENet sequences unreliable packets on a channel unless told otherwise
+                case Kiaro::Network::TRAFFIC_UNRELIABLE_SEQUENCED:
+                    return ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+
+                case Kiaro::Network::TRAFFIC_UNRELIABLE:
+                    return ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT | ENET_PACKET_FLAG_UNSEQUENCED;
+
+                // Pipe down compiler warnings
+                case Kiaro::Network::TRAFFIC_CLASS_COUNT:
+                    break;
+            }
+
+            return ENET_PACKET_FLAG_RELIABLE;
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
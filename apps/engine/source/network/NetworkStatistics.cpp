@@ -0,0 +1,126 @@
+/**
+ *  @file NetworkStatistics.cpp
+ *  @brief Source file implementing the Kiaro::Network::NetworkStatistics class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <string.h>
+
+#include <network/NetworkStatistics.hpp>
+
+#include <support/Time.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        NetworkStatistics::NetworkStatistics(void) : mWindowStartTime(Kiaro::Support::Time::getCurrentTimeMicroseconds()), mLastWindowLength(0),
+        mRoundTripTime(0), mRoundTripTimeVariance(0), mPacketLoss(0.0f), mReliableBytesInTransit(0)
+        {
+            memset(&mTotals, 0x00, sizeof(mTotals));
+            memset(&mWindow, 0x00, sizeof(mWindow));
+            memset(&mLastWindow, 0x00, sizeof(mLastWindow));
+            memset(mPacketTypes, 0x00, sizeof(mPacketTypes));
+        }
+
+        void NetworkStatistics::recordMessageSent(const Kiaro::Common::U32 &packetType, const Kiaro::Common::U32 &length, const Kiaro::Common::U64 &serializeMicroseconds)
+        {
+            mTotals.mMessagesSent++;
+            mWindow.mMessagesSent++;
+
+            if (packetType >= NETWORK_MAXIMUM_PACKET_TYPES)
+                return;
+
+            PacketTypeCounters &counters = mPacketTypes[packetType];
+            counters.mSentCount++;
+            counters.mSentBytes += length;
+            counters.mSerializeMicroseconds += serializeMicroseconds;
+        }
+
+        void NetworkStatistics::recordMessageReceived(const Kiaro::Common::U32 &packetType, const Kiaro::Common::U32 &length, const Kiaro::Common::U64 &dispatchMicroseconds)
+        {
+            mTotals.mMessagesReceived++;
+            mWindow.mMessagesReceived++;
+
+            if (packetType >= NETWORK_MAXIMUM_PACKET_TYPES)
+                return;
+
+            PacketTypeCounters &counters = mPacketTypes[packetType];
+            counters.mReceivedCount++;
+            counters.mReceivedBytes += length;
+            counters.mDispatchMicroseconds += dispatchMicroseconds;
+        }
+
+        void NetworkStatistics::recordPacketSent(const Kiaro::Common::U32 &length)
+        {
+            mTotals.mPacketsSent++;
+            mTotals.mBytesSent += length;
+            mWindow.mPacketsSent++;
+            mWindow.mBytesSent += length;
+        }
+
+        void NetworkStatistics::recordPacketReceived(const Kiaro::Common::U32 &length)
+        {
+            mTotals.mPacketsReceived++;
+            mTotals.mBytesReceived += length;
+            mWindow.mPacketsReceived++;
+            mWindow.mBytesReceived += length;
+        }
+
+        void NetworkStatistics::sample(const Kiaro::Network::LinkStatistics *link)
+        {
+            const Kiaro::Common::U64 currentTime = Kiaro::Support::Time::getCurrentTimeMicroseconds();
+
+            mLastWindow = mWindow;
+            mLastWindowLength = currentTime - mWindowStartTime;
+
+            memset(&mWindow, 0x00, sizeof(mWindow));
+            mWindowStartTime = currentTime;
+
+            if (!link)
+                return;
+
+            mRoundTripTime = link->mRoundTripTime;
+            mRoundTripTimeVariance = link->mRoundTripTimeVariance;
+            mPacketLoss = link->mPacketLoss / (Kiaro::Common::F32)ENET_PEER_PACKET_LOSS_SCALE;
+            mReliableBytesInTransit = link->mReliableBytesInTransit;
+        }
+
+        void NetworkStatistics::write(std::ostream &out, const std::string &name) const
+        {
+            const Kiaro::Common::F64 windowSeconds = mLastWindowLength / 1000000.0;
+            const Kiaro::Common::F64 rateScale = windowSeconds > 0.0 ? 1.0 / windowSeconds : 0.0;
+
+            out << name << ": rtt " << mRoundTripTime << "ms (+/- " << mRoundTripTimeVariance << "ms), loss " << mPacketLoss * 100.0f
+            << "%, " << mReliableBytesInTransit << " reliable bytes in transit" << std::endl;
+
+            out << name << ": out " << mLastWindow.mPacketsSent * rateScale << " packets/s, " << mLastWindow.mBytesSent * rateScale << " bytes/s, "
+            << mLastWindow.mMessagesSent * rateScale << " messages/s; in " << mLastWindow.mPacketsReceived * rateScale << " packets/s, "
+            << mLastWindow.mBytesReceived * rateScale << " bytes/s, " << mLastWindow.mMessagesReceived * rateScale << " messages/s over "
+            << windowSeconds << " seconds" << std::endl;
+
+            out << name << ": total out " << mTotals.mPacketsSent << " packets, " << mTotals.mBytesSent << " bytes; total in "
+            << mTotals.mPacketsReceived << " packets, " << mTotals.mBytesReceived << " bytes" << std::endl;
+
+            for (Kiaro::Common::U32 iteration = 0; iteration < NETWORK_MAXIMUM_PACKET_TYPES; iteration++)
+            {
+                const PacketTypeCounters &counters = mPacketTypes[iteration];
+
+                if (counters.mSentCount == 0 && counters.mReceivedCount == 0)
+                    continue;
+
+                out << name << ":   type " << iteration << ": sent " << counters.mSentCount << " (" << counters.mSentBytes << " bytes, "
+                << (counters.mSentCount ? counters.mSerializeMicroseconds / (Kiaro::Common::F64)counters.mSentCount : 0.0) << "us to pack), received "
+                << counters.mReceivedCount << " (" << counters.mReceivedBytes << " bytes, "
+                << (counters.mReceivedCount ? counters.mDispatchMicroseconds / (Kiaro::Common::F64)counters.mReceivedCount : 0.0) << "us to handle)" << std::endl;
+            }
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
@@ -0,0 +1,241 @@
+/**
+ *  @file NetworkThread.cpp
+ *  @brief Source code file defining logic for the Kiaro::Network::NetworkThread class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/5/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <network/NetworkThread.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        NetworkThread::NetworkThread(Kiaro::Network::Transport *transport, const std::vector<ENetPeer *> &connectedPeers) : mTransport(transport), mIsRunning(true)
+        {
+            // Nothing else is touching the peers until the thread starts
+            for (std::vector<ENetPeer *>::const_iterator it = connectedPeers.begin(); it != connectedPeers.end(); it++)
+                mConnectIDs[*it] = (*it)->connectID;
+
+            // Everything else has to be ready before the thread can look at it
+            mThread = boost::thread(boost::bind(&NetworkThread::run, this));
+        }
+
+        NetworkThread::~NetworkThread(void)
+        {
+            stop();
+        }
+
+        void NetworkThread::stop(void)
+        {
+            if (!mThread.joinable())
+                return;
+
+            mIsRunning = false;
+            mThread.join();
+
+            Event event;
+            while (mIncomingEvents.pop(event))
+                if (event.mEvent.type == ENET_EVENT_TYPE_RECEIVE)
+                    enet_packet_destroy(event.mEvent.packet);
+        }
+
+        ENetPeer *NetworkThread::connect(const ENetAddress &address, const size_t &channelCount)
+        {
+            std::cerr << "NetworkThread: Connections must be made before the network thread is started!" << std::endl;
+            return NULL;
+        }
+
+        Kiaro::Common::S32 NetworkThread::service(ENetEvent &event, const Kiaro::Common::U32 &timeout)
+        {
+            Event incomingEvent;
+            if (!mIncomingEvents.pop(incomingEvent))
+                return 0;
+
+            event = incomingEvent.mEvent;
+
+            // Readings of whatever connection the peer was used for before mean nothing for this one
+            if (event.type == ENET_EVENT_TYPE_CONNECT)
+            {
+                mConnectIDs[event.peer] = incomingEvent.mConnectID;
+                mLinks.erase(event.peer);
+            }
+
+            return 1;
+        }
+
+        Kiaro::Common::S32 NetworkThread::send(ENetPeer *peer, const Kiaro::Common::U8 &channel, ENetPacket *packet)
+        {
+            Command command;
+            command.mType = Command::COMMAND_SEND;
+            command.mChannel = channel;
+            command.mPacket = packet;
+
+            return pushCommand(command, peer) ? 0 : -1;
+        }
+
+        void NetworkThread::disconnect(ENetPeer *peer, const bool &now)
+        {
+            Command command;
+            command.mType = now ? Command::COMMAND_DISCONNECT_NOW : Command::COMMAND_DISCONNECT;
+            command.mChannel = 0;
+            command.mPacket = NULL;
+
+            pushCommand(command, peer);
+        }
+
+        void NetworkThread::reset(ENetPeer *peer)
+        {
+            Command command;
+            command.mType = Command::COMMAND_RESET;
+            command.mChannel = 0;
+            command.mPacket = NULL;
+
+            pushCommand(command, peer);
+        }
+
+        Kiaro::Common::U32 NetworkThread::getTime(void)
+        {
+            // Reading the clock doesn't touch the transport's state, so it is safe to do from this thread
+            return mTransport->getTime();
+        }
+
+        bool NetworkThread::pushCommand(Command &command, ENetPeer *peer)
+        {
+            // The live connectID belongs to the network thread, so only the one recorded on connect is used here
+            std::map<ENetPeer *, enet_uint32>::const_iterator connectID = mConnectIDs.find(peer);
+            if (connectID == mConnectIDs.end())
+            {
+                std::cerr << "NetworkThread: Ignoring a request for a peer that never connected through the network thread!" << std::endl;
+                return false;
+            }
+
+            command.mPeer = peer;
+            command.mConnectID = connectID->second;
+
+            pushCommand(command);
+            return true;
+        }
+
+        bool NetworkThread::sampleLink(ENetPeer *peer, Kiaro::Network::LinkStatistics &link)
+        {
+            LinkSample sample;
+            while (mLinkSamples.pop(sample))
+                mLinks[sample.mPeer] = sample.mLink;
+
+            Command command;
+            command.mType = Command::COMMAND_SAMPLE;
+            command.mChannel = 0;
+            command.mPacket = NULL;
+
+            if (!pushCommand(command, peer))
+                return false;
+
+            std::map<ENetPeer *, Kiaro::Network::LinkStatistics>::const_iterator latest = mLinks.find(peer);
+            if (latest == mLinks.end())
+                return false;
+
+            link = latest->second;
+            return true;
+        }
+
+        void NetworkThread::pushCommand(const Command &command)
+        {
+            while (!mOutgoingCommands.push(command))
+                boost::this_thread::yield();
+        }
+
+        void NetworkThread::execute(Command &command)
+        {
+            // The peer was disconnected and possibly handed to someone else since this was queued
+            if (command.mPeer->connectID != command.mConnectID)
+            {
+                if (command.mPacket)
+                    enet_packet_destroy(command.mPacket);
+
+                return;
+            }
+
+            switch (command.mType)
+            {
+                case Command::COMMAND_SEND:
+                {
+                    if (mTransport->send(command.mPeer, command.mChannel, command.mPacket) < 0)
+                        enet_packet_destroy(command.mPacket);
+
+                    break;
+                }
+
+                case Command::COMMAND_DISCONNECT:
+                case Command::COMMAND_DISCONNECT_NOW:
+                {
+                    mTransport->disconnect(command.mPeer, command.mType == Command::COMMAND_DISCONNECT_NOW);
+                    break;
+                }
+
+                case Command::COMMAND_RESET:
+                {
+                    mTransport->reset(command.mPeer);
+                    break;
+                }
+
+                case Command::COMMAND_SAMPLE:
+                {
+                    // Dropped if the simulation thread hasn't picked up the last ones, as it'll ask again next sample
+                    LinkSample sample;
+                    sample.mPeer = command.mPeer;
+
+                    if (mTransport->sampleLink(command.mPeer, sample.mLink))
+                        mLinkSamples.push(sample);
+
+                    break;
+                }
+            }
+        }
+
+        void NetworkThread::run(void)
+        {
+            while (mIsRunning)
+            {
+                Command command;
+                while (mOutgoingCommands.pop(command))
+                    execute(command);
+
+                // Anything serviced now would have nowhere to go, so leave it with ENet until the simulation catches up
+                if (mIncomingEvents.full())
+                {
+                    mTransport->flush();
+                    boost::this_thread::sleep(boost::posix_time::milliseconds(NETWORK_THREAD_SERVICE_TIMEOUT));
+
+                    continue;
+                }
+
+                Event event;
+                if (mTransport->service(event.mEvent, NETWORK_THREAD_SERVICE_TIMEOUT) > 0)
+                {
+                    // Read while this thread is the only one that may touch the peer
+                    event.mConnectID = event.mEvent.type == ENET_EVENT_TYPE_CONNECT ? event.mEvent.peer->connectID : 0;
+                    mIncomingEvents.push(event);
+                }
+            }
+
+            // Whatever was queued before stop was called still goes out
+            Command command;
+            while (mOutgoingCommands.pop(command))
+                execute(command);
+
+            mTransport->flush();
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
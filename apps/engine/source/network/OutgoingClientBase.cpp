@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <iostream>
+#include <stdexcept>
 
 #include <boost/regex.hpp>
 
@@ -22,8 +23,14 @@
 
 #include <support/BitStream.hpp>
 
+#include <engine/Config.hpp>
 #include <engine/Logging.hpp>
 #include <network/OutgoingClientBase.hpp>
+#include <network/NetworkThread.hpp>
+#include <network/ENetTransport.hpp>
+#include <network/MessageBuffer.hpp>
+#include <network/ScopedPacket.hpp>
+#include <network/DemoFile.hpp>
 
 #include <game/packets/packets.hpp>
 
@@ -31,44 +38,29 @@ namespace Kiaro
 {
     namespace Network
     {
-        OutgoingClientBase::OutgoingClientBase() : mIsConnected(false), mPort(0), mCurrentStage(0), mInternalPeer(NULL), mInternalHost(NULL)
+        OutgoingClientBase::OutgoingClientBase() : mConnectionState(Kiaro::Network::CONNECTION_DISCONNECTED), mPort(0), mCurrentStage(0), mInternalPeer(NULL), mTransport(NULL),
+        mUsesNetworkThread(false), mNetworkThread(NULL), mStateStartTime(0), mConnectTimeout(0), mConnectAttemptsLeft(0),
+        mDemoRecorder(NULL), mMessageChannels(&mStatistics)
         {
 
         }
 
         OutgoingClientBase::~OutgoingClientBase(void)
         {
-            if (mInternalPeer)
-            {
-                enet_peer_reset(mInternalPeer);
-                mInternalPeer = NULL;
-            }
-
-            if (mInternalHost)
-            {
-                enet_host_destroy(mInternalHost);
-                mInternalHost = NULL;
-            }
+            close();
+            stopRecording();
         }
 
-        void OutgoingClientBase::send(Kiaro::Network::PacketBase *packet, const bool &reliable)
+        void OutgoingClientBase::send(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass)
         {
-            Kiaro::Common::U32 packetFlag = ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
-            if (reliable)
-                packetFlag = ENET_PACKET_FLAG_RELIABLE;
-
-            // TODO: Packet Size Query
-            Kiaro::Support::BitStream outStream(NULL, 0, 0);
-            packet->packData(outStream);
-
-            ENetPacket *enetPacket = enet_packet_create(outStream.raw(), outStream.length(), packetFlag);
-            enet_peer_send(mInternalPeer, 0, enetPacket);
+            mMessageChannels.append(packet, trafficClass);
         }
 
-        void OutgoingClientBase::connect(const std::string &targetAddress, const Kiaro::Common::U16 &targetPort, const Kiaro::Common::U32 &wait)
+        void OutgoingClientBase::connect(const std::string &targetAddress, const Kiaro::Common::U16 &targetPort, const Kiaro::Common::U32 &timeout,
+        const Kiaro::Common::U32 &attempts)
         {
 			// TODO (Robert MacGregor#9): Report Error
-			if (mInternalPeer || mInternalHost)
+			if (mTransport)
 				return;
 
             // FIXME: IP Octets >= 256
@@ -86,101 +78,279 @@ namespace Kiaro
             enet_address_set_host(&enetAddress, targetAddress.c_str());
             enetAddress.port = targetPort;
 
-            mInternalHost = enet_host_create(NULL /* create a client host */,
+            connect(new Kiaro::Network::ENetTransport(NULL /* create a client host */,
                             1 /* only allow 1 outgoing connection */,
-                            2 /* allow up 2 channels to be used, 0 and 1 */,
-                            57600 / 8 /* 56K modem with 56 Kbps downstream bandwidth */,
-                            14400 / 8 /* 56K modem with 14 Kbps upstream bandwidth */);
+                            Kiaro::Network::TRAFFIC_CLASS_COUNT /* one channel per traffic class */,
+                            NETWORK_CLIENT_INCOMING_BANDWIDTH,
+                            NETWORK_CLIENT_OUTGOING_BANDWIDTH), enetAddress, timeout, attempts);
+        }
 
-            mInternalPeer = enet_host_connect(mInternalHost, &enetAddress, 2, 0);
+        void OutgoingClientBase::connect(Kiaro::Network::Transport *transport, const ENetAddress &address, const Kiaro::Common::U32 &timeout,
+        const Kiaro::Common::U32 &attempts)
+        {
+            if (mTransport)
+            {
+                delete transport;
+                return;
+            }
 
-            ENetEvent event;
-            if (enet_host_service(mInternalHost, &event, wait) > 0 && event.type == ENET_EVENT_TYPE_CONNECT)
+            mTransport = transport;
+            mAddress = address;
+            mConnectTimeout = timeout;
+            mConnectAttemptsLeft = attempts;
+            mConnectionState = Kiaro::Network::CONNECTION_CONNECTING;
+
+            attemptConnect();
+        }
+
+        void OutgoingClientBase::attemptConnect(void)
+        {
+            if (mConnectAttemptsLeft > 0)
             {
-                mCurrentStage = 0;
+                mConnectAttemptsLeft--;
 
-                onConnected();
-                mIsConnected = true;
+                mStateStartTime = mTransport->getTime();
+                mInternalPeer = mTransport->connect(mAddress, Kiaro::Network::TRAFFIC_CLASS_COUNT);
 
-                //this->address = enet_address.host;
-                mPort = targetPort;
-                return;
+                if (mInternalPeer)
+                    return;
             }
 
             std::cerr << "OutgoingClientBase: Failed to connect to remote host" << std::endl;
 
+            close();
             onConnectFailed();
-            enet_peer_reset(mInternalPeer);
         }
 
-        void OutgoingClientBase::disconnect(const Kiaro::Common::U32 wait)
+        void OutgoingClientBase::disconnect(void)
         {
-            mIsConnected = false;
+            switch (mConnectionState)
+            {
+                // Nobody is listening for us yet, so just give up on it
+                case Kiaro::Network::CONNECTION_CONNECTING:
+                {
+                    close();
+                    break;
+                }
 
-            if (!mInternalHost || !mIsConnected)
-                return;
+                case Kiaro::Network::CONNECTION_CONNECTED:
+                {
+                    Kiaro::Network::Transport *transport = getTransport();
+
+                    // Send it right away in case we're destroyed before the next dispatch
+                    transport->disconnect(mInternalPeer, false);
+                    transport->flush();
 
-            enet_peer_disconnect(mInternalPeer, 0);
+                    mStateStartTime = transport->getTime();
+                    mConnectionState = Kiaro::Network::CONNECTION_DISCONNECTING;
+                    break;
+                }
 
+                // Pipe down compiler warnings
+                case Kiaro::Network::CONNECTION_DISCONNECTED:
+                case Kiaro::Network::CONNECTION_DISCONNECTING:
+                    break;
+            }
+        }
+
+        void OutgoingClientBase::close(void)
+        {
+            delete mNetworkThread;
+            mNetworkThread = NULL;
+
+            if (mInternalPeer)
+            {
+                mTransport->reset(mInternalPeer);
+                mInternalPeer = NULL;
+            }
+
+            delete mTransport;
+            mTransport = NULL;
+
+            // Whatever was queued was meant for this server
+            mMessageChannels.clear();
+
+            mCurrentStage = 0;
+            mConnectionState = Kiaro::Network::CONNECTION_DISCONNECTED;
+        }
+
+        Kiaro::Network::Transport *OutgoingClientBase::getTransport(void)
+        {
+            return mNetworkThread ? mNetworkThread : mTransport;
+        }
+
+        void OutgoingClientBase::update(void)
+        {
+            // Handling an event may hand the transport to a network thread or bring it down, so look it up every time
             ENetEvent event;
-			// TODO(Robert MacGregor#5): Wait for disconnect event that doesn't come immediately?
-            while (enet_host_service(mInternalHost, &event, wait) > 0)
-                switch (event.type)
-                {
-                    case ENET_EVENT_TYPE_DISCONNECT:
-                    {
-                    	enet_host_destroy(mInternalHost);
-						mInternalHost = NULL;
+            Kiaro::Network::Transport *transport;
+            while ((transport = getTransport()) && transport->service(event, 0) > 0)
+                processEvent(event);
 
-                        break;
-                    }
-                    case ENET_EVENT_TYPE_RECEIVE:
-                        enet_packet_destroy(event.packet);
+            if (!mTransport)
+                return;
 
-                        break;
+            const Kiaro::Common::U32 elapsedTime = getTransport()->getTime() - mStateStartTime;
 
-                    // Shutup compiler warnings
-                    case ENET_EVENT_TYPE_NONE:
+            switch (mConnectionState)
+            {
+                case Kiaro::Network::CONNECTION_CONNECTING:
+                {
+                    if (elapsedTime < mConnectTimeout)
                         break;
-                    case ENET_EVENT_TYPE_CONNECT:
+
+                    std::cerr << "OutgoingClientBase: Timed out connecting to remote host" << std::endl;
+
+                    mTransport->reset(mInternalPeer);
+                    mInternalPeer = NULL;
+
+                    attemptConnect();
+                    break;
+                }
+
+                case Kiaro::Network::CONNECTION_DISCONNECTING:
+                {
+                    if (elapsedTime < NETWORK_DISCONNECT_TIMEOUT)
                         break;
+
+                    // The server never acknowledged it, so just drop the connection
+                    close();
+                    onDisconnected();
+
+                    break;
                 }
 
-            onDisconnected();
+                // Pipe down compiler warnings
+                case Kiaro::Network::CONNECTION_DISCONNECTED:
+                case Kiaro::Network::CONNECTION_CONNECTED:
+                    break;
+            }
         }
 
-        void OutgoingClientBase::update(void)
+        void OutgoingClientBase::processEvent(ENetEvent &event)
         {
-            ENetEvent event;
-            while (enet_host_service(mInternalHost, &event, 0) > 0)
+            switch(event.type)
             {
-                switch(event.type)
+                case ENET_EVENT_TYPE_CONNECT:
+                {
+                    if (mConnectionState != Kiaro::Network::CONNECTION_CONNECTING)
+                        break;
+
+                    mConnectionState = Kiaro::Network::CONNECTION_CONNECTED;
+                    mCurrentStage = 0;
+                    mPort = mAddress.port;
+                    mStatistics = Kiaro::Network::NetworkStatistics();
+
+                    if (mUsesNetworkThread)
+                        mNetworkThread = new Kiaro::Network::NetworkThread(mTransport, std::vector<ENetPeer *>(1, mInternalPeer));
+
+                    onConnected();
+
+                    break;
+                }
+
+                case ENET_EVENT_TYPE_DISCONNECT:
                 {
-                    case ENET_EVENT_TYPE_DISCONNECT:
+                    // The server turned us away, or ENet gave up on the attempt before we did
+                    if (mConnectionState == Kiaro::Network::CONNECTION_CONNECTING)
                     {
-                        onDisconnected();
+                        mInternalPeer = NULL;
+                        attemptConnect();
 
                         break;
                     }
 
-                    case ENET_EVENT_TYPE_RECEIVE:
-                    {
-                        Kiaro::Support::BitStream incomingStream(event.packet->data, event.packet->dataLength, event.packet->dataLength);
-                        onReceivePacket(incomingStream);
+                    close();
+                    onDisconnected();
 
-                        break;
+                    break;
+                }
+
+                case ENET_EVENT_TYPE_RECEIVE:
+                {
+                    const Kiaro::Network::ScopedPacket packet(event.packet);
+                    mStatistics.recordPacketReceived(event.packet->dataLength);
+
+                    std::vector<std::pair<size_t, Kiaro::Common::U16> > messages;
+                    if (!Kiaro::Network::MessageBuffer::split(event.packet->data, event.packet->dataLength, messages))
+                        std::cerr << "OutgoingClientBase: Received a malformed packet from the server" << std::endl;
+
+                    for (std::vector<std::pair<size_t, Kiaro::Common::U16> >::iterator it = messages.begin(); it != messages.end(); it++)
+                    {
+                        if (mDemoRecorder)
+                            mDemoRecorder->record(0, event.packet->data + it->first, it->second);
+
+                        Kiaro::Support::BitStream incomingStream(event.packet->data + it->first, it->second, it->second);
+
+                        try
+                        {
+                            onReceivePacket(incomingStream);
+                        }
+                        catch (std::exception &e)
+                        {
+                            // Whatever follows can't be trusted either, so there's no telling what state we'd end up in
+                            std::cerr << "OutgoingClientBase: Disconnecting after a malformed message from the server: " << e.what() << std::endl;
+                            disconnect();
+
+                            break;
+                        }
                     }
 
-                    // Pipe down compiler warnings
-                    case ENET_EVENT_TYPE_NONE:
-                    case ENET_EVENT_TYPE_CONNECT:
-                        break;
+                    break;
                 }
+
+                // Pipe down compiler warnings
+                case ENET_EVENT_TYPE_NONE:
+                    break;
             }
         }
 
-        bool OutgoingClientBase::isConnected(void) { return mIsConnected; }
+        const Kiaro::Network::NetworkStatistics &OutgoingClientBase::sampleStatistics(void)
+        {
+            Kiaro::Network::LinkStatistics link;
+            const bool hasLink = mConnectionState == Kiaro::Network::CONNECTION_CONNECTED && getTransport()->sampleLink(mInternalPeer, link);
+
+            mStatistics.sample(hasLink ? &link : NULL);
+            return mStatistics;
+        }
+
+        void OutgoingClientBase::startRecording(const std::string &fileName)
+        {
+            stopRecording();
+            mDemoRecorder = new Kiaro::Network::DemoRecorder(fileName, Kiaro::Network::DEMO_SOURCE_CLIENT);
+        }
+
+        void OutgoingClientBase::stopRecording(void)
+        {
+            delete mDemoRecorder;
+            mDemoRecorder = NULL;
+        }
+
+        void OutgoingClientBase::replay(const Kiaro::Network::DemoRecord &record)
+        {
+            if (record.mData.empty())
+                return;
+
+            // The stream only reads, so it is fine for it to point at the record's own copy of the packet
+            Kiaro::Support::BitStream incomingStream((Kiaro::Common::U8 *)&record.mData[0], record.mData.size(), record.mData.size());
+            onReceivePacket(incomingStream);
+
+            // There is nobody to answer
+            mMessageChannels.clear();
+        }
+
+        bool OutgoingClientBase::isConnected(void) { return mConnectionState == Kiaro::Network::CONNECTION_CONNECTED; }
 
-        void OutgoingClientBase::dispatch(void) { if (mInternalHost) enet_host_flush(mInternalHost); }
+        void OutgoingClientBase::dispatch(void)
+        {
+            if (mConnectionState != Kiaro::Network::CONNECTION_CONNECTED)
+                return;
+
+            Kiaro::Network::Transport *transport = getTransport();
+
+            mMessageChannels.flush(transport, mInternalPeer);
+
+            transport->flush();
+        }
     } // End Namespace Network
 } // End Namespace Kiaro
@@ -0,0 +1,100 @@
+/**
+ *  @file PacketRegistry.cpp
+ *  @brief Source code file defining logic for the Kiaro::Network::PacketRegistry class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#include <string.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <support/BitStream.hpp>
+#include <support/Time.hpp>
+
+#include <network/PacketRegistry.hpp>
+#include <network/NetworkStatistics.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        PacketRegistry::PacketRegistry(void)
+        {
+            memset(mEntries, 0x00, sizeof(mEntries));
+        }
+
+        PacketRegistry::~PacketRegistry(void)
+        {
+            for (Kiaro::Common::U32 iteration = 0; iteration < NETWORK_MAXIMUM_PACKET_TYPES; iteration++)
+                if (mEntries[iteration].mHandler)
+                    mEntries[iteration].mDestroyer(mEntries[iteration].mHandler);
+        }
+
+        Kiaro::Network::TRAFFIC_CLASS PacketRegistry::getTrafficClass(const Kiaro::Common::U32 &packetType)
+        {
+            if (packetType >= NETWORK_MAXIMUM_PACKET_TYPES || !mEntries[packetType].mHandler)
+                throw std::out_of_range("PacketRegistry: Packet type is not registered!");
+
+            return mEntries[packetType].mTrafficClass;
+        }
+
+        bool PacketRegistry::dispatch(Kiaro::Support::BitStream &incomingStream, Kiaro::Network::IncomingClientBase *sender, const Kiaro::Common::U8 &currentStage,
+        Kiaro::Network::NetworkStatistics *statistics)
+        {
+            const Kiaro::Common::U32 messageLength = incomingStream.length();
+
+            // Read the header in the same order as PacketBase::unpackData
+            Kiaro::Common::U32 packetID = 0;
+            Kiaro::Common::U32 packetType = 0;
+
+            try
+            {
+                packetID = incomingStream.readVarU32();
+                packetType = incomingStream.readVarU32();
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "PacketRegistry: Received a packet with a malformed header: " << e.what() << std::endl;
+                return false;
+            }
+
+            if (packetType >= NETWORK_MAXIMUM_PACKET_TYPES || !mEntries[packetType].mHandler)
+            {
+                std::cerr << "PacketRegistry: Received unknown packet type " << packetType << "!" << std::endl;
+                return false;
+            }
+
+            const PacketEntry &entry = mEntries[packetType];
+            if (currentStage < entry.mAcceptedStage)
+            {
+                std::cerr << "PacketRegistry: Received packet type " << packetType << " in stage " << (Kiaro::Common::U32)currentStage
+                << ", but it is only accepted from stage " << (Kiaro::Common::U32)entry.mAcceptedStage << "!" << std::endl;
+                return false;
+            }
+
+            const Kiaro::Common::U64 dispatchStartTime = statistics ? Kiaro::Support::Time::getCurrentTimeMicroseconds() : 0;
+
+            try
+            {
+                entry.mDecoder(entry.mHandler, incomingStream, sender, packetID);
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "PacketRegistry: Unable to handle packet type " << packetType << ": " << e.what() << std::endl;
+                return false;
+            }
+
+            if (statistics)
+                statistics->recordMessageReceived(packetType, messageLength, Kiaro::Support::Time::getCurrentTimeMicroseconds() - dispatchStartTime);
+
+            return true;
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
@@ -15,38 +15,58 @@
 #include <string.h>
 #include <stdio.h>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <engine/Config.hpp>
 
 #include <network/IncomingClientBase.hpp>
 #include <network/ServerBase.hpp>
+#include <network/NetworkThread.hpp>
+#include <network/ENetTransport.hpp>
+#include <network/DemoFile.hpp>
+#include <network/MessageBuffer.hpp>
+#include <network/ScopedPacket.hpp>
+
+#include <support/Time.hpp>
 
 namespace Kiaro
 {
     namespace Network
     {
-        ServerBase::ServerBase(const std::string &listenAddress, const Kiaro::Common::U16 &listenPort, const Kiaro::Common::U32 &maximumClientCount) : mIsRunning(true), mInternalHost(NULL),
-        mListenPort(listenPort), mListenAddress(listenAddress)
+        ServerBase::ServerBase(const std::string &listenAddress, const Kiaro::Common::U16 &listenPort, const Kiaro::Common::U32 &maximumClientCount) : mIsRunning(true), mTransport(NULL), mNetworkThread(NULL),
+        mListenPort(listenPort), mListenAddress(listenAddress), mClients(maximumClientCount), mBroadcastStream(NETWORK_MESSAGE_BUFFER_SIZE), mDemoRecorder(NULL)
         {
             ENetAddress enetAddress;
             enetAddress.port = listenPort;
             enet_address_set_host(&enetAddress, listenAddress.c_str());
 
-            mInternalHost = enet_host_create(&enetAddress, maximumClientCount, 2, 0, 0);
-            if (!mInternalHost)
-            {
-                mIsRunning = false;
+            mTransport = new Kiaro::Network::ENetTransport(&enetAddress, maximumClientCount, Kiaro::Network::TRAFFIC_CLASS_COUNT, NETWORK_SERVER_INCOMING_BANDWIDTH, NETWORK_SERVER_OUTGOING_BANDWIDTH);
+        }
+
+        ServerBase::ServerBase(Kiaro::Network::Transport *transport, const Kiaro::Common::U32 &maximumClientCount) : mIsRunning(true), mTransport(transport),
+        mNetworkThread(NULL), mListenPort(0), mListenAddress(""), mClients(maximumClientCount), mBroadcastStream(NETWORK_MESSAGE_BUFFER_SIZE), mDemoRecorder(NULL)
+        {
 
-                throw std::runtime_error("ServerBase: Failed to create ENet host!");
-                   return;
-            }
         }
 
         ServerBase::~ServerBase(void)
         {
-            if (mInternalHost)
-            {
-                enet_host_destroy(mInternalHost);
-                mInternalHost = NULL;
-            }
+            // The thread has to let go of the transport before it can be destroyed
+            delete mNetworkThread;
+            mNetworkThread = NULL;
+
+            delete mTransport;
+            mTransport = NULL;
+
+            stopRecording();
+
+            // Whoever is still connected goes down with the server
+            while (mClients.getCount())
+                delete mClients.remove(mClients.getClient(0)->getHandle());
+
+            for (std::vector<Kiaro::Network::IncomingClientBase *>::iterator it = mClientPool.begin(); it != mClientPool.end(); it++)
+                delete *it;
 
             mIsRunning = false;
 
@@ -57,71 +77,283 @@ namespace Kiaro
 
         Kiaro::Common::U32 ServerBase::getClientCount(void)
         {
-            return mConnectedClientSet.size();
+            return mClients.getCount();
         }
 
-        void ServerBase::globalSend(Kiaro::Network::PacketBase *packet, const bool &reliable)
+        void ServerBase::globalSend(Kiaro::Network::PacketBase *packet, Kiaro::Network::TRAFFIC_CLASS trafficClass, ClientFilter *filter)
         {
-            for (std::set<size_t>::iterator it = mConnectedClientSet.begin(); it != mConnectedClientSet.end(); it++)
+            if (!mClients.getCount())
+                return;
+
+            // Pack once; each recipient only gets a copy of the bytes, which keeps it in order with the rest of their messages
+            const Kiaro::Common::U64 packStartTime = Kiaro::Support::Time::getCurrentTimeMicroseconds();
+
+            mBroadcastStream.clear();
+            packet->packData(mBroadcastStream);
+            mBroadcastStream.flushBits();
+
+            // Every recipient is charged for the one packing they share
+            const Kiaro::Common::U64 packMicroseconds = Kiaro::Support::Time::getCurrentTimeMicroseconds() - packStartTime;
+            const Kiaro::Common::U32 packetType = packet->getType();
+
+            for (size_t iteration = 0; iteration < mClients.getCount(); iteration++)
             {
-                Kiaro::Network::IncomingClientBase *currentRecipient = (Kiaro::Network::IncomingClientBase *)*it;
-                currentRecipient->send(packet, reliable);
+                Kiaro::Network::IncomingClientBase *currentRecipient = mClients.getClient(iteration);
+
+                if (!filter || filter->invoke(currentRecipient))
+                    currentRecipient->send(mBroadcastStream.raw(), mBroadcastStream.length(), packetType, packMicroseconds, trafficClass);
             }
         }
 
+        void ServerBase::multicastSend(Kiaro::Network::PacketBase *packet, const std::vector<Kiaro::Network::IncomingClientBase *> &recipients,
+        Kiaro::Network::TRAFFIC_CLASS trafficClass)
+        {
+            if (recipients.empty())
+                return;
+
+            const Kiaro::Common::U64 packStartTime = Kiaro::Support::Time::getCurrentTimeMicroseconds();
+
+            mBroadcastStream.clear();
+            packet->packData(mBroadcastStream);
+            mBroadcastStream.flushBits();
+
+            const Kiaro::Common::U64 packMicroseconds = Kiaro::Support::Time::getCurrentTimeMicroseconds() - packStartTime;
+            const Kiaro::Common::U32 packetType = packet->getType();
+
+            for (std::vector<Kiaro::Network::IncomingClientBase *>::const_iterator it = recipients.begin(); it != recipients.end(); it++)
+                (*it)->send(mBroadcastStream.raw(), mBroadcastStream.length(), packetType, packMicroseconds, trafficClass);
+        }
+
+        void ServerBase::dispatch(void)
+        {
+            if (!mIsRunning)
+                return;
+
+            for (size_t iteration = 0; iteration < mClients.getCount(); iteration++)
+                mClients.getClient(iteration)->flush();
+
+            getTransport()->flush();
+        }
+
+        void ServerBase::startNetworkThread(void)
+        {
+            if (mNetworkThread)
+                return;
+
+            // Anyone who connected before now will never have a connect event go through the thread
+            std::vector<ENetPeer *> connectedPeers;
+            for (size_t iteration = 0; iteration < mClients.getCount(); iteration++)
+                if (mClients.getClient(iteration)->getPeer())
+                    connectedPeers.push_back(mClients.getClient(iteration)->getPeer());
+
+            mNetworkThread = new Kiaro::Network::NetworkThread(mTransport, connectedPeers);
+        }
+
+        Kiaro::Network::Transport *ServerBase::getTransport(void)
+        {
+            if (mNetworkThread)
+                return mNetworkThread;
+
+            return mTransport;
+        }
+
         void ServerBase::update(void)
         {
             if (!mIsRunning)
                 return;
 
+            Kiaro::Network::Transport *transport = getTransport();
+
             ENetEvent event;
-            while (enet_host_service(mInternalHost, &event, 0) > 0)
+            while (transport->service(event, 0) > 0)
+                processEvent(event);
+        }
+
+        void ServerBase::processEvent(ENetEvent &event)
+        {
+            switch(event.type)
             {
-                switch(event.type)
+                case ENET_EVENT_TYPE_CONNECT:
                 {
-                    case ENET_EVENT_TYPE_CONNECT:
+                    if (mClients.getCount() == mClients.getCapacity())
                     {
-                        IncomingClientBase *client = new Kiaro::Network::IncomingClientBase(event.peer, this);
-                        event.peer->data = client;
+                        std::cerr << "ServerBase: Turned away x.x.x.x:" << event.peer->address.port << " because every client slot is taken" << std::endl;
 
-                        mConnectedClientSet.insert(mConnectedClientSet.end(), (size_t)client);
-                        onClientConnected(client);
+                        event.peer->data = NULL;
+                        getTransport()->disconnect(event.peer, true);
 
                         break;
                     }
 
-                    case ENET_EVENT_TYPE_DISCONNECT:
-                    {
-                        Kiaro::Network::IncomingClientBase *disconnected = (Kiaro::Network::IncomingClientBase*)event.peer->data;
-                        onClientDisconnected(disconnected);
+                    Kiaro::Network::IncomingClientBase *client = acquireClient(event.peer);
+                    event.peer->data = client;
+
+                    mClients.insert(client);
+                    onClientConnected(client);
 
-                        mConnectedClientSet.erase((size_t)disconnected);
-                        delete disconnected;
+                    break;
+                }
 
+                case ENET_EVENT_TYPE_DISCONNECT:
+                {
+                    // Peers that were turned away never had a client
+                    Kiaro::Network::IncomingClientBase *disconnected = (Kiaro::Network::IncomingClientBase*)event.peer->data;
+                    if (!disconnected)
                         break;
-                    }
 
-                    case ENET_EVENT_TYPE_RECEIVE:
+                    event.peer->data = NULL;
+                    removeClient(disconnected);
+
+                    break;
+                }
+
+                case ENET_EVENT_TYPE_RECEIVE:
+                {
+                    const Kiaro::Network::ScopedPacket packet(event.packet);
+
+                    // Whatever a turned away peer managed to send before it was dropped
+                    if (!event.peer->data)
+                        break;
+
+                    Kiaro::Network::IncomingClientBase *sender = (Kiaro::Network::IncomingClientBase*)event.peer->data;
+                    sender->getStatistics().recordPacketReceived(event.packet->dataLength);
+
+                    std::vector<std::pair<size_t, Kiaro::Common::U16> > messages;
+                    if (!Kiaro::Network::MessageBuffer::split(event.packet->data, event.packet->dataLength, messages))
+                        std::cerr << "ServerBase: Received a malformed packet from x.x.x.x:" << sender->getPort() << std::endl;
+
+                    for (std::vector<std::pair<size_t, Kiaro::Common::U16> >::iterator it = messages.begin(); it != messages.end(); it++)
                     {
-                        if (!event.peer->data)
+                        if (mDemoRecorder)
+                            mDemoRecorder->record(sender->getPort(), event.packet->data + it->first, it->second);
+
+                        Kiaro::Support::BitStream incomingStream(event.packet->data + it->first, it->second, it->second);
+
+                        try
                         {
-                            enet_packet_destroy(event.packet);
-                            throw std::runtime_error("ServerBase: Invalid ENet peer data on packet receive!");
+                            onReceivePacket(incomingStream, sender);
                         }
+                        catch (std::exception &e)
+                        {
+                            // Whatever follows can't be trusted either, and a client that sends garbage isn't worth keeping
+                            std::cerr << "ServerBase: Dropping x.x.x.x:" << sender->getPort() << " after a malformed message: " << e.what() << std::endl;
+                            dropClient(sender);
 
-                        Kiaro::Network::IncomingClientBase *sender = (Kiaro::Network::IncomingClientBase*)event.peer->data;
-                        Kiaro::Support::BitStream incomingStream(event.packet->data, event.packet->dataLength, event.packet->dataLength);
-
-                        onReceivePacket(incomingStream, sender);
-                        enet_packet_destroy(event.packet);
+                            break;
+                        }
 
-                        break;
+                        // The handler may have dropped the client itself
+                        if (event.peer->data != sender)
+                            break;
                     }
 
-                    case ENET_EVENT_TYPE_NONE:
-                        break;
+                    break;
+                }
+
+                case ENET_EVENT_TYPE_NONE:
+                    break;
+            }
+        }
+
+        void ServerBase::writeStatistics(std::ostream &out)
+        {
+            out << "ServerBase: Network statistics for " << mClients.getCount() << " clients" << std::endl;
+
+            for (size_t iteration = 0; iteration < mClients.getCount(); iteration++)
+            {
+                Kiaro::Network::IncomingClientBase *client = mClients.getClient(iteration);
+
+                std::ostringstream name;
+                name << "x.x.x.x:" << client->getPort();
+
+                client->sampleStatistics().write(out, name.str());
+            }
+        }
+
+        void ServerBase::startRecording(const std::string &fileName)
+        {
+            stopRecording();
+            mDemoRecorder = new Kiaro::Network::DemoRecorder(fileName, Kiaro::Network::DEMO_SOURCE_SERVER);
+        }
+
+        void ServerBase::stopRecording(void)
+        {
+            delete mDemoRecorder;
+            mDemoRecorder = NULL;
+        }
+
+        void ServerBase::replay(const Kiaro::Network::DemoRecord &record)
+        {
+            Kiaro::Network::IncomingClientBase *&sender = mReplayClients[record.mSender];
+
+            if (!sender)
+            {
+                if (mClients.getCount() == mClients.getCapacity())
+                {
+                    std::cerr << "ServerBase: Dropped a packet from replayed client " << record.mSender << " because every client slot is taken" << std::endl;
+
+                    mReplayClients.erase(record.mSender);
+                    return;
                 }
+
+                sender = acquireClient(NULL);
+
+                mClients.insert(sender);
+                onClientConnected(sender);
+            }
+
+            if (record.mData.empty())
+                return;
+
+            // The stream only reads, so it is fine for it to point at the record's own copy of the packet
+            Kiaro::Support::BitStream incomingStream((Kiaro::Common::U8 *)&record.mData[0], record.mData.size(), record.mData.size());
+            onReceivePacket(incomingStream, sender);
+        }
+
+        void ServerBase::stopReplay(void)
+        {
+            for (std::map<Kiaro::Common::U16, Kiaro::Network::IncomingClientBase *>::iterator it = mReplayClients.begin(); it != mReplayClients.end(); it++)
+                removeClient(it->second);
+
+            mReplayClients.clear();
+        }
+
+        void ServerBase::dropClient(Kiaro::Network::IncomingClientBase *client)
+        {
+            ENetPeer *peer = client->getPeer();
+
+            if (peer)
+            {
+                peer->data = NULL;
+                getTransport()->disconnect(peer, true);
             }
+
+            removeClient(client);
+        }
+
+        void ServerBase::removeClient(Kiaro::Network::IncomingClientBase *client)
+        {
+            onClientDisconnected(client);
+
+            mClients.remove(client->getHandle());
+            releaseClient(client);
+        }
+
+        Kiaro::Network::IncomingClientBase *ServerBase::acquireClient(ENetPeer *connecting)
+        {
+            if (mClientPool.empty())
+                return createIncomingClient(connecting);
+
+            Kiaro::Network::IncomingClientBase *client = mClientPool.back();
+            mClientPool.pop_back();
+
+            client->reset(connecting);
+            return client;
+        }
+
+        void ServerBase::releaseClient(Kiaro::Network::IncomingClientBase *client)
+        {
+            mClientPool.push_back(client);
         }
 
         Kiaro::Network::IncomingClientBase *ServerBase::getLastPacketSender(void)
@@ -0,0 +1,71 @@
+/**
+ *  @file SnapshotHistory.cpp
+ *  @brief Source code file defining logic for the Kiaro::Network::SnapshotHistory class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 12/23/2013
+ *  @copyright (c) 2013 Draconic Entertainment
+ */
+
+#include <network/SnapshotHistory.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        SnapshotHistory::SnapshotHistory(void)
+        {
+            clear();
+        }
+
+        void SnapshotHistory::clear(void)
+        {
+            mAcknowledgedSequence = 0;
+
+            for (Kiaro::Common::U32 iteration = 0; iteration < NETWORK_SNAPSHOT_HISTORY_LENGTH; iteration++)
+            {
+                mSnapshots[iteration].mSequence = 0;
+                mSnapshots[iteration].mTime = 0;
+                mSnapshots[iteration].mEntityStates.clear();
+            }
+        }
+
+        Kiaro::Network::Snapshot &SnapshotHistory::push(const Kiaro::Common::U32 &sequence)
+        {
+            Kiaro::Network::Snapshot &result = mSnapshots[sequence % NETWORK_SNAPSHOT_HISTORY_LENGTH];
+            result.mSequence = sequence;
+            result.mTime = 0;
+            result.mEntityStates.clear();
+
+            return result;
+        }
+
+        Kiaro::Network::Snapshot *SnapshotHistory::get(const Kiaro::Common::U32 &sequence)
+        {
+            Kiaro::Network::Snapshot &result = mSnapshots[sequence % NETWORK_SNAPSHOT_HISTORY_LENGTH];
+
+            if (sequence == 0 || result.mSequence != sequence)
+                return NULL;
+
+            return &result;
+        }
+
+        void SnapshotHistory::acknowledge(const Kiaro::Common::U32 &sequence)
+        {
+            if (sequence > mAcknowledgedSequence)
+                mAcknowledgedSequence = sequence;
+        }
+
+        Kiaro::Network::Snapshot *SnapshotHistory::getBaseline(const Kiaro::Common::U32 &currentSequence)
+        {
+            if (mAcknowledgedSequence == 0 || currentSequence - mAcknowledgedSequence > NETWORK_SNAPSHOT_MAXIMUM_BASELINE_AGE)
+                return NULL;
+
+            return get(mAcknowledgedSequence);
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
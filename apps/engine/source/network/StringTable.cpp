@@ -0,0 +1,102 @@
+/**
+ *  @file StringTable.cpp
+ *  @brief Source file implementing the Kiaro::Network::StringTable class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <stdexcept>
+#include <sstream>
+
+#include <physfs.h>
+
+#include <network/StringTable.hpp>
+#include <support/BitStream.hpp>
+
+namespace Kiaro
+{
+    namespace Network
+    {
+        const Kiaro::Common::U16 StringTable::sInvalidID;
+
+        Kiaro::Common::U16 StringTable::insert(const std::string &string)
+        {
+            std::map<std::string, Kiaro::Common::U16>::const_iterator it = mIDs.find(string);
+
+            if (it != mIDs.end())
+                return it->second;
+
+            if (mStrings.size() >= sInvalidID)
+                throw std::overflow_error("StringTable: The string table is full!");
+
+            if (string.size() > 0xFFFF)
+                throw std::length_error("StringTable: String is too long to be sent!");
+
+            const Kiaro::Common::U16 id = mStrings.size();
+            mStrings.push_back(string);
+            mIDs[string] = id;
+
+            return id;
+        }
+
+        Kiaro::Common::U16 StringTable::getID(const std::string &string) const
+        {
+            std::map<std::string, Kiaro::Common::U16>::const_iterator it = mIDs.find(string);
+
+            return it == mIDs.end() ? sInvalidID : it->second;
+        }
+
+        void StringTable::clear(void)
+        {
+            mStrings.clear();
+            mIDs.clear();
+        }
+
+        bool StringTable::loadManifest(const std::string &fileName)
+        {
+            PHYSFS_File *file = PHYSFS_openRead(fileName.c_str());
+
+            if (!file)
+                return false;
+
+            const PHYSFS_sint64 fileLength = PHYSFS_fileLength(file);
+            std::string contents(fileLength > 0 ? fileLength : 0, '\0');
+
+            const bool readContents = contents.empty() || PHYSFS_read(file, &contents[0], contents.size(), 1) == 1;
+            PHYSFS_close(file);
+
+            if (!readContents)
+                return false;
+
+            std::istringstream lines(contents);
+            std::string line;
+            while (std::getline(lines, line))
+            {
+                // Manifests written on Windows still have their carriage returns
+                if (!line.empty() && line[line.size() - 1] == '\r')
+                    line.erase(line.size() - 1);
+
+                if (!line.empty() && line[0] != '#')
+                    insert(line);
+            }
+
+            return true;
+        }
+
+        void StringTable::writeReference(Kiaro::Support::BitStream &out, const std::string &string)
+        {
+            out.writeU16(string.empty() ? sInvalidID : insert(string));
+        }
+
+        const std::string *StringTable::readReference(Kiaro::Support::BitStream &in) const
+        {
+            return getString(in.readU16());
+        }
+    } // End Namespace Network
+} // End Namespace Kiaro
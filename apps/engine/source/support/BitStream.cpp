@@ -11,22 +11,84 @@
  *  @copyright (c) 2014 Draconic Entertainment
  */
 
+#include <algorithm>
+
 #include <support/BitStream.hpp>
+#include <support/EndianUtilities.hpp>
 
 namespace Kiaro
 {
     namespace Support
     {
+        //! The smallest allocation a BitStream will make when it needs to grow.
+        static const size_t sMinimumGrowthSize = 32;
+
+        //! The most bytes writeVarU32 ever uses.
+        static const Kiaro::Common::U8 sMaximumVarU32Size = 5;
+
+        //! The most bits writeQuaternion may quantize a component to, which keeps the whole quaternion in a single writeBits.
+        static const Kiaro::Common::U8 sMaximumQuaternionComponentBits = 10;
+        //! The magnitude no component but the largest of a unit quaternion can exceed, which is one over the square root of two.
+        static const Kiaro::Common::F32 sQuaternionComponentLimit = 0.70710678f;
+
+        //! Maps signed values to unsigned ones so that small magnitudes stay small: 0, -1, 1, -2 become 0, 1, 2, 3.
+        static inline Kiaro::Common::U32 zigZagEncode(const Kiaro::Common::S32 &value)
+        {
+            return ((Kiaro::Common::U32)value << 1) ^ (Kiaro::Common::U32)(value >> 31);
+        }
+
+        static inline Kiaro::Common::S32 zigZagDecode(const Kiaro::Common::U32 &value)
+        {
+            return (Kiaro::Common::S32)((value >> 1) ^ (0U - (value & 1)));
+        }
+
+        //! Returns the size a BitStream of the given capacity should grow to in order to hold requiredSize bytes.
+        static inline size_t getGrowthSize(const size_t &currentSize, const size_t &requiredSize)
+        {
+            return std::max(requiredSize, std::max(currentSize * 2, sMinimumGrowthSize));
+        }
+
+        //! The most values an array write converts at once on hosts that have to swap them.
+        static const size_t sArrayConversionBlockSize = 64;
+
+        /**
+         *  @brief Writes an array to a BitStream in little endian order. Nothing needs converting on little endian hosts,
+         *  so the array is written as is; elsewhere it is converted in blocks on the stack, since the stream's own copy
+         *  isn't aligned.
+         */
+        template <typename valueType, void (*convertArray)(valueType *, const size_t &)>
+        static inline void writeConvertedArray(BitStream &stream, const valueType *inData, const size_t &count)
+        {
+            #if ENGINE_BIG_ENDIAN
+            valueType block[sArrayConversionBlockSize];
+
+            for (size_t iteration = 0; iteration < count; iteration += sArrayConversionBlockSize)
+            {
+                const size_t blockCount = std::min(count - iteration, sArrayConversionBlockSize);
+
+                memcpy(block, &inData[iteration], blockCount * sizeof(valueType));
+                convertArray(block, blockCount);
+                stream.write(block, blockCount * sizeof(valueType));
+            }
+            #else
+            stream.write(inData, count * sizeof(valueType));
+            #endif
+        }
+
         BitStream::BitStream(Kiaro::Common::U8 *initialData, size_t initialDataLength, size_t initialDataIndex) :
-                             mIsManagingMemory(true), mDataPointer(initialDataIndex)
+                             mIsManagingMemory(false), mData(initialData), mDataPointer(initialDataIndex), mBitIndex(0),
+                             mBitRunStart(0), mIsWritingBits(false), mIsForward(false), mReadPointer(0), mReadBitIndex(0)
         {
             if (initialData == NULL)
+            {
                 mDataLength = 0;
+                mTotalSize = 0;
+            }
             else
-                mDataLength = initialDataLength;
-
-            mIsManagingMemory = false;
-            mData = initialData;
+            {
+                mDataLength = initialDataIndex;
+                mTotalSize = initialDataLength;
+            }
         }
 
        // BitStream::BitStream(const Kiaro::Common::U8 *initialData, size_t initialDataLength, size_t initialDataIndex)
@@ -36,7 +98,8 @@ namespace Kiaro
        // }
 
         BitStream::BitStream(size_t initialDataLength) : mIsManagingMemory(true), mData(new Kiaro::Common::U8[initialDataLength]),
-        mDataPointer(0), mDataLength(initialDataLength)
+        mDataPointer(0), mDataLength(0), mTotalSize(initialDataLength), mBitIndex(0), mBitRunStart(0), mIsWritingBits(false),
+        mIsForward(false), mReadPointer(0), mReadBitIndex(0)
         {
 
         }
@@ -44,39 +107,37 @@ namespace Kiaro
         BitStream::~BitStream(void)
         {
             if (mIsManagingMemory)
-                delete mData;
+                delete[] mData;
         }
 
         void BitStream::write(const void *inData, const size_t &inDataLength)
         {
-            // Check to see if we have enough room to write this data
-            if (mDataLength < mDataPointer + inDataLength)
-            {
-                Kiaro::Common::U32 newDataLength = mDataLength + inDataLength;
-                Kiaro::Common::U8 *newMemory = new Kiaro::Common::U8[newDataLength];
-
-                memcpy(newMemory, mData, mDataLength);
-                mDataLength = newDataLength;
+            // Whole bytes always start on a byte boundary
+            flushBits();
 
-                if (mData && mIsManagingMemory)
-                    delete mData;
+            // Check to see if we have enough room to write this data; grow geometrically so that packing N fields
+            // only costs O(log N) reallocations
+            const size_t requiredSize = mDataPointer + inDataLength;
 
-                mData = newMemory;
-                mIsManagingMemory = true;
-            }
+            if (mTotalSize < requiredSize)
+                reserve(getGrowthSize(mTotalSize, requiredSize));
 
             memcpy(&mData[mDataPointer], inData, inDataLength);
             mDataPointer += inDataLength; // NOTE (Robert MacGregor#9): Preserves the offset
+
+            if (mDataPointer > mDataLength)
+                mDataLength = mDataPointer;
         }
 
         void BitStream::writeF32(const Kiaro::Common::F32 &inData)
         {
-            write(&inData, sizeof(Kiaro::Common::F32));
+            const Kiaro::Common::F32 wireData = Kiaro::Support::ConvertLittleEndianF32(inData);
+            write(&wireData, sizeof(Kiaro::Common::F32));
         }
 
         void BitStream::writeBool(const bool &inData)
         {
-            write(&inData, sizeof(bool));
+            writeBits(inData ? 1 : 0, 1);
         }
 
         void BitStream::writeU8(const Kiaro::Common::U8 &inData)
@@ -84,9 +145,31 @@ namespace Kiaro
             write(&inData, sizeof(Kiaro::Common::U8));
         }
 
+        void BitStream::writeU16(const Kiaro::Common::U16 &inData)
+        {
+            const Kiaro::Common::U16 wireData = Kiaro::Support::ConvertLittleEndianU16(inData);
+            write(&wireData, sizeof(Kiaro::Common::U16));
+        }
+
         void BitStream::writeU32(const Kiaro::Common::U32 &inData)
         {
-            write(&inData, sizeof(Kiaro::Common::U32));
+            const Kiaro::Common::U32 wireData = Kiaro::Support::ConvertLittleEndianU32(inData);
+            write(&wireData, sizeof(Kiaro::Common::U32));
+        }
+
+        void BitStream::writeU16Array(const Kiaro::Common::U16 *inData, const size_t &count)
+        {
+            writeConvertedArray<Kiaro::Common::U16, Kiaro::Support::ConvertLittleEndianU16Array>(*this, inData, count);
+        }
+
+        void BitStream::writeU32Array(const Kiaro::Common::U32 *inData, const size_t &count)
+        {
+            writeConvertedArray<Kiaro::Common::U32, Kiaro::Support::ConvertLittleEndianU32Array>(*this, inData, count);
+        }
+
+        void BitStream::writeF32Array(const Kiaro::Common::F32 *inData, const size_t &count)
+        {
+            writeConvertedArray<Kiaro::Common::F32, Kiaro::Support::ConvertLittleEndianF32Array>(*this, inData, count);
         }
 
         void BitStream::writeString(const std::string &inString)
@@ -94,31 +177,231 @@ namespace Kiaro
             write(inString.c_str(), inString.length() + 1);
         }
 
+        void BitStream::writeBits(const Kiaro::Common::U32 &inData, const Kiaro::Common::U8 &bitCount)
+        {
+            if (bitCount > 32)
+                throw std::out_of_range("BitStream attempted to write more than 32 bits at once!");
+
+            if (!mIsWritingBits)
+            {
+                flushBits();
+
+                mIsWritingBits = true;
+                mBitRunStart = mDataPointer;
+            }
+
+            Kiaro::Common::U32 value = bitCount == 32 ? inData : inData & ((1U << bitCount) - 1);
+            Kiaro::Common::U8 remainingBits = bitCount;
+
+            while (remainingBits > 0)
+            {
+                // Start a new byte if the last one is full. The length is kept up to date byte by byte, since growing
+                // only carries over that much and a single call may grow more than once
+                if (mBitIndex == 0)
+                {
+                    if (mTotalSize < mDataPointer + 1)
+                        reserve(getGrowthSize(mTotalSize, mDataPointer + 1));
+
+                    mData[mDataPointer] = 0;
+                    mDataPointer++;
+
+                    if (mDataPointer > mDataLength)
+                        mDataLength = mDataPointer;
+                }
+
+                const Kiaro::Common::U8 writtenBits = std::min<Kiaro::Common::U8>(remainingBits, 8 - mBitIndex);
+
+                mData[mDataPointer - 1] |= (value & ((1U << writtenBits) - 1)) << mBitIndex;
+                value >>= writtenBits;
+
+                remainingBits -= writtenBits;
+                mBitIndex = (mBitIndex + writtenBits) & 7;
+            }
+        }
+
+        void BitStream::writeRangedU32(const Kiaro::Common::U32 &inData, const Kiaro::Common::U32 &minimum, const Kiaro::Common::U32 &maximum)
+        {
+            const Kiaro::Common::U32 value = std::min(std::max(inData, minimum), maximum);
+            writeBits(value - minimum, getRequiredBits(maximum - minimum));
+        }
+
+        void BitStream::writeQuantizedF32(const Kiaro::Common::F32 &inData, const Kiaro::Common::F32 &minimum, const Kiaro::Common::F32 &maximum,
+                                          const Kiaro::Common::F32 &precision)
+        {
+            if (maximum <= minimum)
+                return;
+
+            const Kiaro::Common::U32 stepCount = ceil((maximum - minimum) / precision);
+            const Kiaro::Common::F64 value = std::min(std::max(inData, minimum), maximum);
+
+            const Kiaro::Common::U32 quantizedValue = ((value - minimum) / (maximum - minimum)) * stepCount + 0.5;
+            writeBits(quantizedValue, getRequiredBits(stepCount));
+        }
+
+        void BitStream::writeVarU32(const Kiaro::Common::U32 &inData)
+        {
+            Kiaro::Common::U8 bytes[sMaximumVarU32Size];
+            Kiaro::Common::U8 byteCount = 0;
+
+            Kiaro::Common::U32 remaining = inData;
+            do
+            {
+                bytes[byteCount] = remaining & 0x7F;
+                remaining >>= 7;
+
+                if (remaining != 0)
+                    bytes[byteCount] |= 0x80;
+
+                byteCount++;
+            }
+            while (remaining != 0);
+
+            // Reading in reverse pops the last byte written first, so the bytes go in back to front for the reader to
+            // come across them in the usual order
+            if (!mIsForward)
+                std::reverse(bytes, bytes + byteCount);
+
+            write(bytes, byteCount);
+        }
+
+        void BitStream::writeVarS32(const Kiaro::Common::S32 &inData)
+        {
+            writeVarU32(zigZagEncode(inData));
+        }
+
+        void BitStream::writeQuaternion(const Kiaro::Common::Quaternion &inData, const Kiaro::Common::U8 &componentBits)
+        {
+            if (componentBits == 0 || componentBits > sMaximumQuaternionComponentBits)
+                throw std::out_of_range("BitStream attempted to write a quaternion with an unsupported number of bits!");
+
+            const Kiaro::Common::F32 components[4] = { inData.X, inData.Y, inData.Z, inData.W };
+
+            Kiaro::Common::U8 largestIndex = 0;
+            for (Kiaro::Common::U8 iteration = 1; iteration < 4; iteration++)
+                if (fabs(components[iteration]) > fabs(components[largestIndex]))
+                    largestIndex = iteration;
+
+            // A quaternion and its negation are the same rotation, so the largest component can always be made positive,
+            // which is what allows it to be left out
+            const Kiaro::Common::F32 sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+            const Kiaro::Common::U32 maximumValue = (1U << componentBits) - 1;
+
+            Kiaro::Common::U32 packedValue = largestIndex;
+            for (Kiaro::Common::U8 iteration = 0; iteration < 4; iteration++)
+            {
+                if (iteration == largestIndex)
+                    continue;
+
+                const Kiaro::Common::F32 value = std::min(std::max(components[iteration] * sign, -sQuaternionComponentLimit), sQuaternionComponentLimit);
+                const Kiaro::Common::U32 quantizedValue = ((value + sQuaternionComponentLimit) / (sQuaternionComponentLimit * 2.0f)) * maximumValue + 0.5f;
+
+                packedValue = (packedValue << componentBits) | quantizedValue;
+            }
+
+            writeBits(packedValue, getQuaternionBits(componentBits));
+        }
+
+        void BitStream::flushBits(void)
+        {
+            // Shift a partially filled run of bits up so that its last bit sits just below the byte boundary. Since
+            // reading happens in reverse, this leaves the padding at the bottom of the run where the reader can skip it.
+            // Reading forward finds the padding at the top of the run, where it already is.
+            if (mIsWritingBits && mBitIndex != 0 && !mIsForward)
+            {
+                const Kiaro::Common::U8 paddingBits = 8 - mBitIndex;
+
+                for (size_t iteration = mDataPointer - 1; iteration > mBitRunStart; iteration--)
+                    mData[iteration] = (mData[iteration] << paddingBits) | (mData[iteration - 1] >> (8 - paddingBits));
+
+                mData[mBitRunStart] <<= paddingBits;
+            }
+
+            // When reading, whatever remains of a partially read byte is padding
+            mIsWritingBits = false;
+            mBitIndex = 0;
+        }
+
+        Kiaro::Common::U8 BitStream::getRequiredBits(const Kiaro::Common::U32 &range)
+        {
+            Kiaro::Common::U8 result = 0;
+
+            for (Kiaro::Common::U32 remaining = range; remaining != 0; remaining >>= 1)
+                result++;
+
+            return result;
+        }
+
+        Kiaro::Common::U8 BitStream::getQuantizedBits(const Kiaro::Common::F32 &minimum, const Kiaro::Common::F32 &maximum,
+                                                      const Kiaro::Common::F32 &precision)
+        {
+            if (maximum <= minimum)
+                return 0;
+
+            return getRequiredBits(ceil((maximum - minimum) / precision));
+        }
+
+        Kiaro::Common::U8 BitStream::getVarU32Size(const Kiaro::Common::U32 &value)
+        {
+            Kiaro::Common::U8 result = 1;
+
+            for (Kiaro::Common::U32 remaining = value >> 7; remaining != 0; remaining >>= 7)
+                result++;
+
+            return result;
+        }
+
+        Kiaro::Common::U8 BitStream::getVarS32Size(const Kiaro::Common::S32 &value)
+        {
+            return getVarU32Size(zigZagEncode(value));
+        }
+
         void *BitStream::read(const size_t &outDataLength, const bool &shouldMemcpy)
         {
-            if (outDataLength > mDataPointer)
+            flushBits();
+
+            size_t readIndex;
+
+            if (mIsForward)
+            {
+                // Whatever is left of a partially read byte is padding
+                mReadBitIndex = 0;
+
+                if (outDataLength > mDataLength - mReadPointer)
+                    throw std::out_of_range("BitStream attempted to read out of range!");
+
+                readIndex = mReadPointer;
+                mReadPointer += outDataLength;
+            }
+            else if (outDataLength > mDataPointer)
                 throw std::out_of_range("BitStream attempted to read out of range!");
             else
+            {
                 mDataPointer -= outDataLength;
+                readIndex = mDataPointer;
+            }
 
             if (shouldMemcpy)
             {
                 void *memory = (void*)new Kiaro::Common::U8[outDataLength];
-                memcpy(memory, &mData[mDataPointer], outDataLength);
+                memcpy(memory, &mData[readIndex], outDataLength);
                 return memory;
             }
 
-            return (void*)&mData[mDataPointer];
+            return (void*)&mData[readIndex];
         }
 
         Kiaro::Common::F32 BitStream::readF32(const bool &should_memcpy)
         {
-            return *(Kiaro::Common::F32*)read(sizeof(Kiaro::Common::F32), should_memcpy);
+            // Copied out rather than dereferenced in place, since nothing in the stream is aligned
+            Kiaro::Common::F32 result;
+            memcpy(&result, read(sizeof(Kiaro::Common::F32)), sizeof(Kiaro::Common::F32));
+
+            return Kiaro::Support::ConvertLittleEndianF32(result);
         }
 
         bool BitStream::readBool(const bool &shouldMemcpy)
         {
-            return *(bool*)read(sizeof(bool), shouldMemcpy);
+            return readBits(1) != 0;
         }
 
         Kiaro::Common::U8 BitStream::readU8(const bool &shouldMemcpy)
@@ -126,9 +409,39 @@ namespace Kiaro
             return *(Kiaro::Common::U8*)read(sizeof(Kiaro::Common::U8), shouldMemcpy);
         }
 
+        Kiaro::Common::U16 BitStream::readU16(const bool &shouldMemcpy)
+        {
+            Kiaro::Common::U16 result;
+            memcpy(&result, read(sizeof(Kiaro::Common::U16)), sizeof(Kiaro::Common::U16));
+
+            return Kiaro::Support::ConvertLittleEndianU16(result);
+        }
+
         Kiaro::Common::U32 BitStream::readU32(const bool &shouldMemcpy)
         {
-            return *(Kiaro::Common::U32*)read(sizeof(Kiaro::Common::U32), shouldMemcpy);
+            Kiaro::Common::U32 result;
+            memcpy(&result, read(sizeof(Kiaro::Common::U32)), sizeof(Kiaro::Common::U32));
+
+            return Kiaro::Support::ConvertLittleEndianU32(result);
+        }
+
+        void BitStream::readU16Array(Kiaro::Common::U16 *outData, const size_t &count)
+        {
+            // The whole block is popped at once, so the values come out in the order they went in
+            memcpy(outData, read(count * sizeof(Kiaro::Common::U16)), count * sizeof(Kiaro::Common::U16));
+            Kiaro::Support::ConvertLittleEndianU16Array(outData, count);
+        }
+
+        void BitStream::readU32Array(Kiaro::Common::U32 *outData, const size_t &count)
+        {
+            memcpy(outData, read(count * sizeof(Kiaro::Common::U32)), count * sizeof(Kiaro::Common::U32));
+            Kiaro::Support::ConvertLittleEndianU32Array(outData, count);
+        }
+
+        void BitStream::readF32Array(Kiaro::Common::F32 *outData, const size_t &count)
+        {
+            memcpy(outData, read(count * sizeof(Kiaro::Common::F32)), count * sizeof(Kiaro::Common::F32));
+            Kiaro::Support::ConvertLittleEndianF32Array(outData, count);
         }
 
         Kiaro::Common::C8 *BitStream::readString(const size_t &outStringLength, const bool &shouldMemcpy)
@@ -142,14 +455,212 @@ namespace Kiaro
             return (Kiaro::Common::C8*)read(outStringLength, shouldMemcpy);
         }
 
+        Kiaro::Common::U32 BitStream::readBits(const Kiaro::Common::U8 &bitCount)
+        {
+            if (bitCount > 32)
+                throw std::out_of_range("BitStream attempted to read more than 32 bits at once!");
+
+            if (mIsWritingBits)
+                flushBits();
+
+            if (mIsForward)
+                return readBitsForward(bitCount);
+
+            Kiaro::Common::U32 result = 0;
+            Kiaro::Common::U8 remainingBits = bitCount;
+
+            // Bits come off the top of the stream, so the highest bits of the value are read first
+            while (remainingBits > 0)
+            {
+                if (mBitIndex == 0)
+                {
+                    if (mDataPointer == 0)
+                        throw std::out_of_range("BitStream attempted to read out of range!");
+
+                    mDataPointer--;
+                    mBitIndex = 8;
+                }
+
+                const Kiaro::Common::U8 chunkBits = std::min(remainingBits, mBitIndex);
+                const Kiaro::Common::U32 chunk = (mData[mDataPointer] >> (mBitIndex - chunkBits)) & ((1U << chunkBits) - 1);
+
+                result = (result << chunkBits) | chunk;
+
+                remainingBits -= chunkBits;
+                mBitIndex -= chunkBits;
+            }
+
+            return result;
+        }
+
+        Kiaro::Common::U32 BitStream::readBitsForward(const Kiaro::Common::U8 &bitCount)
+        {
+            Kiaro::Common::U32 result = 0;
+            Kiaro::Common::U8 readBits = 0;
+
+            // Bits come off the front of the stream in the order writeBits put them down, lowest first
+            while (readBits < bitCount)
+            {
+                if (mReadBitIndex == 0)
+                {
+                    if (mReadPointer >= mDataLength)
+                        throw std::out_of_range("BitStream attempted to read out of range!");
+
+                    mReadPointer++;
+                }
+
+                const Kiaro::Common::U8 chunkBits = std::min<Kiaro::Common::U8>(bitCount - readBits, 8 - mReadBitIndex);
+                const Kiaro::Common::U32 chunk = (mData[mReadPointer - 1] >> mReadBitIndex) & ((1U << chunkBits) - 1);
+
+                result |= chunk << readBits;
+
+                readBits += chunkBits;
+                mReadBitIndex = (mReadBitIndex + chunkBits) & 7;
+            }
+
+            return result;
+        }
+
+        Kiaro::Common::U32 BitStream::readRangedU32(const Kiaro::Common::U32 &minimum, const Kiaro::Common::U32 &maximum)
+        {
+            return minimum + readBits(getRequiredBits(maximum - minimum));
+        }
+
+        Kiaro::Common::F32 BitStream::readQuantizedF32(const Kiaro::Common::F32 &minimum, const Kiaro::Common::F32 &maximum,
+                                                       const Kiaro::Common::F32 &precision)
+        {
+            if (maximum <= minimum)
+                return minimum;
+
+            const Kiaro::Common::U32 stepCount = ceil((maximum - minimum) / precision);
+            const Kiaro::Common::U32 quantizedValue = readBits(getRequiredBits(stepCount));
+
+            return minimum + (maximum - minimum) * ((Kiaro::Common::F64)quantizedValue / stepCount);
+        }
+
+        Kiaro::Common::U32 BitStream::readVarU32(void)
+        {
+            Kiaro::Common::U32 result = 0;
+
+            for (Kiaro::Common::U8 iteration = 0; iteration < sMaximumVarU32Size; iteration++)
+            {
+                const Kiaro::Common::U8 byte = readU8();
+                result |= (Kiaro::Common::U32)(byte & 0x7F) << (iteration * 7);
+
+                if (!(byte & 0x80))
+                    return result;
+            }
+
+            throw std::out_of_range("BitStream attempted to read a variable length integer that is too long!");
+        }
+
+        Kiaro::Common::S32 BitStream::readVarS32(void)
+        {
+            return zigZagDecode(readVarU32());
+        }
+
+        Kiaro::Common::Quaternion BitStream::readQuaternion(const Kiaro::Common::U8 &componentBits)
+        {
+            if (componentBits == 0 || componentBits > sMaximumQuaternionComponentBits)
+                throw std::out_of_range("BitStream attempted to read a quaternion with an unsupported number of bits!");
+
+            Kiaro::Common::U32 packedValue = readBits(getQuaternionBits(componentBits));
+            const Kiaro::Common::U32 maximumValue = (1U << componentBits) - 1;
+            const Kiaro::Common::U8 largestIndex = packedValue >> (componentBits * 3);
+
+            // The components were shifted in first to last, so they come off the bottom last to first
+            Kiaro::Common::F32 components[4];
+            Kiaro::Common::F32 sumOfSquares = 0.0f;
+
+            for (Kiaro::Common::S32 iteration = 3; iteration > -1; iteration--)
+            {
+                if (iteration == largestIndex)
+                    continue;
+
+                const Kiaro::Common::F32 value = ((Kiaro::Common::F32)(packedValue & maximumValue) / maximumValue) * sQuaternionComponentLimit * 2.0f - sQuaternionComponentLimit;
+                packedValue >>= componentBits;
+
+                components[iteration] = value;
+                sumOfSquares += value * value;
+            }
+
+            components[largestIndex] = sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+            // Quantization can leave the three components a little too long to make up a unit quaternion on their own
+            const Kiaro::Common::F32 length = sqrt(sumOfSquares + components[largestIndex] * components[largestIndex]);
+            for (Kiaro::Common::U8 iteration = 0; iteration < 4; iteration++)
+                components[iteration] /= length;
+
+            return Kiaro::Common::Quaternion(components[0], components[1], components[2], components[3]);
+        }
+
         void *BitStream::raw(const bool &shouldMemcpy)
         {
-            return read(mDataPointer, shouldMemcpy);
+            if (!mIsForward)
+                return read(mDataPointer, shouldMemcpy);
+
+            // Reading forward, the contents are handed out without moving the read position
+            flushBits();
+
+            if (shouldMemcpy)
+            {
+                void *memory = (void*)new Kiaro::Common::U8[mDataLength];
+                memcpy(memory, mData, mDataLength);
+                return memory;
+            }
+
+            return (void*)mData;
+        }
+
+        void BitStream::setForward(const bool &forward)
+        {
+            flushBits();
+
+            mIsForward = forward;
+            mReadPointer = 0;
+            mReadBitIndex = 0;
         }
 
         size_t BitStream::length(void)
         {
             return mDataLength;
         }
+
+        size_t BitStream::capacity(void)
+        {
+            return mTotalSize;
+        }
+
+        void BitStream::reserve(const size_t &newCapacity)
+        {
+            if (newCapacity <= mTotalSize)
+                return;
+
+            Kiaro::Common::U8 *newMemory = new Kiaro::Common::U8[newCapacity];
+
+            if (mData)
+                memcpy(newMemory, mData, mDataLength);
+
+            if (mData && mIsManagingMemory)
+                delete[] mData;
+
+            mData = newMemory;
+            mTotalSize = newCapacity;
+            mIsManagingMemory = true;
+        }
+
+        void BitStream::clear(void)
+        {
+            mDataPointer = 0;
+            mDataLength = 0;
+
+            // A run of bits left open would otherwise be closed off against the old contents
+            mBitIndex = 0;
+            mBitRunStart = 0;
+            mIsWritingBits = false;
+
+            mReadPointer = 0;
+            mReadBitIndex = 0;
+        }
     } // End Namespace Support
 } // End namespace Kiaro
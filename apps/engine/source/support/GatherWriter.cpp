@@ -0,0 +1,88 @@
+/**
+ *  @file GatherWriter.cpp
+ *  @brief Source file implementing the Kiaro::Support::GatherWriter class.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.0.0.19
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <string.h>
+
+#include <support/GatherWriter.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        GatherWriter::GatherWriter(const size_t &initialCapacity) : mStream(initialCapacity), mOwnedStart(0), mReferencedLength(0)
+        {
+
+        }
+
+        void GatherWriter::closeOwnedSegment(void)
+        {
+            mStream.flushBits();
+
+            const size_t ownedLength = mStream.length();
+            if (ownedLength == mOwnedStart)
+                return;
+
+            Segment segment;
+            segment.mData = NULL;
+            segment.mOffset = mOwnedStart;
+            segment.mLength = ownedLength - mOwnedStart;
+            mSegments.push_back(segment);
+
+            mOwnedStart = ownedLength;
+        }
+
+        void GatherWriter::reference(const void *data, const size_t &length)
+        {
+            if (length == 0)
+                return;
+
+            closeOwnedSegment();
+
+            Segment segment;
+            segment.mData = (const Kiaro::Common::U8 *)data;
+            segment.mOffset = 0;
+            segment.mLength = length;
+            mSegments.push_back(segment);
+
+            mReferencedLength += length;
+        }
+
+        size_t GatherWriter::length(void)
+        {
+            mStream.flushBits();
+            return mStream.length() + mReferencedLength;
+        }
+
+        void GatherWriter::gather(Kiaro::Common::U8 *destination)
+        {
+            closeOwnedSegment();
+
+            const Kiaro::Common::U8 *ownedData = (const Kiaro::Common::U8 *)mStream.raw();
+
+            for (std::vector<Segment>::const_iterator it = mSegments.begin(); it != mSegments.end(); it++)
+            {
+                memcpy(destination, it->mData ? it->mData : ownedData + it->mOffset, it->mLength);
+                destination += it->mLength;
+            }
+        }
+
+        void GatherWriter::clear(void)
+        {
+            mStream.clear();
+            mSegments.clear();
+
+            mOwnedStart = 0;
+            mReferencedLength = 0;
+        }
+    } // End Namespace Support
+} // End Namespace Kiaro
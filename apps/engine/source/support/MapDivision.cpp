@@ -14,6 +14,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <iostream>
+#include <algorithm>
 
 #include <support/Time.hpp>
 #include <support/MapDivision.hpp>
@@ -22,6 +23,12 @@ namespace Kiaro
 {
     namespace Support
     {
+        /**
+         *  @brief How many squares across a query's radius may be. Finer squares fit the circle more closely, so fewer
+         *  entities outside of it are returned, at the cost of visiting more squares.
+         */
+        static const Kiaro::Common::U32 sQuerySquaresPerRadius = 4;
+
         // MapDivisionSquare Code Begin
         MapDivisionSquare::MapDivisionSquare(void)
         {
@@ -48,34 +55,107 @@ namespace Kiaro
             }
         }
 
-        MapDivision::MapDivision(Kiaro::Common::U32 power, Kiaro::Common::U32 divisions) : mDivisions(divisions), mResolution(pow(2, power))
+        MapDivision::MapDivision(Kiaro::Common::U32 power, Kiaro::Common::U32 divisions) : mDivisions(std::max<Kiaro::Common::U32>(1, std::min(divisions, power))),
+        mResolution(pow(2, power))
         {
             Kiaro::Support::Time::timer timerHandle = Kiaro::Support::Time::startTimer();
-            std::cout << "MapDivision: Initializing with a " << mResolution << "x" << mResolution << " map size ..." << std::endl;
+            std::cout << "MapDivision: Initializing with a " << mResolution << "x" << mResolution << " map size and " << mDivisions << " LODs ..." << std::endl;
 
-            Kiaro::Common::U32 currentResolution = mResolution;
-            while (currentResolution > 1)
+            mLODs.resize(mDivisions);
+            for (Kiaro::Common::U32 lod = 0; lod < mDivisions; lod++)
             {
-                Kiaro::Common::U32 currentLODDivision = mResolution / currentResolution;
+                const Kiaro::Common::U32 currentLODDivision = 1 << lod;
+                mLODs[lod].assign(currentLODDivision, std::vector<MapDivisionSquare>(currentLODDivision));
+            }
 
-                std::vector<std::vector<MapDivisionSquare>> currentLOD;
-                for (Kiaro::Common::U32 iterationX = 0; iterationX < currentLODDivision; iterationX++)
-                {
-                    std::vector<MapDivisionSquare> currentYAxis;
-                    currentLOD.push_back(currentYAxis);
+            std::cout << "MapDivision: Built grid in " << Kiaro::Support::Time::stopTimer(timerHandle) << " seconds " << std::endl;
+        }
+
+        Kiaro::Common::U32 MapDivision::getSquareIndex(const Kiaro::Common::F32 &coordinate, const Kiaro::Common::U32 &lod)
+        {
+            const Kiaro::Common::U32 squareCount = 1 << lod;
+            const Kiaro::Common::F32 squareSize = (Kiaro::Common::F32)mResolution / squareCount;
+            const Kiaro::Common::F32 index = floor((coordinate + (mResolution / 2.0f)) / squareSize);
+
+            if (index < 0.0f)
+                return 0;
+            if (index >= squareCount)
+                return squareCount - 1;
+
+            return index;
+        }
 
-                    for (Kiaro::Common::U32 iterationY = 0; iterationY < currentLODDivision; iterationY++)
-                        currentYAxis.push_back(MapDivisionSquare());
+        void MapDivision::removeFromSquares(Kiaro::Game::Entities::EntityBase *entity, const Kiaro::Common::U32 &finestX, const Kiaro::Common::U32 &finestY)
+        {
+            for (Kiaro::Common::U32 lod = 0; lod < mDivisions; lod++)
+            {
+                const Kiaro::Common::U32 shift = mDivisions - 1 - lod;
+                std::vector<Kiaro::Game::Entities::EntityBase*> &contents = mLODs[lod][finestX >> shift][finestY >> shift].mContents;
+
+                std::vector<Kiaro::Game::Entities::EntityBase*>::iterator it = std::find(contents.begin(), contents.end(), entity);
+                if (it != contents.end())
+                {
+                    *it = contents.back();
+                    contents.pop_back();
                 }
+            }
+        }
 
-                // Push the last element to the vector again to prevent out of bounds access under certain improbable circumstances
-                currentLOD.push_back(currentLOD[currentLOD.size() - 1]);
-                mLODs.push_back(currentLOD);
+        void MapDivision::insert(Kiaro::Game::Entities::EntityBase *entity, const Kiaro::Common::Vector3DF &position)
+        {
+            const Kiaro::Common::U32 finestX = getSquareIndex(position.X, mDivisions - 1);
+            const Kiaro::Common::U32 finestY = getSquareIndex(position.Z, mDivisions - 1);
 
-                currentResolution >>= 1;
+            std::map<Kiaro::Game::Entities::EntityBase*, std::pair<Kiaro::Common::U32, Kiaro::Common::U32> >::iterator it = mEntitySquares.find(entity);
+            if (it != mEntitySquares.end())
+            {
+                // Most entities don't leave their square between updates
+                if (it->second.first == finestX && it->second.second == finestY)
+                    return;
+
+                removeFromSquares(entity, it->second.first, it->second.second);
             }
 
-            std::cout << "MapDivision: Built grid in " << Kiaro::Support::Time::stopTimer(timerHandle) << " seconds " << std::endl;
+            mEntitySquares[entity] = std::make_pair(finestX, finestY);
+
+            for (Kiaro::Common::U32 lod = 0; lod < mDivisions; lod++)
+            {
+                const Kiaro::Common::U32 shift = mDivisions - 1 - lod;
+                mLODs[lod][finestX >> shift][finestY >> shift].mContents.push_back(entity);
+            }
+        }
+
+        void MapDivision::remove(Kiaro::Game::Entities::EntityBase *entity)
+        {
+            std::map<Kiaro::Game::Entities::EntityBase*, std::pair<Kiaro::Common::U32, Kiaro::Common::U32> >::iterator it = mEntitySquares.find(entity);
+            if (it == mEntitySquares.end())
+                return;
+
+            removeFromSquares(entity, it->second.first, it->second.second);
+            mEntitySquares.erase(it);
+        }
+
+        void MapDivision::query(const Kiaro::Common::Vector3DF &center, const Kiaro::Common::F32 &radius, std::vector<Kiaro::Game::Entities::EntityBase*> &out)
+        {
+            // Find the finest LOD whose squares are still no smaller than a fraction of the radius, which bounds the
+            // squares visited along each axis to ceil(2 * radius / size) + 1
+            const Kiaro::Common::F32 minimumSquareSize = radius / sQuerySquaresPerRadius;
+
+            Kiaro::Common::U32 lod = 0;
+            while (lod + 1 < mDivisions && (Kiaro::Common::F32)mResolution / (1 << (lod + 1)) >= minimumSquareSize)
+                lod++;
+
+            const Kiaro::Common::U32 minimumX = getSquareIndex(center.X - radius, lod);
+            const Kiaro::Common::U32 maximumX = getSquareIndex(center.X + radius, lod);
+            const Kiaro::Common::U32 minimumY = getSquareIndex(center.Z - radius, lod);
+            const Kiaro::Common::U32 maximumY = getSquareIndex(center.Z + radius, lod);
+
+            for (Kiaro::Common::U32 iterationX = minimumX; iterationX <= maximumX; iterationX++)
+                for (Kiaro::Common::U32 iterationY = minimumY; iterationY <= maximumY; iterationY++)
+                {
+                    const std::vector<Kiaro::Game::Entities::EntityBase*> &contents = mLODs[lod][iterationX][iterationY].mContents;
+                    out.insert(out.end(), contents.begin(), contents.end());
+                }
         }
     } // End NameSpace Support
 } // End NameSpace Kiaro
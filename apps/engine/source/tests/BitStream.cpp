@@ -20,6 +20,8 @@
     #include <gtest/gtest.h>
 
     #include <support/BitStream.hpp>
+    #include <support/EndianUtilities.hpp>
+    #include <support/GatherWriter.hpp>
 
     static Kiaro::Common::F32 float_list[] =
     {
@@ -64,5 +66,392 @@
         for (Kiaro::Common::S32 iteration = floatCount - 1; iteration > -1; iteration--)
             EXPECT_EQ(float_list[iteration], floatStream.readF32());
     }
+
+    TEST(BitStreamTest, ReserveAndClear)
+    {
+        Kiaro::Support::BitStream stream;
+        stream.reserve(64);
+
+        EXPECT_EQ(0, stream.length());
+        EXPECT_LE(64, stream.capacity());
+
+        // Growing past the capacity should at least double it rather than grow by the written size
+        for (Kiaro::Common::U32 iteration = 0; iteration < 17; iteration++)
+            stream.writeU32(iteration);
+
+        EXPECT_EQ(17 * sizeof(Kiaro::Common::U32), stream.length());
+        EXPECT_LE(128, stream.capacity());
+
+        // Clearing keeps the memory around for the next use
+        const size_t grownCapacity = stream.capacity();
+        stream.clear();
+
+        EXPECT_EQ(0, stream.length());
+        EXPECT_EQ(grownCapacity, stream.capacity());
+
+        PackFloats(stream);
+        EXPECT_EQ(grownCapacity, stream.capacity());
+
+        for (Kiaro::Common::S32 iteration = floatCount - 1; iteration > -1; iteration--)
+            EXPECT_EQ(float_list[iteration], stream.readF32());
+    }
+
+    TEST(BitStreamTest, ClearDuringBits)
+    {
+        Kiaro::Support::BitStream stream;
+        stream.reserve(64);
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < 8; iteration++)
+            stream.writeU32(iteration);
+
+        // Clear in the middle of a run of bits that started well past where the next one will
+        stream.writeBits(5, 3);
+        stream.clear();
+
+        stream.writeBits(3, 2);
+        stream.writeU8(0xAB);
+
+        EXPECT_EQ(2, stream.length());
+        EXPECT_EQ(0xAB, stream.readU8());
+        EXPECT_EQ(3, stream.readBits(2));
+        EXPECT_THROW(stream.readU8(), std::out_of_range);
+    }
+
+    TEST(BitStreamTest, GrowDuringBits)
+    {
+        // Whatever the starting capacity, each write may have to grow the stream partway through its bits
+        for (Kiaro::Common::U32 capacity = 1; capacity < 12; capacity++)
+        {
+            Kiaro::Support::BitStream stream(capacity);
+            stream.writeU8(3);
+            stream.writeBits(0x12345, 19);
+            stream.writeBits(0x23456, 19);
+            stream.writeBits(0x7ABCD, 19);
+
+            EXPECT_EQ(0x7ABCD, stream.readBits(19));
+            EXPECT_EQ(0x23456, stream.readBits(19));
+            EXPECT_EQ(0x12345, stream.readBits(19));
+            EXPECT_EQ(3, stream.readU8());
+        }
+    }
+
+    TEST(BitStreamTest, ExternalBuffer)
+    {
+        Kiaro::Common::U8 buffer[sizeof(Kiaro::Common::U32) * 2];
+
+        // Writing into memory we don't own should stay there until it runs out of room
+        Kiaro::Support::BitStream bufferStream(buffer, sizeof(buffer), 0);
+        bufferStream.writeU32(1337);
+
+        EXPECT_EQ(sizeof(Kiaro::Common::U32), bufferStream.length());
+        EXPECT_EQ(sizeof(buffer), bufferStream.capacity());
+        EXPECT_EQ(1337, *(Kiaro::Common::U32*)buffer);
+
+        bufferStream.writeU32(1338);
+        bufferStream.writeU32(1339);
+
+        EXPECT_LT(sizeof(buffer), bufferStream.capacity());
+        EXPECT_EQ(1339, bufferStream.readU32());
+        EXPECT_EQ(1338, bufferStream.readU32());
+        EXPECT_EQ(1337, bufferStream.readU32());
+
+        // Incoming data is read from its end
+        Kiaro::Support::BitStream incomingStream(buffer, sizeof(buffer), sizeof(buffer));
+
+        EXPECT_EQ(sizeof(buffer), incomingStream.length());
+        EXPECT_EQ(1338, incomingStream.readU32());
+        EXPECT_EQ(1337, incomingStream.readU32());
+    }
+
+    TEST(BitStreamTest, Bits)
+    {
+        Kiaro::Support::BitStream bitStream;
+
+        bitStream.writeBool(true);
+        bitStream.writeBits(5, 3);
+        bitStream.writeU8(0xAB);
+        bitStream.writeBits(0x1FFFF, 17);
+        bitStream.writeBool(false);
+        bitStream.writeBits(0xDEADBEEF, 32);
+
+        // 4 bits padded to a byte, one byte, then 50 bits padded to 7 bytes
+        EXPECT_EQ(9, bitStream.length());
+
+        EXPECT_EQ(0xDEADBEEF, bitStream.readBits(32));
+        EXPECT_FALSE(bitStream.readBool());
+        EXPECT_EQ(0x1FFFF, bitStream.readBits(17));
+        EXPECT_EQ(0xAB, bitStream.readU8());
+        EXPECT_EQ(5, bitStream.readBits(3));
+        EXPECT_TRUE(bitStream.readBool());
+
+        EXPECT_THROW(bitStream.readU8(), std::out_of_range);
+    }
+
+    TEST(BitStreamTest, RangedAndQuantized)
+    {
+        const Kiaro::Common::F32 minimum = -4096.0f;
+        const Kiaro::Common::F32 maximum = 4096.0f;
+        const Kiaro::Common::F32 precision = 0.03125f;
+
+        Kiaro::Support::BitStream bitStream;
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < floatCount; iteration++)
+            bitStream.writeQuantizedF32(float_list[iteration], minimum, maximum, precision);
+
+        bitStream.writeRangedU32(1000, 900, 1100);
+        bitStream.writeRangedU32(5000, 900, 1100);
+
+        EXPECT_EQ(8, Kiaro::Support::BitStream::getRequiredBits(200));
+        EXPECT_EQ(19, Kiaro::Support::BitStream::getQuantizedBits(minimum, maximum, precision));
+
+        EXPECT_EQ(1100, bitStream.readRangedU32(900, 1100));
+        EXPECT_EQ(1000, bitStream.readRangedU32(900, 1100));
+
+        for (Kiaro::Common::S32 iteration = floatCount - 1; iteration > -1; iteration--)
+            EXPECT_NEAR(float_list[iteration], bitStream.readQuantizedF32(minimum, maximum, precision), precision / 2);
+    }
+
+    TEST(BitStreamTest, LittleEndian)
+    {
+        Kiaro::Common::U8 buffer[sizeof(Kiaro::Common::U32) + sizeof(Kiaro::Common::U16)];
+
+        // Whatever the host, the least significant byte goes first
+        Kiaro::Support::BitStream bufferStream(buffer, sizeof(buffer), 0);
+        bufferStream.writeU32(0x01020304);
+        bufferStream.writeU16(0x0506);
+
+        EXPECT_EQ(0x04, buffer[0]);
+        EXPECT_EQ(0x01, buffer[3]);
+        EXPECT_EQ(0x06, buffer[4]);
+        EXPECT_EQ(0x05, buffer[5]);
+
+        EXPECT_EQ(0x0506, bufferStream.readU16());
+        EXPECT_EQ(0x01020304, bufferStream.readU32());
+    }
+
+    TEST(BitStreamTest, SwapArrays)
+    {
+        // Long enough to go through both the vectorized blocks and the values left over after them
+        Kiaro::Common::U16 shorts[19];
+        Kiaro::Common::U32 longs[19];
+        Kiaro::Common::F32 floats[19];
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < 19; iteration++)
+        {
+            shorts[iteration] = 0x0102 + iteration;
+            longs[iteration] = 0x01020304 + iteration;
+            floats[iteration] = 1.5f * iteration;
+        }
+
+        Kiaro::Support::SwapEndianU16Array(shorts, 19);
+        Kiaro::Support::SwapEndianU32Array(longs, 19);
+        Kiaro::Support::SwapEndianF32Array(floats, 19);
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < 19; iteration++)
+        {
+            EXPECT_EQ(Kiaro::Support::SwapEndianU16(0x0102 + iteration), shorts[iteration]);
+            EXPECT_EQ(Kiaro::Support::SwapEndianU32(0x01020304 + iteration), longs[iteration]);
+            EXPECT_EQ(1.5f * iteration, Kiaro::Support::SwapEndianF32(floats[iteration]));
+        }
+
+        Kiaro::Common::U8 bytes[] = { 1, 2, 3, 4, 5 };
+        Kiaro::Support::SwapEndianArbitrary(bytes, sizeof(bytes));
+
+        EXPECT_EQ(5, bytes[0]);
+        EXPECT_EQ(3, bytes[2]);
+        EXPECT_EQ(1, bytes[4]);
+    }
+
+    TEST(BitStreamTest, Arrays)
+    {
+        // More values than are converted at once, starting off a byte so that none of them are aligned
+        const Kiaro::Common::U32 valueCount = 100;
+
+        Kiaro::Common::U16 shorts[valueCount];
+        Kiaro::Common::U32 longs[valueCount];
+        Kiaro::Common::F32 floats[valueCount];
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < valueCount; iteration++)
+        {
+            shorts[iteration] = 0x0102 + iteration;
+            longs[iteration] = 0x01020304 + iteration;
+            floats[iteration] = 1.5f * iteration;
+        }
+
+        Kiaro::Common::U8 buffer[1 + sizeof(shorts) + sizeof(longs) + sizeof(floats)];
+
+        Kiaro::Support::BitStream stream(buffer, sizeof(buffer), 0);
+        stream.writeU8(7);
+        stream.writeU16Array(shorts, valueCount);
+        stream.writeU32Array(longs, valueCount);
+        stream.writeF32Array(floats, valueCount);
+
+        // Each value goes out least significant byte first, just as it would on its own
+        EXPECT_EQ(0x02, buffer[1]);
+        EXPECT_EQ(0x01, buffer[2]);
+        EXPECT_EQ(0x04, buffer[1 + sizeof(shorts)]);
+        EXPECT_EQ(0x01, buffer[1 + sizeof(shorts) + 3]);
+
+        Kiaro::Common::U16 readShorts[valueCount];
+        Kiaro::Common::U32 readLongs[valueCount];
+        Kiaro::Common::F32 readFloats[valueCount];
+
+        stream.readF32Array(readFloats, valueCount);
+        stream.readU32Array(readLongs, valueCount);
+        stream.readU16Array(readShorts, valueCount);
+        EXPECT_EQ(7, stream.readU8());
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < valueCount; iteration++)
+        {
+            EXPECT_EQ(shorts[iteration], readShorts[iteration]);
+            EXPECT_EQ(longs[iteration], readLongs[iteration]);
+            EXPECT_EQ(floats[iteration], readFloats[iteration]);
+        }
+
+        EXPECT_THROW(stream.readU32Array(readLongs, 1), std::out_of_range);
+    }
+
+    TEST(BitStreamTest, Forward)
+    {
+        Kiaro::Support::BitStream bitStream;
+        bitStream.setForward(true);
+
+        bitStream.writeBool(true);
+        bitStream.writeBits(5, 3);
+        bitStream.writeU16(0xABCD);
+        bitStream.writeBits(0x1FFFF, 17);
+
+        // Read in the order written, while more is still being written on to the end
+        EXPECT_TRUE(bitStream.readBool());
+        EXPECT_EQ(5, bitStream.readBits(3));
+        EXPECT_EQ(0xABCD, bitStream.readU16());
+        EXPECT_EQ(0x1FFFF, bitStream.readBits(17));
+        EXPECT_EQ(0, bitStream.getRemaining());
+
+        bitStream.writeU32(1337);
+        EXPECT_EQ(sizeof(Kiaro::Common::U32), bitStream.getRemaining());
+        EXPECT_EQ(1337, bitStream.readU32());
+
+        EXPECT_THROW(bitStream.readU8(), std::out_of_range);
+        EXPECT_THROW(bitStream.readBits(1), std::out_of_range);
+    }
+
+    TEST(BitStreamTest, Gather)
+    {
+        const Kiaro::Common::U8 shared[] = { 1, 2, 3 };
+
+        Kiaro::Support::GatherWriter writer;
+        writer.getStream().writeU8(0xAA);
+        writer.reference(shared, sizeof(shared));
+        writer.getStream().writeU16(0xBBCC);
+        writer.reference(shared, sizeof(shared));
+
+        ASSERT_EQ(9, writer.length());
+
+        Kiaro::Common::U8 buffer[9];
+        writer.gather(buffer);
+
+        const Kiaro::Common::U8 expected[] = { 0xAA, 1, 2, 3, 0xCC, 0xBB, 1, 2, 3 };
+        for (Kiaro::Common::U32 iteration = 0; iteration < sizeof(expected); iteration++)
+            EXPECT_EQ(expected[iteration], buffer[iteration]);
+
+        writer.clear();
+        EXPECT_EQ(0, writer.length());
+    }
+
+    TEST(BitStreamTest, VarInts)
+    {
+        const Kiaro::Common::U32 unsignedValues[] = { 0, 1, 127, 128, 16383, 16384, 0x7FFFFFFF, 0xFFFFFFFF };
+        const Kiaro::Common::S32 signedValues[] = { 0, -1, 1, -64, 64, -2147483647 - 1, 2147483647 };
+        const Kiaro::Common::U32 unsignedCount = sizeof(unsignedValues) / sizeof(Kiaro::Common::U32);
+        const Kiaro::Common::U32 signedCount = sizeof(signedValues) / sizeof(Kiaro::Common::S32);
+
+        EXPECT_EQ(1, Kiaro::Support::BitStream::getVarU32Size(127));
+        EXPECT_EQ(2, Kiaro::Support::BitStream::getVarU32Size(128));
+        EXPECT_EQ(5, Kiaro::Support::BitStream::getVarU32Size(0xFFFFFFFF));
+        EXPECT_EQ(1, Kiaro::Support::BitStream::getVarS32Size(-64));
+        EXPECT_EQ(2, Kiaro::Support::BitStream::getVarS32Size(64));
+
+        // Round trip in both directions, checking that each value takes exactly the bytes it says it does
+        for (Kiaro::Common::U32 direction = 0; direction < 2; direction++)
+        {
+            Kiaro::Support::BitStream bitStream;
+            bitStream.setForward(direction != 0);
+
+            size_t expectedLength = 0;
+            for (Kiaro::Common::U32 iteration = 0; iteration < unsignedCount; iteration++)
+            {
+                bitStream.writeVarU32(unsignedValues[iteration]);
+                expectedLength += Kiaro::Support::BitStream::getVarU32Size(unsignedValues[iteration]);
+            }
+
+            for (Kiaro::Common::U32 iteration = 0; iteration < signedCount; iteration++)
+            {
+                bitStream.writeVarS32(signedValues[iteration]);
+                expectedLength += Kiaro::Support::BitStream::getVarS32Size(signedValues[iteration]);
+            }
+
+            EXPECT_EQ(expectedLength, bitStream.length());
+
+            if (bitStream.isForward())
+            {
+                for (Kiaro::Common::U32 iteration = 0; iteration < unsignedCount; iteration++)
+                    EXPECT_EQ(unsignedValues[iteration], bitStream.readVarU32());
+
+                for (Kiaro::Common::U32 iteration = 0; iteration < signedCount; iteration++)
+                    EXPECT_EQ(signedValues[iteration], bitStream.readVarS32());
+            }
+            else
+            {
+                for (Kiaro::Common::S32 iteration = signedCount - 1; iteration > -1; iteration--)
+                    EXPECT_EQ(signedValues[iteration], bitStream.readVarS32());
+
+                for (Kiaro::Common::S32 iteration = unsignedCount - 1; iteration > -1; iteration--)
+                    EXPECT_EQ(unsignedValues[iteration], bitStream.readVarU32());
+            }
+
+            EXPECT_EQ(0, bitStream.getRemaining());
+        }
+
+        // Six bytes that all claim more follow
+        Kiaro::Common::U8 malformed[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 };
+        Kiaro::Support::BitStream malformedStream(malformed, sizeof(malformed), sizeof(malformed));
+        EXPECT_THROW(malformedStream.readVarU32(), std::out_of_range);
+    }
+
+    TEST(BitStreamTest, Quaternions)
+    {
+        const Kiaro::Common::F32 halfRoot = 0.70710678f;
+        const Kiaro::Common::Quaternion rotations[] =
+        {
+            Kiaro::Common::Quaternion(0.0f, 0.0f, 0.0f, 1.0f),
+            Kiaro::Common::Quaternion(0.0f, 0.0f, 0.0f, -1.0f),
+            Kiaro::Common::Quaternion(halfRoot, 0.0f, 0.0f, halfRoot),
+            Kiaro::Common::Quaternion(0.5f, -0.5f, 0.5f, -0.5f),
+            Kiaro::Common::Quaternion(0.1825742f, 0.3651484f, -0.5477226f, 0.7302967f),
+        };
+        const Kiaro::Common::U32 rotationCount = sizeof(rotations) / sizeof(Kiaro::Common::Quaternion);
+
+        Kiaro::Support::BitStream bitStream;
+
+        for (Kiaro::Common::U32 iteration = 0; iteration < rotationCount; iteration++)
+            bitStream.writeQuaternion(rotations[iteration]);
+
+        // 32 bits apiece rather than 128
+        EXPECT_EQ(rotationCount * 4, bitStream.length());
+        EXPECT_EQ(32, Kiaro::Support::BitStream::getQuaternionBits(10));
+
+        for (Kiaro::Common::S32 iteration = rotationCount - 1; iteration > -1; iteration--)
+        {
+            const Kiaro::Common::Quaternion &expected = rotations[iteration];
+            const Kiaro::Common::Quaternion result = bitStream.readQuaternion();
+
+            // The quaternion may come back negated, which is the same rotation
+            const Kiaro::Common::F32 dot = expected.X * result.X + expected.Y * result.Y + expected.Z * result.Z + expected.W * result.W;
+            EXPECT_NEAR(1.0f, fabs(dot), 0.00001f);
+        }
+
+        EXPECT_THROW(bitStream.writeQuaternion(rotations[0], 11), std::out_of_range);
+    }
     #endif // _INCLUDE_KIARO_TESTS_H_
 #endif // ENGINE_TESTS
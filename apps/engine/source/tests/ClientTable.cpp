@@ -0,0 +1,144 @@
+/**
+ *  @file ClientTable.cpp
+ *  @brief ClientTable testing implementation.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <engine/Config.hpp>
+
+#if ENGINE_TESTS>0
+    #ifndef _INCLUDE_KIARO_TESTS_CLIENTTABLE_H_
+    #define _INCLUDE_KIARO_TESTS_CLIENTTABLE_H_
+
+    #include <stdexcept>
+
+    #include <gtest/gtest.h>
+
+    #include <network/ClientTable.hpp>
+    #include <network/IncomingClientBase.hpp>
+
+    TEST(ClientTableTest, InsertRemove)
+    {
+        Kiaro::Network::IncomingClientBase first(NULL, NULL);
+        Kiaro::Network::IncomingClientBase second(NULL, NULL);
+        Kiaro::Network::IncomingClientBase third(NULL, NULL);
+
+        Kiaro::Network::ClientTable table(2);
+
+        const Kiaro::Network::ClientHandle firstHandle = table.insert(&first);
+        const Kiaro::Network::ClientHandle secondHandle = table.insert(&second);
+
+        EXPECT_TRUE(firstHandle.isValid());
+        EXPECT_TRUE(secondHandle.isValid());
+        EXPECT_NE(firstHandle, secondHandle);
+        EXPECT_EQ(firstHandle, first.getHandle());
+        EXPECT_EQ(2, table.getCount());
+
+        EXPECT_EQ(&first, table.get(firstHandle));
+        EXPECT_EQ(&second, table.get(secondHandle));
+
+        // Every slot is taken
+        EXPECT_FALSE(table.insert(&third).isValid());
+
+        EXPECT_EQ(&first, table.remove(firstHandle));
+        EXPECT_FALSE(first.getHandle().isValid());
+        EXPECT_EQ(1, table.getCount());
+
+        // The handle is stale now, even once its slot is taken again
+        EXPECT_EQ(NULL, table.get(firstHandle));
+        EXPECT_EQ(NULL, table.remove(firstHandle));
+
+        const Kiaro::Network::ClientHandle thirdHandle = table.insert(&third);
+        EXPECT_EQ(firstHandle.mIndex, thirdHandle.mIndex);
+        EXPECT_NE(firstHandle.mGeneration, thirdHandle.mGeneration);
+
+        EXPECT_EQ(NULL, table.get(firstHandle));
+        EXPECT_EQ(NULL, table.remove(firstHandle));
+        EXPECT_EQ(&third, table.get(thirdHandle));
+        EXPECT_EQ(&second, table.get(secondHandle));
+
+        // Invalid handles and slots past the end never find anything
+        EXPECT_EQ(NULL, table.get(Kiaro::Network::ClientHandle()));
+        EXPECT_EQ(NULL, table.get(Kiaro::Network::ClientHandle(2, 1)));
+        EXPECT_EQ(NULL, table.remove(Kiaro::Network::ClientHandle(2, 1)));
+
+        EXPECT_THROW(Kiaro::Network::ClientTable(0x10001), std::out_of_range);
+    }
+
+    TEST(ClientTableTest, SwapRemove)
+    {
+        Kiaro::Network::IncomingClientBase first(NULL, NULL);
+        Kiaro::Network::IncomingClientBase second(NULL, NULL);
+        Kiaro::Network::IncomingClientBase third(NULL, NULL);
+
+        Kiaro::Network::ClientTable table(3);
+
+        const Kiaro::Network::ClientHandle firstHandle = table.insert(&first);
+        const Kiaro::Network::ClientHandle secondHandle = table.insert(&second);
+        const Kiaro::Network::ClientHandle thirdHandle = table.insert(&third);
+
+        EXPECT_EQ(&first, table.getClient(0));
+        EXPECT_EQ(&second, table.getClient(1));
+        EXPECT_EQ(&third, table.getClient(2));
+
+        // The last client moves into the hole
+        table.remove(firstHandle);
+        ASSERT_EQ(2, table.getCount());
+        EXPECT_EQ(&third, table.getClient(0));
+        EXPECT_EQ(&second, table.getClient(1));
+
+        // The moved client can still be found and removed through its handle
+        EXPECT_EQ(&third, table.get(thirdHandle));
+        EXPECT_EQ(&third, table.remove(thirdHandle));
+        ASSERT_EQ(1, table.getCount());
+        EXPECT_EQ(&second, table.getClient(0));
+
+        EXPECT_EQ(&second, table.remove(secondHandle));
+        EXPECT_EQ(0, table.getCount());
+    }
+
+    TEST(ClientTableTest, GenerationWrap)
+    {
+        Kiaro::Network::IncomingClientBase client(NULL, NULL);
+        Kiaro::Network::ClientTable table(1);
+
+        Kiaro::Network::ClientHandle firstHandle = table.insert(&client);
+        Kiaro::Network::ClientHandle handle = firstHandle;
+        EXPECT_EQ(1, handle.mGeneration);
+
+        // Take the slot through every generation it has
+        for (Kiaro::Common::U32 iteration = 1; iteration < 0xFFFF; iteration++)
+        {
+            table.remove(handle);
+            handle = table.insert(&client);
+        }
+
+        EXPECT_EQ(0xFFFF, handle.mGeneration);
+        EXPECT_EQ(&client, table.get(handle));
+        EXPECT_EQ(NULL, table.get(firstHandle));
+
+        // Past 0xFFFF the generation skips 0, which would make for an invalid handle, and starts over at 1
+        const Kiaro::Network::ClientHandle lastHandle = handle;
+        table.remove(handle);
+        handle = table.insert(&client);
+
+        EXPECT_TRUE(handle.isValid());
+        EXPECT_EQ(1, handle.mGeneration);
+        EXPECT_EQ(&client, table.get(handle));
+        EXPECT_EQ(NULL, table.get(lastHandle));
+
+        // Which goes on to 2 rather than stopping there
+        table.remove(handle);
+        handle = table.insert(&client);
+        EXPECT_EQ(2, handle.mGeneration);
+        EXPECT_EQ(&client, table.get(handle));
+    }
+    #endif // _INCLUDE_KIARO_TESTS_CLIENTTABLE_H_
+#endif // ENGINE_TESTS
@@ -0,0 +1,281 @@
+/**
+ *  @file FieldList.cpp
+ *  @brief FieldList testing implementation.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <engine/Config.hpp>
+
+#if ENGINE_TESTS>0
+    #ifndef _INCLUDE_KIARO_TESTS_FIELDLIST_H_
+    #define _INCLUDE_KIARO_TESTS_FIELDLIST_H_
+
+    #include <gtest/gtest.h>
+
+    #include <support/BitStream.hpp>
+    #include <support/FieldList.hpp>
+
+    #include <game/packets/packets.hpp>
+
+    //! Sends a percentage quantized to whole percent, to check that lists with a bit packed codec of their own work.
+    struct PercentCodec
+    {
+        static void write(Kiaro::Support::BitStream &out, const Kiaro::Common::F32 &value) { out.writeQuantizedF32(value, 0, 100, 1); }
+
+        static Kiaro::Common::F32 read(Kiaro::Support::BitStream &in) { return in.readQuantizedF32(0, 100, 1); }
+
+        static bool isEqual(const Kiaro::Common::F32 &first, const Kiaro::Common::F32 &second) { return first == second; }
+
+        static constexpr bool isBitPacked(void) { return true; }
+
+        static Kiaro::Common::U32 getBits(void) { return Kiaro::Support::BitStream::getQuantizedBits(0, 100, 1); }
+
+        static constexpr Kiaro::Common::U32 getSchemaID(void) { return 0x02000064; }
+    };
+
+    //! A small class declaring its fields the way entities and packets do.
+    struct FieldListState
+    {
+        FieldListState(void) : mTeam(0), mAlive(false), mHealth(0), mCrouched(false), mScore(0), mOffset(0), mPosition(0, 0, 0) { }
+
+        Kiaro::Common::U8 mTeam;
+        bool mAlive;
+        Kiaro::Common::F32 mHealth;
+        bool mCrouched;
+        Kiaro::Common::U64 mScore;
+        Kiaro::Common::S16 mOffset;
+        Kiaro::Common::Vector3DF mPosition;
+
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mTeam), KIARO_NETWORKED_FIELD(FieldListState, mAlive),
+                                          KIARO_NETWORKED_FIELD_CODEC(FieldListState, mHealth, PercentCodec), KIARO_NETWORKED_FIELD(FieldListState, mCrouched),
+                                          KIARO_NETWORKED_FIELD(FieldListState, mScore), KIARO_NETWORKED_FIELD(FieldListState, mOffset),
+                                          KIARO_NETWORKED_FIELD_CODEC(FieldListState, mPosition, Kiaro::Support::QuantizedPositionCodec)> NetworkedFields;
+
+        //! The same fields, but with the health sent as a whole Kiaro::Common::F32.
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mTeam), KIARO_NETWORKED_FIELD(FieldListState, mAlive),
+                                          KIARO_NETWORKED_FIELD(FieldListState, mHealth), KIARO_NETWORKED_FIELD(FieldListState, mCrouched),
+                                          KIARO_NETWORKED_FIELD(FieldListState, mScore), KIARO_NETWORKED_FIELD(FieldListState, mOffset),
+                                          KIARO_NETWORKED_FIELD_CODEC(FieldListState, mPosition, Kiaro::Support::QuantizedPositionCodec)> WholeHealthFields;
+
+        //! The same fields as NetworkedFields, but with the first two the other way around.
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mAlive), KIARO_NETWORKED_FIELD(FieldListState, mTeam),
+                                          KIARO_NETWORKED_FIELD_CODEC(FieldListState, mHealth, PercentCodec), KIARO_NETWORKED_FIELD(FieldListState, mCrouched),
+                                          KIARO_NETWORKED_FIELD(FieldListState, mScore), KIARO_NETWORKED_FIELD(FieldListState, mOffset),
+                                          KIARO_NETWORKED_FIELD_CODEC(FieldListState, mPosition, Kiaro::Support::QuantizedPositionCodec)> ReorderedFields;
+    };
+
+    //! Keeps its state out of reach, with the position on a base class, the way entities keep theirs on a scene node.
+    class FieldListNodeBase
+    {
+        public:
+            FieldListNodeBase(void) : mPosition(0, 0, 0) { }
+
+            Kiaro::Common::Vector3DF getPosition(void) const { return mPosition; }
+
+        protected:
+            Kiaro::Common::Vector3DF mPosition;
+    };
+
+    class FieldListNode : public FieldListNodeBase
+    {
+        public:
+            FieldListNode(void) : mScale(1, 1, 1), mSetCount(0) { }
+
+            void setPosition(const Kiaro::Common::Vector3DF &position) { mPosition = position; mSetCount++; }
+
+            Kiaro::Common::Vector3DF getScale(void) const { return mScale; }
+            void setScale(const Kiaro::Common::Vector3DF &scale) { mScale = scale; mSetCount++; }
+
+            Kiaro::Common::U32 getSetCount(void) const { return mSetCount; }
+
+            typedef Kiaro::Support::FieldList<KIARO_NETWORKED_ACCESSOR_CODEC(FieldListNode, getPosition, setPosition, Kiaro::Support::QuantizedPositionCodec),
+                                              KIARO_NETWORKED_ACCESSOR(FieldListNode, getScale, setScale)> NetworkedFields;
+
+        private:
+            Kiaro::Common::Vector3DF mScale;
+            Kiaro::Common::U32 mSetCount;
+    };
+
+    static FieldListState MakeState(void)
+    {
+        FieldListState state;
+        state.mTeam = 3;
+        state.mAlive = true;
+        state.mHealth = 75;
+        state.mCrouched = true;
+        state.mScore = 0x0102030405060708ULL;
+        state.mOffset = -1234;
+        state.mPosition = Kiaro::Common::Vector3DF(12.5f, -300.25f, 4000);
+
+        return state;
+    }
+
+    //! Checks that the fields of the mask were read back and the rest were left as they were.
+    static void ExpectFields(const FieldListState &expected, const FieldListState &untouched, const Kiaro::Common::U32 &mask, const FieldListState &actual)
+    {
+        EXPECT_EQ((mask & 1) ? expected.mTeam : untouched.mTeam, actual.mTeam);
+        EXPECT_EQ((mask & 2) ? expected.mAlive : untouched.mAlive, actual.mAlive);
+        EXPECT_NEAR((mask & 4) ? expected.mHealth : untouched.mHealth, actual.mHealth, 0.5f);
+        EXPECT_EQ((mask & 8) ? expected.mCrouched : untouched.mCrouched, actual.mCrouched);
+        EXPECT_EQ((mask & 16) ? expected.mScore : untouched.mScore, actual.mScore);
+        EXPECT_EQ((mask & 32) ? expected.mOffset : untouched.mOffset, actual.mOffset);
+
+        const Kiaro::Common::Vector3DF &position = (mask & 64) ? expected.mPosition : untouched.mPosition;
+        EXPECT_NEAR(position.X, actual.mPosition.X, NETWORK_POSITION_PRECISION);
+        EXPECT_NEAR(position.Y, actual.mPosition.Y, NETWORK_POSITION_PRECISION);
+        EXPECT_NEAR(position.Z, actual.mPosition.Z, NETWORK_POSITION_PRECISION);
+    }
+
+    TEST(FieldListTest, RoundTrip)
+    {
+        const FieldListState state = MakeState();
+
+        Kiaro::Support::BitStream stream(8);
+        FieldListState::NetworkedFields::pack(state, stream);
+
+        // The size is exact, bit packed runs included
+        EXPECT_EQ(FieldListState::NetworkedFields::getSize(), stream.length());
+        EXPECT_EQ(7, FieldListState::NetworkedFields::getCount());
+
+        FieldListState result;
+        FieldListState::NetworkedFields::unpack(result, stream);
+        ExpectFields(state, FieldListState(), 0xFFFFFFFF, result);
+        EXPECT_EQ(0, stream.getRemaining());
+
+    }
+
+    TEST(FieldListTest, Commit)
+    {
+        FieldListState state;
+
+        // Committed values start out the same as a value initialized instance
+        FieldListState::NetworkedFields::Values committed;
+        EXPECT_EQ(0, FieldListState::NetworkedFields::getDirtyMask(state, committed));
+
+        state = MakeState();
+        EXPECT_EQ(0x7F, FieldListState::NetworkedFields::commit(state, committed));
+        EXPECT_EQ(0, FieldListState::NetworkedFields::commit(state, committed));
+
+        state.mAlive = false;
+        state.mPosition.Y += 1;
+        EXPECT_EQ(0x42, FieldListState::NetworkedFields::getDirtyMask(state, committed));
+        EXPECT_EQ(0x42, FieldListState::NetworkedFields::commit(state, committed));
+        EXPECT_EQ(0, FieldListState::NetworkedFields::getDirtyMask(state, committed));
+
+        // Accessor fields are committed through their getters
+        FieldListNode node;
+        FieldListNode::NetworkedFields::Values nodeCommitted;
+        EXPECT_EQ(2, FieldListNode::NetworkedFields::commit(node, nodeCommitted));
+
+        node.setPosition(Kiaro::Common::Vector3DF(5, 0, 0));
+        EXPECT_EQ(1, FieldListNode::NetworkedFields::commit(node, nodeCommitted));
+        EXPECT_EQ(0, FieldListNode::NetworkedFields::commit(node, nodeCommitted));
+    }
+
+    TEST(FieldListTest, PartialRoundTrip)
+    {
+        const FieldListState state = MakeState();
+
+        FieldListState previous;
+        previous.mTeam = 1;
+        previous.mScore = 99;
+        previous.mPosition = Kiaro::Common::Vector3DF(-1, -2, -3);
+
+        // Every combination of fields, so that each bit packed run is closed off by every kind of field
+        for (Kiaro::Common::U32 mask = 0; mask < 0x80; mask++)
+        {
+            SCOPED_TRACE(mask);
+
+            Kiaro::Support::BitStream stream(8);
+            FieldListState::NetworkedFields::packFields(state, mask, stream);
+
+            EXPECT_EQ(FieldListState::NetworkedFields::getSize(mask), stream.length());
+
+            FieldListState result = previous;
+            FieldListState::NetworkedFields::unpackFields(result, mask, stream);
+            ExpectFields(state, previous, mask, result);
+            EXPECT_EQ(0, stream.getRemaining());
+        }
+    }
+
+    TEST(FieldListTest, Accessors)
+    {
+        FieldListNode node;
+        node.setPosition(Kiaro::Common::Vector3DF(1.5f, -2.25f, 300));
+        node.setScale(Kiaro::Common::Vector3DF(0.5f, 2, 4));
+
+        Kiaro::Support::BitStream stream(8);
+        FieldListNode::NetworkedFields::pack(node, stream);
+        EXPECT_EQ(FieldListNode::NetworkedFields::getSize(), stream.length());
+
+        // Vectors go as they are, so the scale comes back exactly
+        FieldListNode result;
+        FieldListNode::NetworkedFields::unpack(result, stream);
+        EXPECT_EQ(0, stream.getRemaining());
+        EXPECT_EQ(2, result.getSetCount());
+
+        EXPECT_NEAR(1.5f, result.getPosition().X, NETWORK_POSITION_PRECISION);
+        EXPECT_NEAR(-2.25f, result.getPosition().Y, NETWORK_POSITION_PRECISION);
+        EXPECT_NEAR(300, result.getPosition().Z, NETWORK_POSITION_PRECISION);
+        EXPECT_EQ(Kiaro::Common::Vector3DF(0.5f, 2, 4), result.getScale());
+
+        // Only the setters of the fields in the mask are called
+        FieldListNode partial;
+        stream.clear();
+        FieldListNode::NetworkedFields::packFields(node, 2, stream);
+        FieldListNode::NetworkedFields::unpackFields(partial, 2, stream);
+
+        EXPECT_EQ(1, partial.getSetCount());
+        EXPECT_EQ(Kiaro::Common::Vector3DF(0, 0, 0), partial.getPosition());
+        EXPECT_EQ(Kiaro::Common::Vector3DF(0.5f, 2, 4), partial.getScale());
+    }
+
+    TEST(FieldListTest, SchemaHash)
+    {
+        const Kiaro::Common::U32 hash = FieldListState::NetworkedFields::getSchemaHash();
+
+        // Known at compile time
+        static_assert(FieldListState::NetworkedFields::getSchemaHash() != 0, "FieldListTest: The schema hash should be a constant expression!");
+
+        EXPECT_NE(hash, FieldListState::WholeHealthFields::getSchemaHash());
+        EXPECT_NE(hash, FieldListState::ReorderedFields::getSchemaHash());
+        EXPECT_NE(FieldListState::WholeHealthFields::getSchemaHash(), FieldListState::ReorderedFields::getSchemaHash());
+
+        // Only the codecs matter, not which members they're used on
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mAlive)> AliveFields;
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mCrouched)> CrouchedFields;
+        EXPECT_EQ(AliveFields::getSchemaHash(), CrouchedFields::getSchemaHash());
+
+        // Whole values differ in size, sign and kind
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mTeam)> TeamFields;
+        typedef Kiaro::Support::FieldList<KIARO_NETWORKED_FIELD(FieldListState, mOffset)> OffsetFields;
+        EXPECT_NE(TeamFields::getSchemaHash(), OffsetFields::getSchemaHash());
+    }
+
+    TEST(FieldListTest, PacketSize)
+    {
+        Kiaro::Game::Packets::Ping ping;
+        ping.mSequence = 5;
+        ping.mTimestamp = 0xFFFFFFFFFFULL;
+
+        Kiaro::Support::BitStream pingStream(8);
+        const Kiaro::Common::U32 pingSize = ping.getPacketSize();
+        ping.packData(pingStream);
+        EXPECT_EQ(pingSize, pingStream.length());
+
+        Kiaro::Game::Packets::HandShake handShake;
+
+        Kiaro::Support::BitStream handShakeStream(8);
+        const Kiaro::Common::U32 handShakeSize = handShake.getPacketSize();
+        handShake.packData(handShakeStream);
+        EXPECT_EQ(handShakeSize, handShakeStream.length());
+    }
+    #endif // _INCLUDE_KIARO_TESTS_FIELDLIST_H_
+#endif // ENGINE_TESTS
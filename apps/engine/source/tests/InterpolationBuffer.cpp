@@ -0,0 +1,107 @@
+/**
+ *  @file InterpolationBuffer.cpp
+ *  @brief InterpolationBuffer testing implementation.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <engine/Config.hpp>
+
+#if ENGINE_TESTS>0
+    #ifndef _INCLUDE_KIARO_TESTS_INTERPOLATIONBUFFER_H_
+    #define _INCLUDE_KIARO_TESTS_INTERPOLATIONBUFFER_H_
+
+    #include <gtest/gtest.h>
+
+    #include <engine/Common.hpp>
+    #include <support/InterpolationBuffer.hpp>
+
+    //! How far past the newest value the tests extrapolate, in milliseconds.
+    static const Kiaro::Common::U32 sMaximumExtrapolation = 100;
+
+    /**
+     *  @brief Fills a buffer with 0, 10 and 30 at 0, 200 and 400 milliseconds after the given time, then checks sampling
+     *  between, past and before them.
+     *  @param start The time of the first value.
+     */
+    static void CheckSampling(const Kiaro::Common::U32 &start)
+    {
+        Kiaro::Support::InterpolationBuffer<Kiaro::Common::F32, 4> buffer;
+        Kiaro::Common::F32 value = -1;
+
+        EXPECT_TRUE(buffer.empty());
+        EXPECT_FALSE(buffer.sample(start, sMaximumExtrapolation, value));
+
+        buffer.push(start, 0);
+
+        // A single value is all there is to go on, whenever it is sampled
+        EXPECT_TRUE(buffer.sample(start + 50, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(0, value);
+
+        buffer.push(start + 200, 10);
+        buffer.push(start + 400, 30);
+
+        // Between values
+        EXPECT_TRUE(buffer.sample(start + 100, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(5, value);
+        EXPECT_TRUE(buffer.sample(start + 200, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(10, value);
+        EXPECT_TRUE(buffer.sample(start + 300, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(20, value);
+        EXPECT_TRUE(buffer.sample(start + 400, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(30, value);
+
+        // Past the newest, extrapolated from the newest two and then held
+        EXPECT_TRUE(buffer.sample(start + 450, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(35, value);
+        EXPECT_TRUE(buffer.sample(start + 500, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(40, value);
+        EXPECT_TRUE(buffer.sample(start + 5000, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(40, value);
+
+        // Before the oldest
+        EXPECT_TRUE(buffer.sample(start - 50, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(0, value);
+
+        // Values out of order are ignored, and one at the same time as the newest replaces it
+        buffer.push(start + 300, 1000);
+        buffer.push(start + 400, 50);
+
+        EXPECT_TRUE(buffer.sample(start + 300, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(30, value);
+
+        // Once full, the oldest value is the first to go
+        buffer.push(start + 600, 50);
+        buffer.push(start + 800, 50);
+
+        EXPECT_TRUE(buffer.sample(start + 100, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(10, value);
+        EXPECT_TRUE(buffer.sample(start + 700, sMaximumExtrapolation, value));
+        EXPECT_FLOAT_EQ(50, value);
+
+        buffer.clear();
+        EXPECT_TRUE(buffer.empty());
+        EXPECT_FALSE(buffer.sample(start, sMaximumExtrapolation, value));
+    }
+
+    TEST(InterpolationBufferTest, Sample)
+    {
+        CheckSampling(1000);
+    }
+
+    TEST(InterpolationBufferTest, SampleAcrossWrap)
+    {
+        // The newest value's time wraps past zero while the older ones are near the top of the range
+        CheckSampling(0xFFFFFF00);
+
+        // So do the times sampled at and extrapolated to
+        CheckSampling(0xFFFFFE50);
+    }
+    #endif // _INCLUDE_KIARO_TESTS_INTERPOLATIONBUFFER_H_
+#endif // ENGINE_TESTS
@@ -0,0 +1,95 @@
+/**
+ *  @file MessageBuffer.cpp
+ *  @brief MessageBuffer testing implementation.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <engine/Config.hpp>
+
+#if ENGINE_TESTS>0
+    #ifndef _INCLUDE_KIARO_TESTS_MESSAGEBUFFER_H_
+    #define _INCLUDE_KIARO_TESTS_MESSAGEBUFFER_H_
+
+    #include <vector>
+
+    #include <gtest/gtest.h>
+
+    #include <network/MessageBuffer.hpp>
+
+    //! The offsets and lengths of the messages MessageBuffer::split finds.
+    typedef std::vector<std::pair<size_t, Kiaro::Common::U16> > MessageList;
+
+    TEST(MessageBufferTest, SplitMessages)
+    {
+        // Length prefixes are little endian
+        const Kiaro::Common::U8 data[] = { 3, 0, 'a', 'b', 'c', 0, 0, 1, 0, 'z' };
+
+        MessageList messages;
+        EXPECT_TRUE(Kiaro::Network::MessageBuffer::split(data, sizeof(data), messages));
+
+        ASSERT_EQ(3, messages.size());
+        EXPECT_EQ(2, messages[0].first);
+        EXPECT_EQ(3, messages[0].second);
+        EXPECT_EQ(7, messages[1].first);
+        EXPECT_EQ(0, messages[1].second);
+        EXPECT_EQ(9, messages[2].first);
+        EXPECT_EQ(1, messages[2].second);
+        EXPECT_EQ('z', data[messages[2].first]);
+
+        // Messages are appended to whatever is already there
+        EXPECT_TRUE(Kiaro::Network::MessageBuffer::split(data, 2 + 3, messages));
+        EXPECT_EQ(4, messages.size());
+    }
+
+    TEST(MessageBufferTest, SplitEmpty)
+    {
+        const Kiaro::Common::U8 data[] = { 0, 0 };
+
+        MessageList messages;
+        EXPECT_TRUE(Kiaro::Network::MessageBuffer::split(data, 0, messages));
+        EXPECT_TRUE(messages.empty());
+
+        // A zero length message is still a message
+        EXPECT_TRUE(Kiaro::Network::MessageBuffer::split(data, sizeof(data), messages));
+        ASSERT_EQ(1, messages.size());
+        EXPECT_EQ(2, messages[0].first);
+        EXPECT_EQ(0, messages[0].second);
+    }
+
+    TEST(MessageBufferTest, SplitTruncated)
+    {
+        // The last length prefix is missing its second byte
+        const Kiaro::Common::U8 truncatedPrefix[] = { 1, 0, 'a', 5 };
+
+        MessageList messages;
+        EXPECT_FALSE(Kiaro::Network::MessageBuffer::split(truncatedPrefix, sizeof(truncatedPrefix), messages));
+
+        // The message before it is still found
+        ASSERT_EQ(1, messages.size());
+        EXPECT_EQ(2, messages[0].first);
+        EXPECT_EQ(1, messages[0].second);
+
+        // The last message claims more bytes than are left
+        const Kiaro::Common::U8 overrun[] = { 2, 0, 'a', 'b', 4, 0, 'x' };
+
+        messages.clear();
+        EXPECT_FALSE(Kiaro::Network::MessageBuffer::split(overrun, sizeof(overrun), messages));
+
+        ASSERT_EQ(1, messages.size());
+        EXPECT_EQ(2, messages[0].first);
+        EXPECT_EQ(2, messages[0].second);
+
+        // As does a lone prefix with nothing after it
+        messages.clear();
+        EXPECT_FALSE(Kiaro::Network::MessageBuffer::split(overrun + 4, 2, messages));
+        EXPECT_TRUE(messages.empty());
+    }
+    #endif // _INCLUDE_KIARO_TESTS_MESSAGEBUFFER_H_
+#endif // ENGINE_TESTS
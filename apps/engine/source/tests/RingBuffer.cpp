@@ -0,0 +1,109 @@
+/**
+ *  @file RingBuffer.cpp
+ *  @brief RingBuffer testing implementation.
+ *
+ *  This software is licensed under the GNU Lesser General Public License version 3.
+ *  Please refer to gpl.txt and lgpl.txt for more information.
+ *
+ *  @author Draconic Entertainment
+ *  @version 0.1.0
+ *  @date 3/19/2014
+ *  @copyright (c) 2014 Draconic Entertainment
+ */
+
+#include <engine/Config.hpp>
+
+#if ENGINE_TESTS>0
+    #ifndef _INCLUDE_KIARO_TESTS_RINGBUFFER_H_
+    #define _INCLUDE_KIARO_TESTS_RINGBUFFER_H_
+
+    #include <gtest/gtest.h>
+
+    #include <boost/thread/thread.hpp>
+
+    #include <engine/Common.hpp>
+    #include <support/RingBuffer.hpp>
+
+    //! The number of elements pushed through the ring by RingBufferTest.Threaded.
+    static const Kiaro::Common::U32 sThreadedElementCount = 1000000;
+
+    //! Pushes 0 through sThreadedElementCount - 1 onto a ring, waiting whenever it is full.
+    static void ProduceElements(Kiaro::Support::RingBuffer<Kiaro::Common::U32, 64> *ring)
+    {
+        for (Kiaro::Common::U32 iteration = 0; iteration < sThreadedElementCount; iteration++)
+            while (!ring->push(iteration))
+                boost::this_thread::yield();
+    }
+
+    TEST(RingBufferTest, FullEmptyWrap)
+    {
+        Kiaro::Support::RingBuffer<Kiaro::Common::U32, 4> ring;
+        Kiaro::Common::U32 element = 0;
+
+        EXPECT_TRUE(ring.empty());
+        EXPECT_FALSE(ring.full());
+        EXPECT_FALSE(ring.pop(element));
+
+        Kiaro::Common::U32 pushed = 0;
+        Kiaro::Common::U32 popped = 0;
+
+        // Fill and drain it a few times over, a little out of step, so that the head and tail go all the way around
+        for (Kiaro::Common::U32 lap = 0; lap < 5; lap++)
+        {
+            while (ring.push(pushed))
+                pushed++;
+
+            EXPECT_TRUE(ring.full());
+            EXPECT_FALSE(ring.empty());
+
+            // Nothing was overwritten by the push that didn't fit
+            for (Kiaro::Common::U32 iteration = 0; iteration < 3; iteration++)
+            {
+                ASSERT_TRUE(ring.pop(element));
+                EXPECT_EQ(popped++, element);
+            }
+
+            EXPECT_FALSE(ring.full());
+        }
+
+        while (ring.pop(element))
+            EXPECT_EQ(popped++, element);
+
+        EXPECT_EQ(pushed, popped);
+        EXPECT_GT(pushed, 4);
+        EXPECT_TRUE(ring.empty());
+        EXPECT_FALSE(ring.full());
+    }
+
+    TEST(RingBufferTest, Threaded)
+    {
+        Kiaro::Support::RingBuffer<Kiaro::Common::U32, 64> ring;
+        boost::thread producer(ProduceElements, &ring);
+
+        // Everything arrives exactly once and in the order it was pushed. The ring is drained either way, since the
+        // producer would never finish otherwise
+        Kiaro::Common::U32 popped = 0;
+        Kiaro::Common::U32 outOfOrder = 0;
+        while (popped < sThreadedElementCount)
+        {
+            Kiaro::Common::U32 element;
+
+            if (!ring.pop(element))
+            {
+                boost::this_thread::yield();
+                continue;
+            }
+
+            if (element != popped)
+                outOfOrder++;
+
+            popped++;
+        }
+
+        producer.join();
+
+        EXPECT_EQ(0, outOfOrder);
+        EXPECT_TRUE(ring.empty());
+    }
+    #endif // _INCLUDE_KIARO_TESTS_RINGBUFFER_H_
+#endif // ENGINE_TESTS